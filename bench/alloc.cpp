@@ -0,0 +1,48 @@
+// counts allocations for bench.hpp, linked into every benchmark executable
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+std::atomic<size_t> allocations = 0;
+}
+
+static void *counted_alloc(size_t n) {
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+static void *counted_aligned_alloc(size_t n, std::align_val_t al) {
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto a = static_cast<size_t>(al);
+    if (void *p = std::aligned_alloc(a, ((n ? n : 1) + a - 1) / a * a)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t n) { return counted_alloc(n); }
+void *operator new[](size_t n) { return counted_alloc(n); }
+void *operator new(size_t n, std::align_val_t al) {
+    return counted_aligned_alloc(n, al);
+}
+void *operator new[](size_t n, std::align_val_t al) {
+    return counted_aligned_alloc(n, al);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void *p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
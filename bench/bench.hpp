@@ -0,0 +1,97 @@
+#pragma once
+
+// archimedes benchmark harness
+// each benchmark prints one JSON object per line:
+// {"name": ..., "iterations": ..., "ns_per_op": ..., "allocs_per_op": ...}
+// set ARCHIMEDES_BENCH_MS to change the minimum measured time per benchmark
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#define FMT_HEADER_ONLY
+#include <fmt/core.h>
+
+#include <archimedes.hpp>
+
+namespace bench {
+// number of calls to operator new, see alloc.cpp
+extern std::atomic<size_t> allocations;
+
+// prevent compiler from optimizing away t
+template <typename T>
+inline void do_not_optimize(const T &t) {
+    asm volatile("" : : "r,m"(t) : "memory");
+}
+
+// minimum measured time per benchmark
+inline std::chrono::nanoseconds min_time() {
+    const char *ms = std::getenv("ARCHIMEDES_BENCH_MS");
+    return std::chrono::milliseconds(ms ? std::atoll(ms) : 200);
+}
+
+inline void report(
+    std::string_view name,
+    size_t iterations,
+    double ns,
+    size_t allocs) {
+    fmt::print(
+        "{{\"name\": \"{}\", \"iterations\": {}, \"ns_per_op\": {:.2f}, "
+        "\"allocs_per_op\": {:.2f}}}\n",
+        name,
+        iterations,
+        ns / iterations,
+        static_cast<double>(allocs) / iterations);
+    std::fflush(stdout);
+}
+
+// run f once and report it, for operations which cannot be repeated
+template <typename F>
+void run_once(std::string_view name, F &&f) {
+    const auto allocs_start = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    report(
+        name,
+        1,
+        std::chrono::duration<double, std::nano>(end - start).count(),
+        allocations.load() - allocs_start);
+}
+
+// run f repeatedly, doubling iteration count until min_time() is reached
+template <typename F>
+void run(std::string_view name, F &&f) {
+    // warm up
+    for (size_t i = 0; i < 16; i++) {
+        f();
+    }
+
+    const auto target = min_time();
+    size_t n = 1;
+    while (true) {
+        const auto allocs_start = allocations.load();
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; i++) {
+            f();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const auto allocs = allocations.load() - allocs_start;
+
+        if (end - start >= target || n >= (size_t(1) << 40)) {
+            report(
+                name,
+                n,
+                std::chrono::duration<double, std::nano>(end - start).count(),
+                allocs);
+            return;
+        }
+
+        n *= 2;
+    }
+}
+} // namespace bench
+
+#define BENCH(_name, ...) bench::run((_name), [&]() { __VA_ARGS__; })
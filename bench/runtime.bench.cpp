@@ -0,0 +1,249 @@
+#include "bench.hpp"
+#include "runtime.bench.hpp"
+
+using namespace bench_types;
+
+int main(int argc, char *argv[]) {
+    bench::run_once("load", []() { archimedes::load(); });
+
+    BENCH("reflect<T>", bench::do_not_optimize(archimedes::reflect<Large>()));
+    BENCH(
+        "reflect(name)",
+        bench::do_not_optimize(archimedes::reflect("bench_types::Large")));
+    BENCH(
+        "reflect(name) miss",
+        bench::do_not_optimize(archimedes::reflect("bench_types::Missing")));
+
+    const auto large = archimedes::reflect<Large>()->as_record();
+    BENCH("field(name)", bench::do_not_optimize(large.field("m")));
+    BENCH("fields()", bench::do_not_optimize(large.fields()));
+
+    Large large_value;
+    const auto large_m = *archimedes::compile_path<Large>("m");
+    const auto vderived_x = *archimedes::compile_path<VDerived>("vbase_x");
+    VDerived vderived_value;
+    BENCH(
+        "field_path/get",
+        bench::do_not_optimize(large_m.get<double>(&large_value)));
+    BENCH(
+        "field_path/get virtual",
+        bench::do_not_optimize(vderived_x.get<int>(&vderived_value)));
+
+    Bits bits_value;
+    const auto bits_c = *archimedes::reflect<Bits>()->as_record().field("c");
+    BENCH(
+        "bit_field/value",
+        bench::do_not_optimize(bits_c.value<uint64_t>(bits_value)));
+    BENCH(
+        "bit_field/set",
+        bits_c.set(bits_value, uint64_t(7));
+        bench::do_not_optimize(bits_value));
+
+    const auto funcs = archimedes::reflect<Funcs>()->as_record();
+    const auto
+        f0 = *funcs.function("f0"),
+        f1 = *funcs.function("f1"),
+        f2 = *funcs.function("f2"),
+        f3 = *funcs.function("f3"),
+        f4 = *funcs.function("f4"),
+        f5 = *funcs.function("f5"),
+        f6 = *funcs.function("f6"),
+        f7 = *funcs.function("f7"),
+        f8 = *funcs.function("f8"),
+        member = *funcs.function("member");
+    BENCH("function(name)", bench::do_not_optimize(funcs.function("f4")));
+    BENCH("invoke/0", bench::do_not_optimize(f0.invoke()));
+    BENCH("invoke/1", bench::do_not_optimize(f1.invoke(1)));
+    BENCH("invoke/2", bench::do_not_optimize(f2.invoke(1, 2)));
+    BENCH("invoke/3", bench::do_not_optimize(f3.invoke(1, 2, 3)));
+    BENCH("invoke/4", bench::do_not_optimize(f4.invoke(1, 2, 3, 4)));
+    BENCH("invoke/5", bench::do_not_optimize(f5.invoke(1, 2, 3, 4, 5)));
+    BENCH("invoke/6", bench::do_not_optimize(f6.invoke(1, 2, 3, 4, 5, 6)));
+    BENCH("invoke/7", bench::do_not_optimize(f7.invoke(1, 2, 3, 4, 5, 6, 7)));
+    BENCH(
+        "invoke/8",
+        bench::do_not_optimize(f8.invoke(1, 2, 3, 4, 5, 6, 7, 8)));
+
+    Funcs fs;
+    BENCH("invoke/member", bench::do_not_optimize(member.invoke(&fs, 1)));
+
+    BENCH("any::make/int", bench::do_not_optimize(archimedes::any::make(1)));
+    Large l;
+    BENCH(
+        "any::make/large",
+        bench::do_not_optimize(archimedes::any::make(l)));
+    const auto any_large = archimedes::any::make(l);
+    BENCH("any/copy", archimedes::any a = any_large; bench::do_not_optimize(a));
+
+    BENCH(
+        "any::make_for_type/large",
+        bench::do_not_optimize(archimedes::any::make_for_type(large)));
+
+    archimedes::object_factory factory;
+    const auto large_pool = *factory.pool(large.id());
+    BENCH(
+        "object_pool/create+destroy",
+        void *p = large_pool->create();
+        bench::do_not_optimize(p);
+        large_pool->destroy(p));
+    void *burst[256];
+    BENCH(
+        "object_pool/create_n+destroy_n/256",
+        large_pool->create_n(burst);
+        large_pool->destroy_n(burst));
+
+    archimedes::any_vector large_vector { large };
+    BENCH(
+        "any_vector/emplace_back+clear/64",
+        for (size_t i = 0; i < 64; i++) { large_vector.emplace_back(); }
+        large_vector.clear());
+
+    archimedes::binary_serializer binary;
+    Packet packet;
+    uint8_t packet_buf[256];
+    BENCH(
+        "binary/write",
+        bench::do_not_optimize(binary.write(packet, packet_buf)));
+    BENCH(
+        "binary/read",
+        bench::do_not_optimize(
+            binary.read(packet, std::span<const uint8_t>(packet_buf))));
+
+    archimedes::json_serializer json;
+    std::string packet_json;
+    BENCH(
+        "json/write",
+        packet_json.clear();
+        bench::do_not_optimize(json.write(packet, packet_json)));
+    BENCH(
+        "json/read",
+        bench::do_not_optimize(json.read(packet, packet_json)));
+
+    archimedes::object_comparer comparer;
+    Packet other_packet;
+    uint64_t packet_mask[1];
+    BENCH(
+        "compare/equals",
+        bench::do_not_optimize(comparer.equals(packet, other_packet)));
+    BENCH(
+        "compare/hash",
+        bench::do_not_optimize(comparer.hash(packet)));
+    BENCH(
+        "compare/diff",
+        bench::do_not_optimize(
+            comparer.diff(packet, other_packet, packet_mask)));
+
+    archimedes::replicator replicator;
+    std::vector<Packet> packets(256);
+    auto packets_baseline =
+        *replicator.snapshot(std::span<const Packet>(packets));
+    std::vector<uint8_t> packets_buf(64 * 1024);
+    BENCH(
+        "replicate/encode/256",
+        packets[0].id++;
+        bench::do_not_optimize(
+            replicator.encode(
+                std::span<const Packet>(packets),
+                packets_baseline,
+                packets_buf)));
+
+    const auto packet_type = archimedes::reflect<Packet>()->as_record();
+    const auto
+        packet_id = *packet_type.field("id"),
+        packet_time = *packet_type.field("time");
+    std::vector<int> packet_ids(packets.size());
+    std::vector<double> packet_times(packets.size());
+    BENCH(
+        "gather/int/256",
+        bench::do_not_optimize(
+            archimedes::gather(
+                packet_id,
+                std::span<const Packet>(packets),
+                std::span<int>(packet_ids))));
+    BENCH(
+        "gather/double/256",
+        bench::do_not_optimize(
+            archimedes::gather(
+                packet_time,
+                std::span<const Packet>(packets),
+                std::span<double>(packet_times))));
+    BENCH(
+        "scatter/int/256",
+        bench::do_not_optimize(
+            archimedes::scatter(
+                packet_id,
+                std::span<Packet>(packets),
+                std::span<const int>(packet_ids))));
+
+    std::vector<Particle> particles(256);
+    auto particles_soa = *archimedes::any_soa_vector::make<Particle>();
+    for (const auto &p : particles) {
+        particles_soa.push_back(p);
+    }
+    const auto particle_vx = *particles_soa.column_index("vx");
+    BENCH(
+        "soa/push_back/256",
+        particles_soa.clear();
+        for (const auto &p : particles) {
+            particles_soa.push_back(p);
+        }
+        bench::do_not_optimize(particles_soa.size()));
+    BENCH(
+        "soa/column sum/256",
+        float sum = 0.0f;
+        for (const auto vx : particles_soa.column<float>(particle_vx)) {
+            sum += vx;
+        }
+        bench::do_not_optimize(sum));
+    BENCH(
+        "soa/row load/256",
+        Particle p;
+        for (size_t i = 0; i < particles_soa.size(); i++) {
+            particles_soa[i].load(&p);
+        }
+        bench::do_not_optimize(p));
+
+    const auto
+        base = archimedes::reflect<Base>()->as_record(),
+        derived = archimedes::reflect<Derived>()->as_record(),
+        vbase = archimedes::reflect<VBase>()->as_record(),
+        vderived = archimedes::reflect<VDerived>()->as_record();
+    Derived d;
+    VDerived vd;
+    BENCH(
+        "cast/up",
+        bench::do_not_optimize(archimedes::cast(&d, derived, base)));
+    BENCH(
+        "cast/down",
+        bench::do_not_optimize(
+            archimedes::cast(static_cast<Base*>(&d), base, derived)));
+    BENCH(
+        "cast/virtual",
+        bench::do_not_optimize(archimedes::cast(&vd, vderived, vbase)));
+
+    BENCH(
+        "reflect_children",
+        bench::do_not_optimize(archimedes::reflect_children(base)));
+
+    const auto
+        color = archimedes::reflect<Color>()->as_enum(),
+        access = archimedes::reflect<Access>()->as_enum();
+    BENCH("enum/name_of", bench::do_not_optimize(color.name_of(Color::BLACK)));
+    BENCH(
+        "enum/value_of",
+        bench::do_not_optimize(color.value_of<Color>("MAGENTA")));
+    char buf[64];
+    BENCH(
+        "enum/format_flags",
+        bench::do_not_optimize(
+            access.format_flags(
+                static_cast<Access>(0b1011), std::span { buf })));
+
+    const std::string_view annotations[] = { "bench" };
+    BENCH(
+        "find_by_annotations",
+        bench::do_not_optimize(
+            archimedes::reflect_by_annotations(annotations)));
+
+    return 0;
+}
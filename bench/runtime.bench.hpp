@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace bench_types {
+struct Base {
+    int base_x = 1;
+    virtual ~Base() = default;
+};
+
+struct Derived : public Base {
+    int derived_x = 2;
+};
+
+struct VBase {
+    int vbase_x = 3;
+    virtual ~VBase() = default;
+};
+
+struct VLeft : virtual public VBase { int l = 4; };
+struct VRight : virtual public VBase { int r = 5; };
+struct VDerived : public VLeft, public VRight { int d = 6; };
+
+struct [[clang::annotate("bench")]] Annotated {
+    int a;
+};
+
+struct Large {
+    int a = 0, b = 1, c = 2, d = 3, e = 4, f = 5, g = 6, h = 7;
+    float i = 8, j = 9, k = 10, l = 11;
+    double m = 12, n = 13, o = 14, p = 15;
+    std::string name = "large";
+    std::vector<int> values = { 1, 2, 3, 4 };
+};
+
+struct Packet {
+    int id = 1;
+    float position[3] = { 1.0f, 2.0f, 3.0f };
+    float velocity[3] = { 4.0f, 5.0f, 6.0f };
+    uint16_t flags = 7;
+    double time = 8.0;
+    std::string tag = "packet";
+};
+
+struct Particle {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    float vx = 1.0f, vy = 2.0f, vz = 3.0f;
+    int id = 0;
+};
+
+struct Bits {
+    uint32_t a : 3 = 1;
+    int32_t b : 13 = -2;
+    uint64_t c : 40 = 3;
+};
+
+struct Funcs {
+    static int f0() { return 0; }
+    static int f1(int a) { return a; }
+    static int f2(int a, int b) { return a + b; }
+    static int f3(int a, int b, int c) { return a + b + c; }
+    static int f4(int a, int b, int c, int d) { return a + b + c + d; }
+    static int f5(int a, int b, int c, int d, int e) {
+        return a + b + c + d + e;
+    }
+    static int f6(int a, int b, int c, int d, int e, int f) {
+        return a + b + c + d + e + f;
+    }
+    static int f7(int a, int b, int c, int d, int e, int f, int g) {
+        return a + b + c + d + e + f + g;
+    }
+    static int f8(int a, int b, int c, int d, int e, int f, int g, int h) {
+        return a + b + c + d + e + f + g + h;
+    }
+
+    int member(int a) const { return a + this->x; }
+    int x = 1;
+};
+
+enum class Color { RED, GREEN, BLUE, CYAN, MAGENTA, YELLOW, BLACK, WHITE };
+
+enum class Access : uint32_t {
+    NONE = 0,
+    READ = 1 << 0,
+    WRITE = 1 << 1,
+    EXEC = 1 << 2,
+    APPEND = 1 << 3
+};
+}
@@ -0,0 +1,238 @@
+// compile time scaling harness for the archimedes plugin
+// usage: $ scale <plugin> "<compile command>" "<link flags>" [n...]
+//
+// for each n, generates a synthetic codebase (see synth.hpp) of n headers and
+// compiles it with and without the plugin, then links and runs it to measure
+// archimedes::load(). per-phase plugin timings come from the plugin's
+// "stats-<path>" argument. prints one JSON object per line per n, followed by one
+// line per metric and step between consecutive n-s with the growth exponent
+// (log(metric ratio) / log(n ratio)), flagging superlinear growth.
+// set ARCHIMEDES_SCALE_M to change the number of records per header.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "synth.hpp"
+
+namespace fs = std::filesystem;
+
+// growth exponents above this are reported as superlinear
+static constexpr double SUPERLINEAR_EXPONENT = 1.25;
+
+// plugin phases reported by "stats-<path>", see plugin/stats.hpp
+static const std::vector<std::string> PHASES = {
+    "traverse", "populate", "invokers", "emit", "serialize", "compile"
+};
+
+struct sample {
+    size_t n;
+    double compile_ms, compile_plugin_ms, overhead_ms, load_ms;
+    uintmax_t types_object_bytes;
+    std::map<std::string, double> phase_ms;
+};
+
+// get numeric value of "key" in a flat JSON object
+static double json_number(std::string_view json, std::string_view key) {
+    const auto k = fmt::format("\"{}\": ", key);
+    const auto i = json.find(k);
+    if (i == std::string_view::npos) {
+        return 0.0;
+    }
+
+    const auto value = std::string(json.substr(i + k.length()));
+    return std::strtod(value.c_str(), nullptr);
+}
+
+// run command, returning wall time in ms or nullopt on failure
+static std::optional<double> timed(const std::string &cmd) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto res = std::system(cmd.c_str());
+    const auto end = std::chrono::steady_clock::now();
+    if (res != 0) {
+        fmt::print(stderr, "command failed ({}): {}\n", res, cmd);
+        return std::nullopt;
+    }
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// run command and return its first line of output
+static std::optional<std::string> output_of(const std::string &cmd) {
+    FILE *f = popen(cmd.c_str(), "r");
+    if (!f) {
+        return std::nullopt;
+    }
+
+    char buf[256] = { 0 };
+    const bool ok = std::fgets(buf, sizeof(buf), f) != nullptr;
+    return (pclose(f) == 0 && ok) ?
+        std::make_optional(std::string(buf))
+        : std::nullopt;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        fmt::print(
+            stderr,
+            "usage: {} <plugin> <compile command> <link flags> [n...]\n",
+            argv[0]);
+        return 1;
+    }
+
+    const std::string plugin = fs::absolute(argv[1]).string();
+    const std::string compile = argv[2], link = argv[3];
+
+    std::vector<size_t> ns;
+    for (int i = 4; i < argc; i++) {
+        ns.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+
+    if (ns.empty()) {
+        ns = { 1, 2, 4, 8, 16 };
+    }
+
+    const char *m_env = std::getenv("ARCHIMEDES_SCALE_M");
+    const size_t m = m_env ? std::strtoull(m_env, nullptr, 10) : 16;
+
+    std::vector<sample> samples;
+    for (const auto n : ns) {
+        const auto dir =
+            fs::temp_directory_path() / fmt::format("archimedes_scale_{}", n);
+        fs::remove_all(dir);
+        bench::synth::generate(dir, n, m);
+
+        const auto main_cpp = (dir / "main.cpp").string();
+        const auto main_o = (dir / "main.o").string();
+        const auto types_o = (dir / "main.types.o").string();
+        const auto exe = (dir / "main").string();
+        const auto stats = (dir / "stats.json").string();
+
+        const auto baseline =
+            timed(fmt::format("{} -c {} -o {}", compile, main_cpp, main_o));
+
+        const auto with_plugin =
+            timed(
+                fmt::format(
+                    "{0} -c {1} -o {2}"
+                    " -fplugin={3}"
+                    " -fplugin-arg-archimedes-exclude-ns-std"
+                    " -fplugin-arg-archimedes-header-include/archimedes.hpp"
+                    " '-fplugin-arg-archimedes-include-path-regex-{4}/.*'"
+                    " -fplugin-arg-archimedes-out-{5}"
+                    " -fplugin-arg-archimedes-stats-{6}",
+                    compile,
+                    main_cpp,
+                    main_o,
+                    plugin,
+                    dir.string(),
+                    types_o,
+                    stats));
+
+        if (!baseline || !with_plugin) {
+            return 1;
+        }
+
+        const auto linked =
+            timed(
+                fmt::format(
+                    "{} -o {} {} {} {}", compile, exe, main_o, types_o, link));
+        if (!linked) {
+            return 1;
+        }
+
+        const auto load_ns = output_of(exe);
+        if (!load_ns) {
+            fmt::print(stderr, "failed to run {}\n", exe);
+            return 1;
+        }
+
+        std::string stats_line;
+        std::getline(std::ifstream(stats), stats_line);
+
+        auto &s =
+            samples.emplace_back(
+                sample {
+                    .n = n,
+                    .compile_ms = *baseline,
+                    .compile_plugin_ms = *with_plugin,
+                    .overhead_ms = *with_plugin - *baseline,
+                    .load_ms = std::strtod(load_ns->c_str(), nullptr) / 1e6,
+                    .types_object_bytes = fs::file_size(types_o),
+                    .phase_ms = {}
+                });
+
+        std::string phases;
+        for (const auto &p : PHASES) {
+            s.phase_ms[p] = json_number(stats_line, p + "_ms");
+            phases += fmt::format(", \"{}_ms\": {:.2f}", p, s.phase_ms[p]);
+        }
+
+        fmt::print(
+            "{{\"n\": {}, \"m\": {}, \"compile_ms\": {:.2f}, "
+            "\"compile_plugin_ms\": {:.2f}, \"overhead_ms\": {:.2f}, "
+            "\"types_object_bytes\": {}, \"load_ms\": {:.3f}{}}}\n",
+            s.n,
+            m,
+            s.compile_ms,
+            s.compile_plugin_ms,
+            s.overhead_ms,
+            s.types_object_bytes,
+            s.load_ms,
+            phases);
+        std::fflush(stdout);
+    }
+
+    // growth between consecutive samples
+    const std::map<std::string, double sample::*> metrics = {
+        { "overhead_ms", &sample::overhead_ms },
+        { "load_ms", &sample::load_ms },
+    };
+
+    bool any_superlinear = false;
+    for (size_t i = 1; i < samples.size(); i++) {
+        const auto &a = samples[i - 1], &b = samples[i];
+        if (b.n <= a.n) {
+            continue;
+        }
+
+        const auto exponent =
+            [&](double x, double y) {
+                return (x <= 0 || y <= 0) ?
+                    0.0
+                    : std::log(y / x) / std::log(double(b.n) / double(a.n));
+            };
+
+        const auto report =
+            [&](std::string_view name, double e) {
+                const bool superlinear = e > SUPERLINEAR_EXPONENT;
+                any_superlinear |= superlinear;
+                fmt::print(
+                    "{{\"metric\": \"{}\", \"from\": {}, \"to\": {}, "
+                    "\"exponent\": {:.2f}, \"superlinear\": {}}}\n",
+                    name, a.n, b.n, e, superlinear);
+            };
+
+        for (const auto &[name, p] : metrics) {
+            report(name, exponent(a.*p, b.*p));
+        }
+
+        report(
+            "types_object_bytes",
+            exponent(a.types_object_bytes, b.types_object_bytes));
+
+        for (const auto &p : PHASES) {
+            report(
+                p + "_ms",
+                exponent(a.phase_ms.at(p), b.phase_ms.at(p)));
+        }
+    }
+
+    if (any_superlinear) {
+        fmt::print(stderr, "WARNING: superlinear growth detected\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+// generates a synthetic codebase, see synth.hpp
+// usage: $ synth <output directory> <n headers> <m records per header>
+
+#include <cstdlib>
+#include <string>
+
+#include "synth.hpp"
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        fmt::print(stderr, "usage: {} <dir> <n> <m>\n", argv[0]);
+        return 1;
+    }
+
+    bench::synth::generate(
+        argv[1],
+        std::strtoull(argv[2], nullptr, 10),
+        std::strtoull(argv[3], nullptr, 10));
+    return 0;
+}
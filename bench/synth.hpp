@@ -0,0 +1,118 @@
+#pragma once
+
+// synthetic codebase generator for compile time benchmarks
+// generates n headers each with m records (deep inheritance chains, virtual
+// bases, templates, overload sets, enums) plus a main.cpp which includes all of
+// them and prints the time taken by archimedes::load() in nanoseconds
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#define FMT_HEADER_ONLY
+#include <fmt/core.h>
+
+namespace bench::synth {
+namespace fs = std::filesystem;
+
+inline std::string header_name(size_t i) {
+    return fmt::format("gen_{}.hpp", i);
+}
+
+inline std::string generate_header(size_t i, size_t m) {
+    std::string out;
+    out += "#pragma once\n\n#include <string>\n#include <vector>\n\n";
+    out += fmt::format("namespace gen_{} {{\n", i);
+
+    // shared virtual base for this header
+    out += "struct VBase { int vb = 0; virtual ~VBase() = default; };\n\n";
+
+    for (size_t j = 0; j < m; j++) {
+        out +=
+            fmt::format(
+                "enum class E{0} {{ A{0}, B{0}, C{0}, D{0}, E{0}, F{0} }};\n",
+                j);
+
+        out +=
+            fmt::format(
+                "template <typename T>\n"
+                "struct T{0} {{\n"
+                "    T value;\n"
+                "    T get() const {{ return value; }}\n"
+                "    void set(const T &t) {{ value = t; }}\n"
+                "}};\n",
+                j);
+
+        // every record derives from the previous one (deep inheritance),
+        // every fourth additionally from the virtual base
+        std::string bases;
+        if (j > 0) {
+            bases += fmt::format("public R{}", j - 1);
+        }
+        if (j % 4 == 0) {
+            bases += fmt::format("{}virtual public VBase", j > 0 ? ", " : "");
+        }
+
+        out +=
+            fmt::format(
+                "struct R{0}{1}{2} {{\n"
+                "    int i{0} = {0};\n"
+                "    float f{0} = {0};\n"
+                "    std::string s{0};\n"
+                "    std::vector<int> v{0};\n"
+                "    E{0} e{0} = E{0}::A{0};\n"
+                "    T{0}<int> ti{0};\n"
+                "    T{0}<double> td{0};\n"
+                "    static inline int count{0} = 0;\n"
+                "    int m{0}(int x) {{ return x + i{0}; }}\n"
+                "    int m{0}(float x) {{ return int(x) + i{0}; }}\n"
+                "    int m{0}(const std::string &x) {{ return int(x.size()); }}\n"
+                "    int m{0}(int x, int y) const {{ return x + y; }}\n"
+                "    virtual int v{0}_virtual() {{ return {0}; }}\n"
+                "    static R{0} make{0}() {{ return R{0}(); }}\n"
+                "}};\n\n",
+                j,
+                bases.empty() ? "" : " : ",
+                bases);
+    }
+
+    // free function overload set
+    out += fmt::format("inline int free_{0}(int x) {{ return x; }}\n", i);
+    out += fmt::format("inline int free_{0}(double x) {{ return int(x); }}\n", i);
+    out += "}\n";
+    return out;
+}
+
+inline std::string generate_main(size_t n) {
+    std::string out;
+    out += "#include <chrono>\n#include <cstdio>\n";
+    out += "#include <archimedes.hpp>\n\n";
+    for (size_t i = 0; i < n; i++) {
+        out += fmt::format("#include \"{}\"\n", header_name(i));
+    }
+
+    out += R"(
+int main() {
+    const auto start = std::chrono::steady_clock::now();
+    archimedes::load();
+    const auto end = std::chrono::steady_clock::now();
+    std::printf(
+        "%lld\n",
+        static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                end - start).count()));
+    return archimedes::types().empty() ? 1 : 0;
+}
+)";
+    return out;
+}
+
+// generate n headers with m records each and main.cpp into dir
+inline void generate(const fs::path &dir, size_t n, size_t m) {
+    fs::create_directories(dir);
+    for (size_t i = 0; i < n; i++) {
+        std::ofstream(dir / header_name(i)) << generate_header(i, m);
+    }
+    std::ofstream(dir / "main.cpp") << generate_main(n);
+}
+} // namespace bench::synth
@@ -9,8 +9,15 @@ any::~any() {
     if (this->is_data_owned) {
         // check if archimedes is still loaded - if it isn't, our dtor function
         // may have disappeared.
-        if (archimedes::loaded() && this->dtor_fn) {
-            (*this->dtor_fn)(this->data);
+        if (archimedes::loaded() && this->ops && this->ops->destroy) {
+            this->ops->destroy(this->data);
+        } else if (archimedes::loaded() && this->uses_invokers) {
+            const auto type = reflect(this->_id);
+            const auto dtor =
+                type ? type->as_record().destructor() : std::nullopt;
+            if (dtor) {
+                dtor->invoke(this->data);
+            }
         }
 
         std::free(this->data);
@@ -37,61 +44,75 @@ result<any, any_error> any::make_for_id(type_id id) {
         return any::make_ptr(id);
     }
 
-    any a = any::make_of_size(id, type->size());
-
     if (type->is_record()) {
         if (type->size() == 0) {
             return any_error::INVALID_TYPE;
         }
 
-        const auto rec = type->as_record();
-        const auto ctor = rec.default_constructor();
-        if (!ctor) {
+        // ops are emitted by the plugin from the constructors/destructor
+        // which are reflected and invokable
+        const auto *ops = type->ops();
+        if (ops && ops->construct) {
+            any a = any::make_of_size(id, type->size(), ops);
+            ops->construct(a.storage());
+            return a;
+        } else if (ops) {
             return any_error::NO_DEFAULT_CTOR;
         }
 
-        if (const auto dtor = rec.destructor()) {
-            a.dtor_fn =
-                [dtor = *dtor](void *p) {
-                    dtor.invoke(p);
-                };
-        }
-
-        if (const auto copy = rec.copy_constructor()) {
-            a.copy_fn =
-                [copy = *copy](void *p, void *o) {
-                    if (!copy.invoke(p, o)) {
-                        ARCHIMEDES_FAIL("failed to invoke copy ctor");
-                    }
-                };
-        } else if (const auto copy_assign = rec.copy_assignment()) {
-            a.copy_fn =
-                [ctor = *ctor, copy_assign = *copy_assign](void *p, void *o) {
-                    if (!ctor.invoke(p)) {
-                        ARCHIMEDES_FAIL("failed to invoke default ctor");
-                    }
-
-                    if (!copy_assign.invoke(p, o)) {
-                        ARCHIMEDES_FAIL("failed to invoke copy assign");
-                    }
-                };
+        // no ops could be emitted, go through the reflected functions
+        const auto ctor = type->as_record().default_constructor();
+        if (!ctor) {
+            return any_error::NO_DEFAULT_CTOR;
         }
 
+        any a = any::make_of_size(id, type->size());
+        a.uses_invokers = true;
         if (!ctor->invoke(a.storage())) {
             ARCHIMEDES_FAIL("failed to invoke default ctor");
         }
-    } else if (type->is_numeric()) {
+        return a;
+    }
+
+    any a = any::make_of_size(id, type->size());
+
+    if (type->is_numeric()) {
         // numeric types are stored on the heap with a simple memcpy copy
-        a.copy_fn =
-            [size = a.data_size](void *p, void *o) {
-                std::memcpy(p, o, size);
-            };
+        a.ops = &detail::trivial_ops;
         std::memset(a.data, 0, a.data_size);
     }
 
     return a;
 }
 
+void any::copy_with_invokers(const void *src) {
+    const auto rec = reflect(this->_id)->as_record();
+    void *p = this->data;
+    void *o = const_cast<void*>(src);
+
+    if (const auto copy = rec.copy_constructor()) {
+        if (!copy->invoke(p, o)) {
+            ARCHIMEDES_FAIL("failed to invoke copy ctor");
+        }
+        return;
+    }
+
+    const auto ctor = rec.default_constructor();
+    const auto copy_assign = rec.copy_assignment();
+    if (!ctor || !copy_assign) {
+        ARCHIMEDES_FAIL("attempt to copy uncopyable type");
+        return;
+    }
+
+    if (!ctor->invoke(p)) {
+        ARCHIMEDES_FAIL("failed to invoke default ctor");
+    }
+
+    if (!copy_assign->invoke(p, o)) {
+        ARCHIMEDES_FAIL("failed to invoke copy assign");
+    }
+}
+
 result<any, any_error> any::make_for_type(
     const reflected_type &type) {
     return any::make_for_id(type.id());
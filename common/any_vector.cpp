@@ -0,0 +1,324 @@
+#include <archimedes/any_vector.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace archimedes;
+
+// value_ops of type, trivial_ops for numeric/pointer types (which have no
+// emitted ops) and arrays of them
+static const value_ops *ops_of(const reflected_type &type) {
+    if (type.ops()) {
+        return type.ops();
+    } else if (type.is_numeric()
+            || type.kind() == PTR
+            || type.kind() == MEMBER_PTR) {
+        return &detail::trivial_ops;
+    } else if (type.is_array()) {
+        const auto elem = reflect(type.as_array().element_type_id());
+        const auto *ops = elem ? ops_of(*elem) : nullptr;
+        return ops && ops->is_trivial ? &detail::trivial_ops : nullptr;
+    }
+
+    return nullptr;
+}
+
+bool any_vector::supports(const reflected_type &type) {
+    return ops_of(type) != nullptr && type.size() != 0;
+}
+
+any_vector::any_vector(const reflected_type &type)
+    : _id(type.id()),
+      _ops(ops_of(type)),
+      elem_size(type.size()),
+      alignment(std::max<size_t>(type.align(), 1)) {
+    if (!this->_ops || this->elem_size == 0) {
+        ARCHIMEDES_FAIL("any_vector of type without value ops");
+    }
+}
+
+any_vector::any_vector(const any_vector &other) {
+    *this = other;
+}
+
+any_vector &any_vector::operator=(const any_vector &other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    this->clear();
+    if (this->_id != other._id) {
+        this->reallocate(0);
+        this->_id = other._id;
+        this->_ops = other._ops;
+        this->elem_size = other.elem_size;
+        this->alignment = other.alignment;
+    }
+
+    this->reserve(other._size);
+
+    if (other._size != 0 && this->_ops->is_trivial) {
+        std::memcpy(this->_data, other._data, other._size * this->elem_size);
+        this->_size = other._size;
+        return *this;
+    }
+
+    if (other._size != 0 && !this->_ops->copy) {
+        ARCHIMEDES_FAIL("attempt to copy any_vector of uncopyable type");
+        return *this;
+    }
+
+    for (size_t i = 0; i < other._size; i++) {
+        this->_ops->copy((*this)[i], other[i]);
+        this->_size++;
+    }
+
+    return *this;
+}
+
+any_vector &any_vector::operator=(any_vector &&other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    this->clear();
+    this->reallocate(0);
+    this->_id = other._id;
+    this->_ops = other._ops;
+    this->elem_size = other.elem_size;
+    this->alignment = other.alignment;
+    this->_data = std::exchange(other._data, nullptr);
+    this->_size = std::exchange(other._size, 0);
+    this->_capacity = std::exchange(other._capacity, 0);
+    return *this;
+}
+
+any_vector::~any_vector() {
+    // see ~any, ops may have disappeared if archimedes is unloaded
+    if (archimedes::loaded()) {
+        this->clear();
+    }
+
+    if (this->_data) {
+        ::operator delete(this->_data, std::align_val_t(this->alignment));
+    }
+}
+
+void any_vector::reserve(size_t n) {
+    if (n > this->_capacity) {
+        this->reallocate(std::max(n, this->_capacity * 2));
+    }
+}
+
+void any_vector::resize(size_t n) {
+    if (n <= this->_size) {
+        this->destroy(n, this->_size);
+        this->_size = n;
+        return;
+    }
+
+    this->reserve(n);
+
+    // trivial types without a ctor are zeroed
+    if (!this->_ops->construct && this->_ops->is_trivial) {
+        std::memset(
+            (*this)[this->_size], 0, (n - this->_size) * this->elem_size);
+        this->_size = n;
+        return;
+    } else if (!this->_ops->construct) {
+        ARCHIMEDES_FAIL("any_vector::resize of type without default ctor");
+        return;
+    }
+
+    for (size_t i = this->_size; i < n; i++) {
+        this->_ops->construct((*this)[i]);
+        this->_size++;
+    }
+}
+
+void *any_vector::emplace_back() {
+    if (!this->_ops->construct && !this->_ops->is_trivial) {
+        ARCHIMEDES_FAIL(
+            "any_vector::emplace_back of type without default ctor");
+        return nullptr;
+    }
+
+    void *p = this->grow_one();
+    if (this->_ops->construct) {
+        this->_ops->construct(p);
+    } else {
+        std::memset(p, 0, this->elem_size);
+    }
+    this->_size++;
+    return p;
+}
+
+void *any_vector::push_back(const void *src) {
+    if (!this->_ops->copy && !this->_ops->is_trivial) {
+        ARCHIMEDES_FAIL("any_vector::push_back of uncopyable type");
+        return nullptr;
+    }
+
+    // src may point into this vector, copy before growing invalidates it
+    if (this->_size == this->_capacity
+            && src >= this->_data
+            && src < this->_data + (this->_size * this->elem_size)) {
+        const auto i =
+            (static_cast<const uint8_t*>(src) - this->_data) / this->elem_size;
+        this->reserve(this->_size + 1);
+        src = (*this)[i];
+    }
+
+    void *p = this->grow_one();
+    if (this->_ops->copy) {
+        this->_ops->copy(p, src);
+    } else {
+        std::memcpy(p, src, this->elem_size);
+    }
+    this->_size++;
+    return p;
+}
+
+void *any_vector::push_back_move(void *src) {
+    if (!this->_ops->move) {
+        return this->push_back(static_cast<const void*>(src));
+    }
+
+    if (this->_size == this->_capacity
+            && src >= this->_data
+            && src < this->_data + (this->_size * this->elem_size)) {
+        const auto i =
+            (static_cast<const uint8_t*>(src) - this->_data) / this->elem_size;
+        this->reserve(this->_size + 1);
+        src = (*this)[i];
+    }
+
+    void *p = this->grow_one();
+    this->_ops->move(p, src);
+    this->_size++;
+    return p;
+}
+
+void any_vector::pop_back() {
+    if (this->_size == 0) {
+        ARCHIMEDES_FAIL("any_vector::pop_back on empty vector");
+        return;
+    }
+
+    this->destroy(this->_size - 1, this->_size);
+    this->_size--;
+}
+
+void any_vector::erase(size_t first, size_t last) {
+    last = std::min(last, this->_size);
+    if (first >= last) {
+        return;
+    }
+
+    this->destroy(first, last);
+    const auto n = this->_size - last;
+    if (this->_ops->is_trivial) {
+        std::memmove(
+            (*this)[first], (*this)[last], n * this->elem_size);
+    } else {
+        // ranges may overlap, relocate front to back one at a time
+        for (size_t i = 0; i < n; i++) {
+            this->relocate(
+                static_cast<uint8_t*>((*this)[first + i]),
+                static_cast<uint8_t*>((*this)[last + i]),
+                1);
+        }
+    }
+
+    this->_size -= last - first;
+}
+
+void any_vector::swap_erase(size_t i) {
+    if (i >= this->_size) {
+        return;
+    }
+
+    this->destroy(i, i + 1);
+    if (i != this->_size - 1) {
+        this->relocate(
+            static_cast<uint8_t*>((*this)[i]),
+            static_cast<uint8_t*>((*this)[this->_size - 1]),
+            1);
+    }
+
+    this->_size--;
+}
+
+void any_vector::clear() {
+    this->destroy(0, this->_size);
+    this->_size = 0;
+}
+
+void any_vector::shrink_to_fit() {
+    if (this->_capacity != this->_size) {
+        this->reallocate(this->_size);
+    }
+}
+
+void *any_vector::grow_one() {
+    if (this->_size == this->_capacity) {
+        this->reserve(std::max<size_t>(this->_size + 1, 4));
+    }
+
+    return (*this)[this->_size];
+}
+
+void any_vector::relocate(uint8_t *dst, uint8_t *src, size_t n) const {
+    if (this->_ops->is_trivial) {
+        std::memcpy(dst, src, n * this->elem_size);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        auto *d = dst + (i * this->elem_size), *s = src + (i * this->elem_size);
+        if (this->_ops->move) {
+            this->_ops->move(d, s);
+        } else if (this->_ops->copy) {
+            this->_ops->copy(d, s);
+        } else {
+            ARCHIMEDES_FAIL("any_vector cannot relocate immovable type");
+        }
+
+        if (this->_ops->destroy) {
+            this->_ops->destroy(s);
+        }
+    }
+}
+
+void any_vector::destroy(size_t first, size_t last) {
+    if (!this->_ops || !this->_ops->destroy) {
+        return;
+    }
+
+    for (size_t i = first; i < last; i++) {
+        this->_ops->destroy((*this)[i]);
+    }
+}
+
+void any_vector::reallocate(size_t n) {
+    uint8_t *data =
+        n == 0 ?
+            nullptr
+            : static_cast<uint8_t*>(
+                ::operator new(
+                    n * this->elem_size,
+                    std::align_val_t(this->alignment)));
+
+    if (this->_data) {
+        if (this->_size != 0) {
+            this->relocate(data, this->_data, this->_size);
+        }
+
+        ::operator delete(this->_data, std::align_val_t(this->alignment));
+    }
+
+    this->_data = data;
+    this->_capacity = n;
+}
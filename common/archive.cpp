@@ -0,0 +1,427 @@
+#include <archimedes/archive.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace archimedes;
+
+// "ARCA"
+static constexpr uint32_t ARCHIVE_MAGIC = 0x41435241, ARCHIVE_VERSION = 1;
+
+// section data is aligned to at least this
+static constexpr size_t SECTION_ALIGN = 64;
+
+namespace {
+struct file_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;
+    uint64_t num_sections;
+};
+
+// followed by section names, then section data
+struct file_section {
+    uint64_t type_id;
+    uint64_t layout_hash;
+    uint64_t offset;
+    uint64_t count;
+    uint64_t stride;
+    uint64_t align;
+    uint64_t name_offset;
+    uint64_t name_size;
+};
+} // namespace
+
+static size_t align_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+static void hash_append(uint64_t &h, const void *p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ static_cast<const uint8_t*>(p)[i]) * 1099511628211u;
+    }
+}
+
+template <typename T>
+static void hash_append(uint64_t &h, const T &t) {
+    hash_append(h, &t, sizeof(t));
+}
+
+static std::optional<archive_error> hash_layout(uint64_t &h, type_id id) {
+    const auto type = reflect(id);
+    if (!type) {
+        return archive_error::COULD_NOT_REFLECT;
+    }
+
+    hash_append(h, id.value());
+    hash_append(h, type->kind());
+    hash_append(h, type->size());
+    hash_append(h, type->align());
+
+    if (type->is_numeric()) {
+        return std::nullopt;
+    }
+
+    switch (type->kind()) {
+        case ARRAY:
+            hash_append(h, type->as_array().length());
+            return hash_layout(h, type->as_array().element_type_id());
+        case STRUCT:
+        case UNION:
+            break;
+        default:
+            return archive_error::UNSUPPORTED_TYPE;
+    }
+
+    const auto record = type->as_record();
+    if (!record.is_trivially_copyable()) {
+        return archive_error::UNSUPPORTED_TYPE;
+    }
+
+    for (const auto &b : record.bases()) {
+        hash_append(h, b.offset());
+        if (const auto err = hash_layout(h, b.type().id())) {
+            return err;
+        }
+    }
+
+    // fields are unordered
+    auto fields = record.fields();
+    std::sort(
+        fields.begin(),
+        fields.end(),
+        [](const auto &a, const auto &b) {
+            return a.is_bit_field() != b.is_bit_field() ?
+                a.is_bit_field() < b.is_bit_field()
+                : a.is_bit_field() ?
+                    *a.bit_offset() < *b.bit_offset()
+                    : a.offset() < b.offset();
+        });
+
+    for (const auto &f : fields) {
+        hash_append(h, f.name().data(), f.name().size());
+        hash_append(h, f.offset());
+        if (f.is_bit_field()) {
+            hash_append(h, *f.bit_offset());
+            hash_append(h, *f.bit_field_size());
+        }
+
+        if (const auto err = hash_layout(h, f.field_type_id())) {
+            return err;
+        }
+    }
+
+    return std::nullopt;
+}
+
+result<uint64_t, archive_error> archimedes::layout_hash(type_id id) {
+    uint64_t h = 14695981039346656037u;
+    if (const auto err = hash_layout(h, id)) {
+        return *err;
+    }
+
+    return h;
+}
+
+std::optional<archive_error> archive_writer::add(
+    std::string_view name,
+    type_id id,
+    const void *data,
+    size_t count) {
+    const auto type = reflect(id);
+    if (!type) {
+        return archive_error::COULD_NOT_REFLECT;
+    }
+
+    const auto hash = layout_hash(id);
+    if (!hash) {
+        return hash.unwrap_error();
+    }
+
+    for (const auto &e : this->entries) {
+        if (e.name == name) {
+            return archive_error::DUPLICATE_SECTION;
+        }
+    }
+
+    this->entries.push_back(
+        entry {
+            .name = std::string(name),
+            .id = id,
+            .layout_hash = *hash,
+            .data = data,
+            .count = count,
+            .stride = type->size(),
+            .align = std::max<size_t>(type->align(), 1)
+        });
+    return std::nullopt;
+}
+
+vector<size_t> archive_writer::layout() const {
+    size_t offset =
+        sizeof(file_header) + (this->entries.size() * sizeof(file_section));
+    for (const auto &e : this->entries) {
+        offset += e.name.size();
+    }
+
+    vector<size_t> offsets;
+    for (const auto &e : this->entries) {
+        offset = align_up(offset, std::max(e.align, SECTION_ALIGN));
+        offsets.push_back(offset);
+        offset += e.count * e.stride;
+    }
+
+    offsets.push_back(offset);
+    return offsets;
+}
+
+size_t archive_writer::size() const {
+    return this->layout().back();
+}
+
+void archive_writer::write_prefix(
+    const vector<size_t> &offsets,
+    std::span<uint8_t> out) const {
+    const auto header =
+        file_header {
+            .magic = ARCHIVE_MAGIC,
+            .version = ARCHIVE_VERSION,
+            .size = offsets.back(),
+            .num_sections = this->entries.size()
+        };
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    size_t name_offset =
+        sizeof(file_header) + (this->entries.size() * sizeof(file_section));
+    for (size_t i = 0; i < this->entries.size(); i++) {
+        const auto &e = this->entries[i];
+        const auto section =
+            file_section {
+                .type_id = e.id.value(),
+                .layout_hash = e.layout_hash,
+                .offset = offsets[i],
+                .count = e.count,
+                .stride = e.stride,
+                .align = e.align,
+                .name_offset = name_offset,
+                .name_size = e.name.size()
+            };
+        std::memcpy(
+            out.data() + sizeof(file_header) + (i * sizeof(file_section)),
+            &section,
+            sizeof(section));
+        std::memcpy(out.data() + name_offset, e.name.data(), e.name.size());
+        name_offset += e.name.size();
+    }
+}
+
+result<size_t, archive_error> archive_writer::write(
+    std::span<uint8_t> out) const {
+    const auto offsets = this->layout();
+    if (out.size() < offsets.back()) {
+        return archive_error::IO_ERROR;
+    }
+
+    // zero padding
+    std::memset(out.data(), 0, offsets.back());
+    this->write_prefix(offsets, out);
+
+    for (size_t i = 0; i < this->entries.size(); i++) {
+        const auto &e = this->entries[i];
+        if (e.count != 0) {
+            std::memcpy(out.data() + offsets[i], e.data, e.count * e.stride);
+        }
+    }
+
+    return offsets.back();
+}
+
+std::optional<archive_error> archive_writer::write(
+    const std::string &path) const {
+    const auto offsets = this->layout();
+
+    // header, sections and names
+    vector<uint8_t> prefix(offsets.size() > 1 ? offsets[0] : offsets.back());
+    this->write_prefix(offsets, prefix);
+
+    FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        return archive_error::IO_ERROR;
+    }
+
+    bool ok = std::fwrite(prefix.data(), 1, prefix.size(), f) == prefix.size();
+    size_t pos = prefix.size();
+
+    static constexpr uint8_t zeros[SECTION_ALIGN] = { 0 };
+    for (size_t i = 0; ok && i < this->entries.size(); i++) {
+        const auto &e = this->entries[i];
+        while (ok && pos < offsets[i]) {
+            const auto n = std::min(offsets[i] - pos, sizeof(zeros));
+            ok = std::fwrite(zeros, 1, n, f) == n;
+            pos += n;
+        }
+
+        const auto n = e.count * e.stride;
+        ok = ok && (n == 0 || std::fwrite(e.data, 1, n, f) == n);
+        pos += n;
+    }
+
+    ok = std::fclose(f) == 0 && ok;
+    return ok ? std::nullopt : std::make_optional(archive_error::IO_ERROR);
+}
+
+archive &archive::operator=(archive &&other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    if (this->mapping) {
+        ::munmap(this->mapping, this->mapping_size);
+    }
+
+    this->mapping = std::exchange(other.mapping, nullptr);
+    this->mapping_size = std::exchange(other.mapping_size, 0);
+    this->_sections = std::move(other._sections);
+    return *this;
+}
+
+archive::~archive() {
+    if (this->mapping) {
+        ::munmap(this->mapping, this->mapping_size);
+        this->mapping = nullptr;
+        this->mapping_size = 0;
+    }
+}
+
+result<archive, archive_error> archive::open(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return archive_error::IO_ERROR;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return archive_error::IO_ERROR;
+    }
+
+    void *p =
+        ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        return archive_error::IO_ERROR;
+    }
+
+    archive a;
+    a.mapping = p;
+    a.mapping_size = st.st_size;
+    if (const auto err =
+            a.parse(
+                std::span(static_cast<const uint8_t*>(p), a.mapping_size))) {
+        return *err;
+    }
+
+    return result<archive, archive_error>(std::move(a));
+}
+
+result<archive, archive_error> archive::view(std::span<const uint8_t> bytes) {
+    archive a;
+    if (const auto err = a.parse(bytes)) {
+        return *err;
+    }
+
+    return result<archive, archive_error>(std::move(a));
+}
+
+const archive::section *archive::find(std::string_view name) const {
+    for (const auto &s : this->_sections) {
+        if (s.name == name) {
+            return &s;
+        }
+    }
+
+    return nullptr;
+}
+
+std::optional<archive_error> archive::parse(std::span<const uint8_t> bytes) {
+    file_header header;
+    if (bytes.size() < sizeof(header)) {
+        return archive_error::BAD_ARCHIVE;
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != ARCHIVE_MAGIC
+            || header.version != ARCHIVE_VERSION
+            || header.size != bytes.size()
+            || header.num_sections
+                > (bytes.size() - sizeof(header)) / sizeof(file_section)) {
+        return archive_error::BAD_ARCHIVE;
+    }
+
+    // layouts are hashed once per type
+    map<type_id, uint64_t> hashes;
+
+    for (size_t i = 0; i < header.num_sections; i++) {
+        file_section fs;
+        std::memcpy(
+            &fs,
+            bytes.data() + sizeof(header) + (i * sizeof(file_section)),
+            sizeof(fs));
+
+        const auto *data = bytes.data() + fs.offset;
+        if (fs.name_offset > bytes.size()
+                || fs.name_size > bytes.size() - fs.name_offset
+                || fs.offset > bytes.size()
+                || fs.align == 0
+                || (fs.align & (fs.align - 1)) != 0
+                || reinterpret_cast<uintptr_t>(data) % fs.align != 0
+                || (fs.stride != 0
+                    && fs.count > (bytes.size() - fs.offset) / fs.stride)) {
+            return archive_error::BAD_ARCHIVE;
+        }
+
+        const auto id = type_id::from(fs.type_id);
+        const auto type = reflect(id);
+        if (!type) {
+            return archive_error::COULD_NOT_REFLECT;
+        }
+
+        auto it = hashes.find(id);
+        if (it == hashes.end()) {
+            const auto hash = layout_hash(id);
+            if (!hash) {
+                return hash.unwrap_error();
+            }
+
+            it = hashes.emplace(id, *hash).first;
+        }
+
+        if (it->second != fs.layout_hash
+                || fs.stride != type->size()
+                || fs.align != std::max<size_t>(type->align(), 1)) {
+            return archive_error::LAYOUT_MISMATCH;
+        }
+
+        this->_sections.push_back(
+            section {
+                .name =
+                    std::string_view(
+                        reinterpret_cast<const char*>(
+                            bytes.data() + fs.name_offset),
+                        fs.name_size),
+                .id = id,
+                .data = data,
+                .count = fs.count,
+                .stride = fs.stride
+            });
+    }
+
+    return std::nullopt;
+}
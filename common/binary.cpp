@@ -0,0 +1,652 @@
+#include <archimedes/binary.hpp>
+#include <archimedes/bits.hpp>
+#include <archimedes/members.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <string>
+
+using namespace archimedes;
+
+// std::string as u64 length + chars
+static const binary_codec string_codec = {
+    .write =
+        [](binary_writer &w, const void *p) {
+            const auto &s = *static_cast<const std::string*>(p);
+            w.write(static_cast<uint64_t>(s.size()));
+            w.write(s.data(), s.size());
+        },
+    .read =
+        [](binary_reader &r, void *p) {
+            auto &s = *static_cast<std::string*>(p);
+            uint64_t n = 0;
+            r.read(n);
+            if (!r.ok || r.buffer.size() - r.pos < n) {
+                r.ok = false;
+                return;
+            }
+            s.resize(n);
+            r.read(s.data(), n);
+        }
+};
+
+binary_serializer::binary_serializer() {
+    this->set_codec<std::string>(string_codec);
+}
+
+void binary_serializer::set_codec(type_id id, binary_codec codec) {
+    this->codecs[id] = codec;
+}
+
+// append a memcpy run to plan, merging with the previous run if they touch or
+// overlap (bit fields can share bytes)
+static void add_run(binary_plan &plan, size_t offset, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    if (!plan.ops.empty()) {
+        auto &last = plan.ops.back();
+        const auto end = last.offset + last.size;
+        if (!last.codec && offset >= last.offset && offset <= end) {
+            const auto new_end = std::max(end, offset + size);
+            plan.fixed_size += new_end - end;
+            last.size = new_end - last.offset;
+            return;
+        }
+    }
+
+    plan.ops.push_back(
+        binary_plan::op { .offset = offset, .size = size, .codec = nullptr });
+    plan.fixed_size += size;
+}
+
+std::optional<binary_error> binary_serializer::compile(
+    binary_plan &plan,
+    type_id id,
+    size_t offset) {
+    if (auto it = this->codecs.find(id); it != this->codecs.end()) {
+        plan.ops.push_back(
+            binary_plan::op {
+                .offset = offset,
+                .size = 0,
+                .codec = &it->second
+            });
+        plan.is_fixed_size = false;
+        return std::nullopt;
+    }
+
+    const auto opt_type = reflect(id);
+    if (!opt_type) {
+        return binary_error::COULD_NOT_REFLECT;
+    }
+
+    const auto &type = *opt_type;
+    if (type.is_numeric()) {
+        add_run(plan, offset, type.size());
+        return std::nullopt;
+    }
+
+    switch (type.kind()) {
+        case ARRAY: {
+            const auto array = type.as_array();
+            const auto elem = reflect(array.element_type_id());
+
+            if (elem
+                    && elem->is_numeric()
+                    && !this->codecs.contains(elem->id())) {
+                add_run(plan, offset, type.size());
+                return std::nullopt;
+            }
+
+            const auto stride =
+                array.length() == 0 ? 0 : type.size() / array.length();
+            for (size_t i = 0; i < array.length(); i++) {
+                if (const auto err =
+                        this->compile(
+                            plan,
+                            array.element_type_id(),
+                            offset + (i * stride))) {
+                    return err;
+                }
+            }
+
+            return std::nullopt;
+        }
+        case UNION: {
+            const auto record = type.as_record();
+            if (!record.has_trivial_copy_ctor()
+                    || !record.has_trivial_dtor()
+                    || type.size() == 0) {
+                return binary_error::UNSUPPORTED_TYPE;
+            }
+
+            add_run(plan, offset, type.size());
+            return std::nullopt;
+        }
+        case STRUCT:
+            break;
+        default:
+            return binary_error::UNSUPPORTED_TYPE;
+    }
+
+    const auto members = detail::record_members(type.as_record());
+    if (!members) {
+        return binary_error::UNSUPPORTED_TYPE;
+    }
+
+    for (const auto &m : *members) {
+        if (m.field.is_bit_field()) {
+            // copy all bytes containing the bit field
+            const auto
+                first = m.bit_position / 8,
+                last =
+                    (m.bit_position + *m.field.bit_field_size() + 7) / 8;
+            add_run(plan, offset + first, last - first);
+        } else if (const auto err =
+                this->compile(
+                    plan,
+                    m.field.field_type_id(),
+                    offset + (m.bit_position / 8))) {
+            return err;
+        }
+    }
+
+    return std::nullopt;
+}
+
+result<const binary_plan*, binary_error> binary_serializer::plan(type_id id) {
+    if (auto it = this->plans.find(id); it != this->plans.end()) {
+        return it->second.get();
+    }
+
+    auto plan = std::make_unique<binary_plan>();
+    plan->id = id;
+    if (const auto err = this->compile(*plan, id, 0)) {
+        return *err;
+    }
+
+    return this->plans.emplace(id, std::move(plan)).first->second.get();
+}
+
+void binary_serializer::write(
+    const binary_plan &plan,
+    const void *p,
+    binary_writer &w) {
+    const auto *data = static_cast<const uint8_t*>(p);
+    for (const auto &op : plan.ops) {
+        if (op.codec) {
+            op.codec->write(w, data + op.offset);
+        } else {
+            w.write(data + op.offset, op.size);
+        }
+    }
+}
+
+void binary_serializer::read(
+    const binary_plan &plan,
+    void *p,
+    binary_reader &r) {
+    auto *data = static_cast<uint8_t*>(p);
+    for (const auto &op : plan.ops) {
+        if (op.codec) {
+            op.codec->read(r, data + op.offset);
+        } else {
+            r.read(data + op.offset, op.size);
+        }
+    }
+}
+
+result<size_t, binary_error> binary_serializer::size_of(
+    type_id id,
+    const void *p) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    } else if ((*plan)->is_fixed_size) {
+        return (*plan)->fixed_size;
+    }
+
+    binary_writer w;
+    write(**plan, p, w);
+    return w.pos;
+}
+
+result<size_t, binary_error> binary_serializer::write(
+    type_id id,
+    const void *p,
+    std::span<uint8_t> out) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    // fixed size plans are checked once up front
+    const auto &pl = **plan;
+    if (pl.is_fixed_size) {
+        if (out.size() < pl.fixed_size) {
+            return binary_error::BUFFER_TOO_SMALL;
+        }
+
+        const auto *src = static_cast<const uint8_t*>(p);
+        auto *dst = out.data();
+        for (const auto &op : pl.ops) {
+            std::memcpy(dst, src + op.offset, op.size);
+            dst += op.size;
+        }
+
+        return pl.fixed_size;
+    }
+
+    binary_writer w { .buffer = out };
+    write(pl, p, w);
+    return w.ok ?
+        result<size_t, binary_error>(w.pos)
+        : result<size_t, binary_error>(binary_error::BUFFER_TOO_SMALL);
+}
+
+result<size_t, binary_error> binary_serializer::read(
+    type_id id,
+    void *p,
+    std::span<const uint8_t> in) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    const auto &pl = **plan;
+    if (pl.is_fixed_size) {
+        if (in.size() < pl.fixed_size) {
+            return binary_error::TRUNCATED;
+        }
+
+        auto *dst = static_cast<uint8_t*>(p);
+        const auto *src = in.data();
+        for (const auto &op : pl.ops) {
+            std::memcpy(dst + op.offset, src, op.size);
+            src += op.size;
+        }
+
+        return pl.fixed_size;
+    }
+
+    binary_reader r { .buffer = in };
+    read(pl, p, r);
+    return r.ok ?
+        result<size_t, binary_error>(r.pos)
+        : result<size_t, binary_error>(binary_error::TRUNCATED);
+}
+
+// "ARCB"
+static constexpr uint32_t SCHEMA_MAGIC = 0x42435241;
+
+// size of magic + id + fingerprint + field count
+static constexpr size_t SCHEMA_HEADER_SIZE = 4 + 8 + 8 + 4;
+
+// fnv-1a of n bytes at p onto h
+static uint64_t fnv_append(uint64_t h, const void *p, size_t n) {
+    const auto *q = static_cast<const uint8_t*>(p);
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ q[i]) * 1099511628211u;
+    }
+    return h;
+}
+
+static constexpr uint64_t FNV_BASIS = 14695981039346656037u;
+
+uint64_t binary_schema::hash(type_id id, std::span<const uint8_t> encoded) {
+    const uint64_t v = id.value();
+    return fnv_append(
+        fnv_append(FNV_BASIS, &v, sizeof(v)), encoded.data(), encoded.size());
+}
+
+// binary_schema::field::layout of type id, types with codecs are opaque
+static uint64_t hash_layout(
+    const map<type_id, binary_codec> &codecs,
+    type_id id) {
+    if (codecs.contains(id)) {
+        return 0;
+    }
+
+    const auto type = reflect(id);
+    if (!type) {
+        return 0;
+    } else if (type->kind() == ARRAY) {
+        return hash_layout(codecs, type->as_array().element_type_id());
+    } else if (type->kind() != STRUCT) {
+        return 0;
+    }
+
+    const auto members = detail::record_members(type->as_record());
+    if (!members) {
+        return 0;
+    }
+
+    uint64_t h = FNV_BASIS;
+    for (const auto &m : *members) {
+        const auto name = m.field.name();
+        const uint64_t values[] = {
+            m.bit_position,
+            m.field.is_bit_field() ? *m.field.bit_field_size() : 0,
+            m.field.field_type_id().value(),
+            hash_layout(codecs, m.field.field_type_id())
+        };
+        h = fnv_append(h, name.data(), name.size());
+        h = fnv_append(h, values, sizeof(values));
+    }
+
+    return h;
+}
+
+std::optional<binary_error> binary_serializer::compile_schema(
+    binary_schema &schema,
+    const reflected_record_type &type) {
+    const auto members = detail::record_members(type);
+    if (!members) {
+        return binary_error::UNSUPPORTED_TYPE;
+    }
+
+    for (const auto &m : *members) {
+        const auto &f = m.field;
+        auto &sf =
+            schema.fields.emplace_back(
+                binary_schema::field {
+                    .name = std::string(f.name()),
+                    .id = f.field_type_id(),
+                    .size = f.size()
+                });
+
+        if (f.is_bit_field()) {
+            sf.wire_size = sizeof(uint64_t);
+            sf.bit_size = *f.bit_field_size();
+            sf.offset = m.bit_position;
+            sf.is_signed = f.is_signed_bit_field();
+            schema.is_plain = false;
+            continue;
+        }
+
+        const auto plan = this->plan(sf.id);
+        if (!plan) {
+            return plan.unwrap_error();
+        }
+
+        sf.plan = *plan;
+        sf.layout = hash_layout(this->codecs, sf.id);
+        sf.offset = m.bit_position / 8;
+        sf.wire_size = sf.plan->is_fixed_size ? sf.plan->fixed_size : 0;
+        schema.is_plain &= sf.plan->is_fixed_size;
+    }
+
+    return std::nullopt;
+}
+
+result<const binary_schema*, binary_error> binary_serializer::schema(
+    type_id id) {
+    if (auto it = this->schemas.find(id); it != this->schemas.end()) {
+        return it->second.get();
+    }
+
+    const auto type = reflect(id);
+    if (!type) {
+        return binary_error::COULD_NOT_REFLECT;
+    } else if (type->kind() != STRUCT) {
+        return binary_error::UNSUPPORTED_TYPE;
+    }
+
+    auto schema = std::make_unique<binary_schema>();
+    schema->id = id;
+    if (const auto err = this->compile_schema(*schema, type->as_record())) {
+        return *err;
+    }
+
+    // per field: u16 name length, name, u64 type id, u32 size, u32 wire size,
+    // u32 bit size, u64 layout
+    auto &out = schema->encoded;
+    const auto append = [&](const void *p, size_t n) {
+        const auto *q = static_cast<const uint8_t*>(p);
+        out.insert(out.end(), q, q + n);
+    };
+
+    for (const auto &f : schema->fields) {
+        const auto name_size = static_cast<uint16_t>(f.name.size());
+        const uint64_t field_id = f.id.value();
+        const uint32_t
+            size = f.size,
+            wire_size = f.wire_size,
+            bit_size = f.bit_size;
+        append(&name_size, sizeof(name_size));
+        append(f.name.data(), name_size);
+        append(&field_id, sizeof(field_id));
+        append(&size, sizeof(size));
+        append(&wire_size, sizeof(wire_size));
+        append(&bit_size, sizeof(bit_size));
+        append(&f.layout, sizeof(f.layout));
+    }
+
+    schema->fingerprint = binary_schema::hash(id, schema->encoded);
+    return this->schemas.emplace(id, std::move(schema)).first->second.get();
+}
+
+result<size_t, binary_error> binary_serializer::write_schema(
+    type_id id,
+    std::span<uint8_t> out) {
+    const auto schema = this->schema(id);
+    if (!schema) {
+        return schema.unwrap_error();
+    }
+
+    const auto &s = **schema;
+    binary_writer w { .buffer = out };
+    w.write(SCHEMA_MAGIC);
+    w.write(static_cast<uint64_t>(id.value()));
+    w.write(s.fingerprint);
+    w.write(static_cast<uint32_t>(s.fields.size()));
+    w.write(s.encoded.data(), s.encoded.size());
+    return w.ok ?
+        result<size_t, binary_error>(w.pos)
+        : result<size_t, binary_error>(binary_error::BUFFER_TOO_SMALL);
+}
+
+result<const binary_mapping*, binary_error> binary_serializer::read_schema(
+    type_id id,
+    std::span<const uint8_t> in) {
+    binary_reader r { .buffer = in };
+    uint32_t magic = 0, num_fields = 0;
+    uint64_t written_id = 0, fingerprint = 0;
+    r.read(magic);
+    r.read(written_id);
+    r.read(fingerprint);
+    r.read(num_fields);
+
+    if (!r.ok) {
+        return binary_error::TRUNCATED;
+    } else if (magic != SCHEMA_MAGIC) {
+        return binary_error::BAD_SCHEMA;
+    } else if (written_id != id.value()) {
+        return binary_error::SCHEMA_MISMATCH;
+    }
+
+    if (auto it = this->mappings.find(fingerprint);
+            it != this->mappings.end()) {
+        if (it->second->schema->id != id) {
+            return binary_error::SCHEMA_MISMATCH;
+        } else if (in.size() < it->second->schema_size) {
+            return binary_error::TRUNCATED;
+        } else if (binary_schema::hash(
+                id,
+                in.subspan(
+                    SCHEMA_HEADER_SIZE,
+                    it->second->schema_size - SCHEMA_HEADER_SIZE))
+                    != fingerprint) {
+            return binary_error::BAD_SCHEMA;
+        }
+
+        return it->second.get();
+    }
+
+    const auto schema = this->schema(id);
+    if (!schema) {
+        return schema.unwrap_error();
+    }
+
+    const auto &current = **schema;
+    auto mapping = std::make_unique<binary_mapping>();
+    mapping->schema = &current;
+    mapping->fingerprint = fingerprint;
+
+    vector<bool> is_mapped(current.fields.size(), false);
+    for (uint32_t i = 0; i < num_fields; i++) {
+        uint16_t name_size = 0;
+        r.read(name_size);
+        if (!r.ok || r.buffer.size() - r.pos < name_size) {
+            return binary_error::TRUNCATED;
+        }
+
+        const auto name =
+            std::string_view(
+                reinterpret_cast<const char*>(in.data() + r.pos),
+                name_size);
+        r.skip(name_size);
+
+        uint64_t field_id = 0, layout = 0;
+        uint32_t size = 0, wire_size = 0, bit_size = 0;
+        r.read(field_id);
+        r.read(size);
+        r.read(wire_size);
+        r.read(bit_size);
+        r.read(layout);
+        if (!r.ok) {
+            return binary_error::TRUNCATED;
+        }
+
+        // same name, type and nested layout, bit fields may change width
+        const binary_schema::field *field = nullptr;
+        for (size_t j = 0; j < current.fields.size(); j++) {
+            const auto &f = current.fields[j];
+            if (!is_mapped[j]
+                    && f.name == name
+                    && f.id.value() == field_id
+                    && f.layout == layout
+                    && (f.bit_size != 0) == (bit_size != 0)
+                    && (bit_size != 0 || f.wire_size == wire_size)) {
+                field = &f;
+                is_mapped[j] = true;
+                break;
+            }
+        }
+
+        mapping->ops.push_back(
+            binary_mapping::op {
+                .field = field,
+                .wire_size = wire_size,
+                .is_bit_field = bit_size != 0
+            });
+    }
+
+    if (binary_schema::hash(
+            id,
+            in.subspan(SCHEMA_HEADER_SIZE, r.pos - SCHEMA_HEADER_SIZE))
+                != fingerprint) {
+        return binary_error::BAD_SCHEMA;
+    }
+
+    mapping->schema_size = r.pos;
+    mapping->is_identical = fingerprint == current.fingerprint;
+    mapping->has_missing =
+        std::find(is_mapped.begin(), is_mapped.end(), false)
+            != is_mapped.end();
+
+    return this->mappings.emplace(
+        fingerprint, std::move(mapping)).first->second.get();
+}
+
+result<size_t, binary_error> binary_serializer::write_versioned(
+    type_id id,
+    const void *p,
+    std::span<uint8_t> out) {
+    const auto schema = this->schema(id);
+    if (!schema) {
+        return schema.unwrap_error();
+    } else if ((*schema)->is_plain) {
+        return this->write(id, p, out);
+    }
+
+    const auto *data = static_cast<const uint8_t*>(p);
+    binary_writer w { .buffer = out };
+    for (const auto &f : (*schema)->fields) {
+        if (f.bit_size != 0) {
+            w.write(detail::load_bits(data, f.offset, f.bit_size, f.is_signed));
+        } else if (f.wire_size != 0) {
+            write(*f.plan, data + f.offset, w);
+        } else {
+            // length prefix, patched once the field is written
+            const auto start = w.pos;
+            w.write(uint32_t(0));
+            write(*f.plan, data + f.offset, w);
+            if (w.ok && out.data()) {
+                const auto n =
+                    static_cast<uint32_t>(w.pos - start - sizeof(uint32_t));
+                std::memcpy(out.data() + start, &n, sizeof(n));
+            }
+        }
+    }
+
+    return w.ok ?
+        result<size_t, binary_error>(w.pos)
+        : result<size_t, binary_error>(binary_error::BUFFER_TOO_SMALL);
+}
+
+result<size_t, binary_error> binary_serializer::read_versioned(
+    const binary_mapping &mapping,
+    void *p,
+    std::span<const uint8_t> in) {
+    const auto &schema = *mapping.schema;
+    if (mapping.is_identical && schema.is_plain) {
+        return this->read(schema.id, p, in);
+    }
+
+    if (mapping.has_missing) {
+        const auto *ops = reflect(schema.id)->ops();
+        if (ops && ops->construct) {
+            if (ops->destroy) {
+                ops->destroy(p);
+            }
+
+            ops->construct(p);
+        }
+    }
+
+    auto *data = static_cast<uint8_t*>(p);
+    binary_reader r { .buffer = in };
+    for (const auto &op : mapping.ops) {
+        uint32_t size = op.wire_size;
+        if (size == 0) {
+            r.read(size);
+        }
+
+        if (!r.ok || r.buffer.size() - r.pos < size) {
+            return binary_error::TRUNCATED;
+        }
+
+        if (!op.field) {
+            r.skip(size);
+        } else if (op.is_bit_field) {
+            uint64_t v = 0;
+            r.read(v);
+            detail::store_bits(data, op.field->offset, op.field->bit_size, v);
+        } else {
+            // read field from exactly its bytes
+            binary_reader s { .buffer = in.subspan(r.pos, size) };
+            read(*op.field->plan, data + op.field->offset, s);
+            if (!s.ok) {
+                return binary_error::TRUNCATED;
+            }
+
+            r.skip(size);
+        }
+    }
+
+    return r.ok ?
+        result<size_t, binary_error>(r.pos)
+        : result<size_t, binary_error>(binary_error::TRUNCATED);
+}
@@ -0,0 +1,451 @@
+#include <archimedes/compare.hpp>
+#include <archimedes/bits.hpp>
+#include <archimedes/members.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace archimedes;
+
+static constexpr uint64_t HASH_SEED = 0x9E3779B97F4A7C15u;
+
+static uint64_t hash_mix(uint64_t h, uint64_t v) {
+    h ^= v + HASH_SEED + (h << 6) + (h >> 2);
+    h *= 0xFF51AFD7ED558CCDu;
+    return h ^ (h >> 32);
+}
+
+static uint64_t load_u64(const uint8_t *p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// word at a time hash over bytes, four independent lanes for long runs
+static uint64_t hash_bytes(uint64_t h, const uint8_t *p, size_t n) {
+    h = hash_mix(h, n);
+
+    if (n >= 32) {
+        uint64_t a = h, b = h ^ 1, c = h ^ 2, d = h ^ 3;
+        for (; n >= 32; p += 32, n -= 32) {
+            a = hash_mix(a, load_u64(p));
+            b = hash_mix(b, load_u64(p + 8));
+            c = hash_mix(c, load_u64(p + 16));
+            d = hash_mix(d, load_u64(p + 24));
+        }
+
+        h = hash_mix(hash_mix(a, b), hash_mix(c, d));
+    }
+
+    for (; n >= 8; p += 8, n -= 8) {
+        h = hash_mix(h, load_u64(p));
+    }
+
+    if (n != 0) {
+        uint64_t v = 0;
+        std::memcpy(&v, p, n);
+        h = hash_mix(h, v);
+    }
+
+    return h;
+}
+
+static const compare_fns string_fns = {
+    .equals =
+        [](const void *a, const void *b) {
+            return *static_cast<const std::string*>(a)
+                == *static_cast<const std::string*>(b);
+        },
+    .hash =
+        [](const void *p) {
+            const auto &s = *static_cast<const std::string*>(p);
+            return hash_bytes(
+                0, reinterpret_cast<const uint8_t*>(s.data()), s.size());
+        }
+};
+
+object_comparer::object_comparer() {
+    this->set_compare<std::string>(string_fns);
+}
+
+void object_comparer::set_compare(type_id id, compare_fns fns) {
+    this->fns[id] = fns;
+}
+
+// append op, merging it into the last op if both are runs which touch. bit
+// runs are merged up to 64 bits so they can be loaded at once.
+static void add_op(vector<compare_plan::op> &ops, const compare_plan::op &op) {
+    if (op.size == 0
+            && (op.kind == compare_plan::op::BYTES
+                || op.kind == compare_plan::op::BITS)) {
+        return;
+    }
+
+    if (!ops.empty() && ops.back().kind == op.kind) {
+        auto &last = ops.back();
+        if (op.kind == compare_plan::op::BYTES
+                && op.offset == last.offset + last.size) {
+            last.size += op.size;
+            return;
+        } else if (op.kind == compare_plan::op::BITS
+                && op.offset == last.offset + last.size
+                && last.size + op.size <= 64) {
+            last.size += op.size;
+            return;
+        }
+    }
+
+    ops.push_back(op);
+}
+
+static compare_plan::op bytes_op(size_t offset, size_t size) {
+    return compare_plan::op {
+        .kind = compare_plan::op::BYTES,
+        .offset = offset,
+        .size = size
+    };
+}
+
+// operator==(const T&) of record, if reflected and invokable
+static std::optional<reflected_function> find_equals(
+    const reflected_record_type &record) {
+    for (const auto &f : record.functions()) {
+        if (f.name() == "operator=="
+                && !f.is_static()
+                && f.can_invoke()
+                && f.parameters().size() == 1) {
+            return f;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<compare_error> object_comparer::compile_record(
+    vector<compare_plan::op> &ops,
+    const reflected_record_type &record,
+    size_t offset) {
+    const auto members = detail::record_members(record);
+    if (!members) {
+        return compare_error::UNSUPPORTED_TYPE;
+    }
+
+    for (const auto &m : *members) {
+        if (m.field.is_bit_field()) {
+            add_op(
+                ops,
+                compare_plan::op {
+                    .kind = compare_plan::op::BITS,
+                    .offset = (offset * 8) + m.bit_position,
+                    .size = *m.field.bit_field_size()
+                });
+        } else if (const auto err =
+                this->compile(
+                    ops,
+                    m.field.field_type_id(),
+                    offset + (m.bit_position / 8))) {
+            return err;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<compare_error> object_comparer::compile(
+    vector<compare_plan::op> &ops,
+    type_id id,
+    size_t offset) {
+    if (auto it = this->fns.find(id); it != this->fns.end()) {
+        ops.push_back(
+            compare_plan::op {
+                .kind = compare_plan::op::CUSTOM,
+                .offset = offset,
+                .size = 0,
+                .fns = &it->second
+            });
+        return std::nullopt;
+    }
+
+    const auto opt_type = reflect(id);
+    if (!opt_type) {
+        return compare_error::COULD_NOT_REFLECT;
+    }
+
+    const auto &type = *opt_type;
+    if (type.is_numeric() || type.kind() == PTR) {
+        add_op(ops, bytes_op(offset, type.size()));
+        return std::nullopt;
+    }
+
+    switch (type.kind()) {
+        case ARRAY: {
+            const auto array = type.as_array();
+            const auto elem = reflect(array.element_type_id());
+
+            if (elem
+                    && elem->is_numeric()
+                    && !this->fns.contains(elem->id())) {
+                add_op(ops, bytes_op(offset, type.size()));
+                return std::nullopt;
+            }
+
+            const auto stride =
+                array.length() == 0 ? 0 : type.size() / array.length();
+            for (size_t i = 0; i < array.length(); i++) {
+                if (const auto err =
+                        this->compile(
+                            ops,
+                            array.element_type_id(),
+                            offset + (i * stride))) {
+                    return err;
+                }
+            }
+
+            return std::nullopt;
+        }
+        case UNION: {
+            const auto record = type.as_record();
+            if (!record.has_trivial_copy_ctor() || !record.has_trivial_dtor()) {
+                break;
+            }
+
+            add_op(ops, bytes_op(offset, type.size()));
+            return std::nullopt;
+        }
+        case STRUCT: {
+            vector<compare_plan::op> record_ops;
+            const auto err =
+                this->compile_record(record_ops, type.as_record(), offset);
+            if (!err) {
+                for (const auto &op : record_ops) {
+                    add_op(ops, op);
+                }
+
+                return std::nullopt;
+            }
+
+            break;
+        }
+        default:
+            return compare_error::UNSUPPORTED_TYPE;
+    }
+
+    // record which cannot be compared member by member
+    const auto member = find_equals(type.as_record());
+    if (!member) {
+        return compare_error::UNSUPPORTED_TYPE;
+    }
+
+    ops.push_back(
+        compare_plan::op {
+            .kind = compare_plan::op::MEMBER,
+            .offset = offset,
+            .size = type.size(),
+            .member = member,
+            .id = id
+        });
+    return std::nullopt;
+}
+
+result<const compare_plan*, compare_error> object_comparer::plan(type_id id) {
+    if (auto it = this->plans.find(id); it != this->plans.end()) {
+        return it->second.get();
+    }
+
+    auto plan = std::make_unique<compare_plan>();
+    plan->id = id;
+
+    // fields of records are diffed separately
+    const auto type =
+        this->fns.contains(id) ? std::nullopt : reflect(id);
+    const auto members =
+        type && type->kind() == STRUCT ?
+            detail::record_members(type->as_record())
+            : std::nullopt;
+    bool is_split = members.has_value();
+
+    if (is_split) {
+        for (const auto &m : *members) {
+            auto &field =
+                plan->fields.emplace_back(
+                    compare_plan::field {
+                        .name = std::string(m.field.name()),
+                        .first_op = plan->field_ops.size(),
+                        .num_ops = 0
+                    });
+
+            vector<compare_plan::op> ops;
+            if (m.field.is_bit_field()) {
+                add_op(
+                    ops,
+                    compare_plan::op {
+                        .kind = compare_plan::op::BITS,
+                        .offset = m.bit_position,
+                        .size = *m.field.bit_field_size()
+                    });
+            } else if (this->compile(
+                    ops, m.field.field_type_id(), m.bit_position / 8)) {
+                is_split = false;
+                break;
+            }
+
+            field.num_ops = ops.size();
+            plan->field_ops.insert(
+                plan->field_ops.end(), ops.begin(), ops.end());
+        }
+    }
+
+    if (!is_split) {
+        // one field for the whole value
+        plan->fields.clear();
+        plan->field_ops.clear();
+        if (const auto err = this->compile(plan->field_ops, id, 0)) {
+            return *err;
+        }
+
+        plan->fields.push_back(
+            compare_plan::field {
+                .name = "",
+                .first_op = 0,
+                .num_ops = plan->field_ops.size()
+            });
+    }
+
+    for (const auto &op : plan->field_ops) {
+        add_op(plan->ops, op);
+        plan->is_fully_hashed =
+            plan->is_fully_hashed && op.kind != compare_plan::op::MEMBER;
+    }
+
+    return this->plans.emplace(id, std::move(plan)).first->second.get();
+}
+
+static bool op_equals(
+    const compare_plan::op &op,
+    const uint8_t *a,
+    const uint8_t *b) {
+    switch (op.kind) {
+        case compare_plan::op::BYTES:
+            return std::memcmp(a + op.offset, b + op.offset, op.size) == 0;
+        case compare_plan::op::BITS:
+            return detail::load_bits(a, op.offset, op.size, false)
+                == detail::load_bits(b, op.offset, op.size, false);
+        case compare_plan::op::CUSTOM:
+            return op.fns->equals(a + op.offset, b + op.offset);
+        case compare_plan::op::MEMBER: {
+            any args[2] = {
+                any::make(const_cast<uint8_t*>(a + op.offset), op.id),
+                any::make_reference_from_ptr(
+                    const_cast<uint8_t*>(b + op.offset), op.id)
+            };
+            const auto res = op.member->invoke_with(std::span<any>(args));
+            return res && res->as<bool>();
+        }
+    }
+
+    return false;
+}
+
+bool object_comparer::equals(
+    const compare_plan &plan,
+    const void *a,
+    const void *b) {
+    const auto
+        *pa = static_cast<const uint8_t*>(a),
+        *pb = static_cast<const uint8_t*>(b);
+    for (const auto &op : plan.ops) {
+        if (!op_equals(op, pa, pb)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint64_t object_comparer::hash(const compare_plan &plan, const void *p) {
+    const auto *bytes = static_cast<const uint8_t*>(p);
+    uint64_t h = hash_mix(HASH_SEED, plan.id.value());
+    for (const auto &op : plan.ops) {
+        switch (op.kind) {
+            case compare_plan::op::BYTES:
+                h = hash_bytes(h, bytes + op.offset, op.size);
+                break;
+            case compare_plan::op::BITS:
+                h = hash_mix(
+                    h, detail::load_bits(bytes, op.offset, op.size, false));
+                break;
+            case compare_plan::op::CUSTOM:
+                h = hash_mix(h, op.fns->hash(bytes + op.offset));
+                break;
+            case compare_plan::op::MEMBER:
+                break;
+        }
+    }
+
+    return h;
+}
+
+size_t object_comparer::diff(
+    const compare_plan &plan,
+    const void *a,
+    const void *b,
+    std::span<uint64_t> mask) {
+    const auto
+        *pa = static_cast<const uint8_t*>(a),
+        *pb = static_cast<const uint8_t*>(b);
+    std::fill(mask.begin(), mask.begin() + plan.mask_size(), 0);
+
+    size_t n = 0;
+    for (size_t i = 0; i < plan.fields.size(); i++) {
+        const auto &f = plan.fields[i];
+        for (size_t j = 0; j < f.num_ops; j++) {
+            if (!op_equals(plan.field_ops[f.first_op + j], pa, pb)) {
+                mask[i / 64] |= uint64_t(1) << (i % 64);
+                n++;
+                break;
+            }
+        }
+    }
+
+    return n;
+}
+
+result<bool, compare_error> object_comparer::equals(
+    type_id id,
+    const void *a,
+    const void *b) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    return object_comparer::equals(**plan, a, b);
+}
+
+result<uint64_t, compare_error> object_comparer::hash(
+    type_id id,
+    const void *p) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    return object_comparer::hash(**plan, p);
+}
+
+result<size_t, compare_error> object_comparer::diff(
+    type_id id,
+    const void *a,
+    const void *b,
+    std::span<uint64_t> mask) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    } else if (mask.size() < (*plan)->mask_size()) {
+        return compare_error::BUFFER_TOO_SMALL;
+    }
+
+    return object_comparer::diff(**plan, a, b, mask);
+}
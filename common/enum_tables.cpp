@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <archimedes/enum_tables.hpp>
+
+using namespace archimedes::detail;
+
+// maximum size of dense lookup tables
+static constexpr size_t MAX_DENSE_SIZE = 4096;
+
+// displacements tried per bucket before picking a new hash seed
+static constexpr uint32_t MAX_DISPLACEMENT = 1 << 16;
+
+// seeds tried before giving up on the hash table, by_name then scans entries
+static constexpr uint64_t MAX_SEEDS = 64;
+
+enum_tables enum_tables::build(
+    std::span<const entry> enumerators,
+    std::uintmax_t value_mask,
+    bool is_signed) {
+    enum_tables t;
+    t.value_mask = value_mask;
+    t.is_signed = is_signed;
+    t.entries.assign(enumerators.begin(), enumerators.end());
+    for (auto &e : t.entries) {
+        e.value &= value_mask;
+    }
+
+    std::stable_sort(
+        t.entries.begin(),
+        t.entries.end(),
+        [](const auto &a, const auto &b) { return a.value < b.value; });
+
+    if (t.entries.empty()) {
+        return t;
+    }
+
+    // distinct values and their range, comparing as the enum's integer type
+    // would such that fx. [-1, 1] is contiguous
+    const auto as_signed =
+        [&](std::uintmax_t v) -> std::intmax_t {
+            return t.from_bits<std::intmax_t>(v);
+        };
+
+    size_t num_values = 0;
+    std::intmax_t min = 0, max = 0;
+    std::uintmax_t single_bits = 0;
+    size_t num_single_bits = 0;
+    bool all_made_of_bits = true;
+    for (size_t i = 0; i < t.entries.size(); i++) {
+        const auto v = t.entries[i].value;
+        if (i != 0 && v == t.entries[i - 1].value) {
+            continue;
+        }
+
+        const auto s = is_signed ? as_signed(v) : static_cast<std::intmax_t>(v);
+        min = num_values == 0 ? s : std::min(min, s);
+        max = num_values == 0 ? s : std::max(max, s);
+        num_values++;
+
+        if (std::popcount(v) == 1) {
+            single_bits |= v;
+            num_single_bits++;
+        }
+    }
+
+    for (const auto &e : t.entries) {
+        if (e.value & ~single_bits) {
+            all_made_of_bits = false;
+        }
+    }
+
+    // dense if the range is at most half empty
+    const auto range =
+        static_cast<std::uintmax_t>(max) - static_cast<std::uintmax_t>(min) + 1;
+    if (range != 0
+            && range <= MAX_DENSE_SIZE
+            && range <= std::max<std::uintmax_t>(2 * num_values, 8)) {
+        t.dense_min = static_cast<std::uintmax_t>(min) & value_mask;
+        t.dense.assign(range, NO_ENTRY);
+        for (size_t i = 0; i < t.entries.size(); i++) {
+            auto &slot = t.dense[(t.entries[i].value - t.dense_min) & value_mask];
+            if (slot == NO_ENTRY) {
+                slot = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    // flags if built out of at least two single bits, and not just a
+    // contiguous run of values (0, 1, 2, 3, ...)
+    if (num_single_bits >= 2
+            && all_made_of_bits
+            && !(num_values >= 3 && range == num_values)) {
+        for (size_t i = 0; i < t.entries.size(); i++) {
+            const auto v = t.entries[i].value;
+            if (std::popcount(v) == 1
+                    && (i == 0 || v != t.entries[i - 1].value)) {
+                t.flags.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    // hash and displace: names are split into buckets by one hash, then each
+    // bucket (largest first) is assigned a displacement which places all of
+    // its names in free slots
+    const auto n = t.entries.size();
+    t.hash_slots.resize(std::bit_ceil(n + n / 2));
+    t.hash_displacements.resize(std::bit_ceil(std::max<size_t>(n / 2, 1)));
+
+    vector<uint64_t> hashes(n);
+    vector<vector<uint32_t>> buckets(t.hash_displacements.size());
+    vector<size_t> placed;
+    for (uint64_t seed = 0; seed < MAX_SEEDS; seed++) {
+        t.hash_seed = seed;
+        std::fill(t.hash_slots.begin(), t.hash_slots.end(), NO_ENTRY);
+        std::fill(
+            t.hash_displacements.begin(), t.hash_displacements.end(), 0);
+        for (auto &b : buckets) {
+            b.clear();
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            hashes[i] = hash(t.entries[i].name, seed);
+            buckets[t.bucket(hashes[i])].push_back(static_cast<uint32_t>(i));
+        }
+
+        vector<size_t> order(buckets.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+
+        std::stable_sort(
+            order.begin(),
+            order.end(),
+            [&](size_t a, size_t b) {
+                return buckets[a].size() > buckets[b].size();
+            });
+
+        bool ok = true;
+        for (const auto b : order) {
+            if (buckets[b].empty()) {
+                break;
+            }
+
+            bool found = false;
+            for (uint32_t d = 0; d < MAX_DISPLACEMENT && !found; d++) {
+                placed.clear();
+                found = true;
+                for (const auto i : buckets[b]) {
+                    const auto s = t.slot(hashes[i], d);
+                    if (t.hash_slots[s] != NO_ENTRY) {
+                        found = false;
+                        break;
+                    }
+
+                    t.hash_slots[s] = i;
+                    placed.push_back(s);
+                }
+
+                if (!found) {
+                    for (const auto s : placed) {
+                        t.hash_slots[s] = NO_ENTRY;
+                    }
+                } else {
+                    t.hash_displacements[b] = d;
+                }
+            }
+
+            if (!found) {
+                ok = false;
+                break;
+            }
+        }
+
+        if (ok) {
+            return t;
+        }
+    }
+
+    // no perfect hash (fx. duplicate names), fall back to linear search
+    t.hash_seed = 0;
+    t.hash_slots.clear();
+    t.hash_displacements.clear();
+    return t;
+}
@@ -0,0 +1,273 @@
+#include <archimedes/factory.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+using namespace archimedes;
+
+object_pool::object_pool(
+    const reflected_type &type,
+    std::pmr::memory_resource *resource,
+    size_t objects_per_slab)
+    : _type(type),
+      ops(type.ops()),
+      resource(resource),
+      objects_per_slab(std::max<size_t>(objects_per_slab, 1)),
+      slabs(resource) {
+    if (!this->ops || !this->ops->construct) {
+        ARCHIMEDES_FAIL("object_pool type has no default ctor");
+    }
+
+    // free slots store a pointer to the next free slot
+    this->alignment = std::max(type.align(), alignof(void*));
+    this->_stride =
+        std::max(
+            (type.size() + this->alignment - 1) & ~(this->alignment - 1),
+            sizeof(void*));
+}
+
+object_pool::~object_pool() {
+    this->release();
+}
+
+void *object_pool::create() {
+    if (!this->free_list) {
+        this->grow(this->objects_per_slab);
+    }
+
+    void *p = this->free_list;
+    std::memcpy(&this->free_list, p, sizeof(void*));
+
+    auto *s = this->find_slab(p);
+    const auto i = (static_cast<uint8_t*>(p) - s->data) / this->_stride;
+    s->live[i / 64] |= uint64_t(1) << (i % 64);
+    this->num_live++;
+
+    this->ops->construct(p);
+    return p;
+}
+
+void object_pool::create_n(std::span<void*> out) {
+    // allocate everything up front so one burst needs at most one slab
+    const auto n_free = this->num_slots - this->num_live;
+    if (out.size() > n_free) {
+        this->grow(std::max(out.size() - n_free, this->objects_per_slab));
+    }
+
+    for (auto &p : out) {
+        p = this->create();
+    }
+}
+
+void object_pool::destroy(void *p) {
+    if (!this->owns(p)) {
+        ARCHIMEDES_FAIL("object_pool::destroy of object not in pool");
+        return;
+    }
+
+    auto *s = this->find_slab(p);
+    const auto i = (static_cast<uint8_t*>(p) - s->data) / this->_stride;
+
+    if (this->ops->destroy) {
+        this->ops->destroy(p);
+    }
+
+    s->live[i / 64] &= ~(uint64_t(1) << (i % 64));
+    std::memcpy(p, &this->free_list, sizeof(void*));
+    this->free_list = p;
+    this->num_live--;
+}
+
+void object_pool::destroy_n(std::span<void *const> ps) {
+    for (auto *p : ps) {
+        this->destroy(p);
+    }
+}
+
+void object_pool::clear() {
+    // rebuild free list from scratch, destroying everything live on the way
+    this->free_list = nullptr;
+    for (auto it = this->slabs.rbegin(); it != this->slabs.rend(); ++it) {
+        auto &s = *it;
+        for (size_t i = s.count; i-- > 0;) {
+            void *p = s.data + (i * this->_stride);
+            auto &word = s.live[i / 64];
+            const auto bit = uint64_t(1) << (i % 64);
+            if ((word & bit) && this->ops->destroy) {
+                this->ops->destroy(p);
+            }
+
+            word &= ~bit;
+            std::memcpy(p, &this->free_list, sizeof(void*));
+            this->free_list = p;
+        }
+    }
+
+    this->num_live = 0;
+}
+
+void object_pool::release() {
+    this->clear();
+
+    for (auto &s : this->slabs) {
+        this->resource->deallocate(
+            s.data, s.count * this->_stride, this->alignment);
+    }
+
+    this->slabs.clear();
+    this->free_list = nullptr;
+    this->num_slots = 0;
+}
+
+bool object_pool::owns(const void *p) const {
+    const auto *s = this->find_slab(p);
+    if (!s) {
+        return false;
+    }
+
+    const auto offset = static_cast<const uint8_t*>(p) - s->data;
+    const auto i = offset / this->_stride;
+    return offset % this->_stride == 0
+        && (s->live[i / 64] & (uint64_t(1) << (i % 64)));
+}
+
+object_pool::slab *object_pool::find_slab(const void *p) {
+    return const_cast<slab*>(std::as_const(*this).find_slab(p));
+}
+
+const object_pool::slab *object_pool::find_slab(const void *p) const {
+    const auto *q = static_cast<const uint8_t*>(p);
+
+    // first slab starting after p, p is in the one before it (if any)
+    auto it =
+        std::upper_bound(
+            this->slabs.begin(),
+            this->slabs.end(),
+            q,
+            [](const uint8_t *q, const slab &s) {
+                return std::less<const uint8_t*>()(q, s.data);
+            });
+
+    if (it == this->slabs.begin()) {
+        return nullptr;
+    }
+
+    --it;
+    return q < it->data + (it->count * this->_stride) ? &*it : nullptr;
+}
+
+void object_pool::grow(size_t count) {
+    auto *data =
+        static_cast<uint8_t*>(
+            this->resource->allocate(count * this->_stride, this->alignment));
+
+    // keep slabs sorted by address for find_slab
+    auto it =
+        std::upper_bound(
+            this->slabs.begin(),
+            this->slabs.end(),
+            data,
+            [](const uint8_t *q, const slab &s) {
+                return std::less<const uint8_t*>()(q, s.data);
+            });
+    this->slabs.insert(
+        it,
+        slab {
+            .data = data,
+            .count = count,
+            .live =
+                std::pmr::vector<uint64_t>((count + 63) / 64, this->resource)
+        });
+
+    // push in reverse so objects are handed out in address order
+    for (size_t i = count; i-- > 0;) {
+        void *p = data + (i * this->_stride);
+        std::memcpy(p, &this->free_list, sizeof(void*));
+        this->free_list = p;
+    }
+
+    this->num_slots += count;
+}
+
+result<object_pool*, factory_error> object_factory::pool(type_id id) {
+    if (auto it = this->pools.find(id); it != this->pools.end()) {
+        return it->second.get();
+    }
+
+    const auto type = reflect(id);
+    if (!type) {
+        return factory_error::COULD_NOT_REFLECT;
+    } else if (!type->is_record() || type->size() == 0) {
+        return factory_error::INVALID_TYPE;
+    } else if (!type->ops() || !type->ops()->construct) {
+        return factory_error::NO_DEFAULT_CTOR;
+    }
+
+    return this->pools.emplace(
+        id,
+        std::make_unique<object_pool>(
+            *type,
+            this->resource,
+            this->objects_per_slab)).first->second.get();
+}
+
+result<object_pool*, factory_error> object_factory::pool(
+    std::string_view name) {
+    const auto type = reflect(name);
+    return type ?
+        this->pool(type->id())
+        : result<object_pool*, factory_error>(
+            factory_error::COULD_NOT_REFLECT);
+}
+
+result<void*, factory_error> object_factory::create(type_id id) {
+    auto p = this->pool(id);
+    return p ?
+        result<void*, factory_error>((*p)->create())
+        : result<void*, factory_error>(p.unwrap_error());
+}
+
+result<void*, factory_error> object_factory::create(std::string_view name) {
+    auto p = this->pool(name);
+    return p ?
+        result<void*, factory_error>((*p)->create())
+        : result<void*, factory_error>(p.unwrap_error());
+}
+
+result<object_pool*, factory_error> object_factory::create_n(
+    type_id id,
+    std::span<void*> out) {
+    auto p = this->pool(id);
+    if (p) {
+        (*p)->create_n(out);
+    }
+    return p;
+}
+
+void object_factory::destroy(type_id id, void *p) {
+    auto it = this->pools.find(id);
+    if (it == this->pools.end()) {
+        ARCHIMEDES_FAIL("object_factory::destroy of unknown type");
+        return;
+    }
+
+    it->second->destroy(p);
+}
+
+void object_factory::destroy_n(type_id id, std::span<void *const> ps) {
+    auto it = this->pools.find(id);
+    if (it == this->pools.end()) {
+        ARCHIMEDES_FAIL("object_factory::destroy_n of unknown type");
+        return;
+    }
+
+    it->second->destroy_n(ps);
+}
+
+void object_factory::clear() {
+    for (auto &[_, p] : this->pools) {
+        p->clear();
+    }
+}
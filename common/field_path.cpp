@@ -0,0 +1,174 @@
+#include <archimedes/field_path.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <charconv>
+
+using namespace archimedes;
+
+// bases and vbases of record
+static vector<reflected_base> all_bases(const reflected_record_type &record) {
+    auto bases = record.bases();
+    for (const auto &v : record.vbases()) {
+        if (std::none_of(
+                bases.begin(),
+                bases.end(),
+                [&](const auto &b) {
+                    return b.type().id() == v.type().id();
+                })) {
+            bases.push_back(v);
+        }
+    }
+    return bases;
+}
+
+// add hop into base b to path
+static void hop(field_path &path, const reflected_base &b) {
+    if (b.is_virtual() || b.is_vbase()) {
+        path.steps.push_back(field_path::step { path.offset, b });
+        path.offset = 0;
+    } else {
+        path.offset += b.offset();
+    }
+}
+
+// true if name is the (possibly qualified) name of type
+static bool names_type(
+    const reflected_record_type &type,
+    std::string_view name) {
+    const auto n = type.name();
+    return n == name
+        || (n.size() > name.size() + 2
+            && n.ends_with(name)
+            && n.substr(n.size() - name.size() - 2, 2) == "::");
+}
+
+// find field name in record or (recursively) its bases, adding base hops to
+// path if found
+static std::optional<reflected_field> find_field(
+    const reflected_record_type &record,
+    std::string_view name,
+    field_path &path) {
+    for (const auto &f : record.fields()) {
+        if (f.name() == name) {
+            return f;
+        }
+    }
+
+    for (const auto &b : all_bases(record)) {
+        const auto offset = path.offset;
+        const auto num_steps = path.steps.size();
+        hop(path, b);
+
+        if (auto f = find_field(b.type(), name, path)) {
+            return f;
+        }
+
+        path.offset = offset;
+        path.steps.resize(num_steps);
+    }
+
+    return std::nullopt;
+}
+
+result<field_path, path_error> archimedes::compile_path(
+    type_id id,
+    std::string_view path) {
+    field_path out;
+    out.root = id;
+    out.leaf = id;
+
+    if (path.empty()) {
+        return path_error::SYNTAX;
+    }
+
+    while (true) {
+        const auto dot = path.find('.');
+        auto segment = path.substr(0, dot);
+        path = dot == std::string_view::npos ? "" : path.substr(dot + 1);
+
+        const auto bracket = segment.find('[');
+        const auto name = segment.substr(0, bracket);
+        auto indices =
+            bracket == std::string_view::npos ?
+                std::string_view()
+                : segment.substr(bracket);
+
+        if (name.empty()) {
+            return path_error::SYNTAX;
+        } else if (out.is_bit_field()) {
+            return path_error::NOT_A_RECORD;
+        }
+
+        const auto type = reflect(out.leaf);
+        if (!type) {
+            return path_error::COULD_NOT_REFLECT;
+        } else if (!type->is_record()) {
+            return path_error::NOT_A_RECORD;
+        }
+
+        const auto record = type->as_record();
+        if (const auto field = find_field(record, name, out)) {
+            out.leaf = field->field_type_id();
+            if (field->is_bit_field()) {
+                out.bits = *field->bit_accessor();
+            } else {
+                out.offset += field->offset();
+            }
+        } else {
+            // explicit hop into base
+            const auto bases = all_bases(record);
+            const auto it =
+                std::find_if(
+                    bases.begin(),
+                    bases.end(),
+                    [&](const auto &b) { return names_type(b.type(), name); });
+            if (it == bases.end()) {
+                return path_error::NO_SUCH_FIELD;
+            }
+
+            hop(out, *it);
+            out.leaf = it->type().id();
+        }
+
+        // array indices
+        while (!indices.empty()) {
+            const auto close = indices.find(']');
+            if (indices[0] != '[' || close == std::string_view::npos) {
+                return path_error::SYNTAX;
+            }
+
+            size_t index = 0;
+            const auto
+                *first = indices.data() + 1,
+                *last = indices.data() + close;
+            const auto [end, ec] = std::from_chars(first, last, index);
+            if (first == last || ec != std::errc() || end != last) {
+                return path_error::SYNTAX;
+            }
+
+            indices = indices.substr(close + 1);
+
+            const auto array = reflect(out.leaf);
+            if (!array) {
+                return path_error::COULD_NOT_REFLECT;
+            } else if (array->kind() != ARRAY || out.is_bit_field()) {
+                return path_error::NOT_AN_ARRAY;
+            }
+
+            const auto length = array->as_array().length();
+            if (index >= length) {
+                return path_error::OUT_OF_RANGE;
+            }
+
+            out.offset += index * (array->size() / length);
+            out.leaf = array->as_array().element_type_id();
+        }
+
+        if (dot == std::string_view::npos) {
+            break;
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,369 @@
+#include <archimedes/gather.hpp>
+#include <archimedes.hpp>
+
+#include <cstring>
+#include <limits>
+
+#if !defined(ARCHIMEDES_NO_SIMD) \
+    && defined(__x86_64__) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define ARCHIMEDES_GATHER_X86
+#include <immintrin.h>
+#endif
+
+using namespace archimedes;
+
+namespace {
+// field as seen by the kernels
+struct column {
+    // offset of field, of the record if bit field
+    size_t offset;
+
+    // size of one value in the packed buffer
+    size_t size;
+
+    // if bit field, accessor for it
+    bit_field_accessor bits = {};
+};
+
+// gather/scatter of count values at p (stride bytes apart) to/from a packed
+// buffer
+using gather_fn =
+    void (*)(const uint8_t *p, size_t stride, size_t count, uint8_t *out);
+
+struct kernels {
+    simd_level level;
+    gather_fn gather4, gather8;
+};
+} // namespace
+
+template <size_t N>
+static void gather_scalar(
+    const uint8_t *p,
+    size_t stride,
+    size_t count,
+    uint8_t *out) {
+    for (size_t i = 0; i < count; i++, p += stride, out += N) {
+        std::memcpy(out, p, N);
+    }
+}
+
+template <size_t N>
+static void scatter_scalar(
+    uint8_t *p,
+    size_t stride,
+    size_t count,
+    const uint8_t *in) {
+    for (size_t i = 0; i < count; i++, p += stride, in += N) {
+        std::memcpy(p, in, N);
+    }
+}
+
+#ifdef ARCHIMEDES_GATHER_X86
+static uint32_t load_u32(const uint8_t *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t load_u64(const uint8_t *p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// sse2 has no gather, but assembling lanes in registers saves the stores
+static void gather4_sse2(
+    const uint8_t *p,
+    size_t stride,
+    size_t count,
+    uint8_t *out) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, p += 4 * stride, out += 16) {
+        const auto v =
+            _mm_set_epi32(
+                load_u32(p + (3 * stride)),
+                load_u32(p + (2 * stride)),
+                load_u32(p + stride),
+                load_u32(p));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+    }
+
+    gather_scalar<4>(p, stride, count - i, out);
+}
+
+static void gather8_sse2(
+    const uint8_t *p,
+    size_t stride,
+    size_t count,
+    uint8_t *out) {
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, p += 2 * stride, out += 16) {
+        const auto v = _mm_set_epi64x(load_u64(p + stride), load_u64(p));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+    }
+
+    gather_scalar<8>(p, stride, count - i, out);
+}
+
+// lane offsets are 32 bit, so strides must be small enough that the last lane
+// fits. falls back to sse2 otherwise.
+__attribute__((target("avx2")))
+static void gather4_avx2(
+    const uint8_t *p,
+    size_t stride,
+    size_t count,
+    uint8_t *out) {
+    if (stride > size_t(std::numeric_limits<int32_t>::max() / 7)) {
+        gather4_sse2(p, stride, count, out);
+        return;
+    }
+
+    const auto s = static_cast<int32_t>(stride);
+    const auto index =
+        _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, p += 8 * stride, out += 32) {
+        const auto v =
+            _mm256_i32gather_epi32(
+                reinterpret_cast<const int*>(p), index, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+    }
+
+    gather4_sse2(p, stride, count - i, out);
+}
+
+__attribute__((target("avx2")))
+static void gather8_avx2(
+    const uint8_t *p,
+    size_t stride,
+    size_t count,
+    uint8_t *out) {
+    if (stride > size_t(std::numeric_limits<int32_t>::max() / 3)) {
+        gather8_sse2(p, stride, count, out);
+        return;
+    }
+
+    const auto s = static_cast<int32_t>(stride);
+    const auto index = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, p += 4 * stride, out += 32) {
+        const auto v =
+            _mm256_i32gather_epi64(
+                reinterpret_cast<const long long*>(p), index, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+    }
+
+    gather8_sse2(p, stride, count - i, out);
+}
+#endif
+
+// kernels of level, or of the best supported level below it
+static kernels select_kernels(simd_level level) {
+#ifdef ARCHIMEDES_GATHER_X86
+    __builtin_cpu_init();
+    if (level >= simd_level::AVX2 && __builtin_cpu_supports("avx2")) {
+        return kernels { simd_level::AVX2, gather4_avx2, gather8_avx2 };
+    } else if (level >= simd_level::SSE2) {
+        return kernels { simd_level::SSE2, gather4_sse2, gather8_sse2 };
+    }
+#endif
+    return kernels { simd_level::SCALAR, gather_scalar<4>, gather_scalar<8> };
+}
+
+static kernels &get_kernels() {
+    static kernels ks = select_kernels(simd_level::AVX2);
+    return ks;
+}
+
+simd_level archimedes::gather_simd_level() {
+    return get_kernels().level;
+}
+
+simd_level archimedes::detail::set_gather_simd_level(simd_level level) {
+    get_kernels() = select_kernels(level);
+    return get_kernels().level;
+}
+
+// offset of record base in type, nullopt if it is not type or one of its
+// non-virtual bases
+static std::optional<size_t> base_offset(
+    const reflected_record_type &type,
+    type_id base) {
+    if (type.id() == base) {
+        return 0;
+    }
+
+    for (const auto &b : type.bases()) {
+        if (b.is_virtual()) {
+            continue;
+        } else if (const auto offset = base_offset(b.type(), base)) {
+            return b.offset() + *offset;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<gather_error> archimedes::detail::check_field_of(
+    const reflected_field &field,
+    type_id type) {
+    const auto t = reflect(type);
+    if (!t) {
+        return gather_error::COULD_NOT_REFLECT;
+    } else if (!t->is_record()) {
+        return gather_error::WRONG_TYPE;
+    }
+
+    const auto offset = base_offset(t->as_record(), field.parent().id());
+    return offset && *offset == 0 ?
+        std::nullopt : std::make_optional(gather_error::WRONG_TYPE);
+}
+
+// true if values of type can be copied bytewise
+static bool is_bytewise(const reflected_type &type) {
+    if (type.is_numeric()
+            || type.kind() == PTR
+            || type.kind() == MEMBER_PTR) {
+        return true;
+    } else if (type.is_array()) {
+        const auto elem = reflect(type.as_array().element_type_id());
+        return elem && is_bytewise(*elem);
+    } else if (type.is_record()) {
+        return type.ops() && type.ops()->is_trivial;
+    }
+
+    return false;
+}
+
+static result<column, gather_error> make_column(const reflected_field &field) {
+    const auto type = reflect(field.field_type_id());
+    if (!type) {
+        return gather_error::COULD_NOT_REFLECT;
+    } else if (!is_bytewise(*type) || type->size() == 0) {
+        return gather_error::UNSUPPORTED_TYPE;
+    }
+
+    column c = { .offset = 0, .size = type->size() };
+    if (field.is_bit_field()) {
+        c.bits = *field.bit_accessor();
+    } else {
+        c.offset = field.offset();
+    }
+    return c;
+}
+
+result<size_t, gather_error> archimedes::column_size(
+    const reflected_field &field) {
+    const auto c = make_column(field);
+    if (!c) {
+        return c.unwrap_error();
+    }
+    return c->size;
+}
+
+result<size_t, gather_error> archimedes::gather(
+    const reflected_field &field,
+    const void *objects,
+    size_t stride,
+    size_t count,
+    void *out) {
+    const auto res = make_column(field);
+    if (!res) {
+        return res.unwrap_error();
+    }
+
+    const auto &c = *res;
+    const auto *p = static_cast<const uint8_t*>(objects) + c.offset;
+    auto *q = static_cast<uint8_t*>(out);
+
+    if (c.bits.is_valid()) {
+        switch (c.size) {
+            case 1: c.bits.load_n(p, stride, count, q); break;
+            case 2:
+                c.bits.load_n(p, stride, count, reinterpret_cast<uint16_t*>(q));
+                break;
+            case 4:
+                c.bits.load_n(p, stride, count, reinterpret_cast<uint32_t*>(q));
+                break;
+            default:
+                c.bits.load_n(p, stride, count, reinterpret_cast<uint64_t*>(q));
+        }
+        return count;
+    }
+
+    // packed array of just this field
+    if (stride == c.size) {
+        std::memcpy(q, p, count * c.size);
+        return count;
+    }
+
+    switch (c.size) {
+        case 1: gather_scalar<1>(p, stride, count, q); break;
+        case 2: gather_scalar<2>(p, stride, count, q); break;
+        case 4: get_kernels().gather4(p, stride, count, q); break;
+        case 8: get_kernels().gather8(p, stride, count, q); break;
+        default:
+            for (size_t i = 0; i < count; i++, p += stride, q += c.size) {
+                std::memcpy(q, p, c.size);
+            }
+    }
+
+    return count;
+}
+
+// NOTE: avx2 has no scatter instruction, stores are scalar at every
+// simd_level
+result<size_t, gather_error> archimedes::scatter(
+    const reflected_field &field,
+    void *objects,
+    size_t stride,
+    size_t count,
+    const void *in) {
+    const auto res = make_column(field);
+    if (!res) {
+        return res.unwrap_error();
+    }
+
+    const auto &c = *res;
+    auto *p = static_cast<uint8_t*>(objects) + c.offset;
+    const auto *q = static_cast<const uint8_t*>(in);
+
+    if (c.bits.is_valid()) {
+        switch (c.size) {
+            case 1: c.bits.store_n(p, stride, count, q); break;
+            case 2:
+                c.bits.store_n(
+                    p, stride, count, reinterpret_cast<const uint16_t*>(q));
+                break;
+            case 4:
+                c.bits.store_n(
+                    p, stride, count, reinterpret_cast<const uint32_t*>(q));
+                break;
+            default:
+                c.bits.store_n(
+                    p, stride, count, reinterpret_cast<const uint64_t*>(q));
+        }
+        return count;
+    }
+
+    if (stride == c.size) {
+        std::memcpy(p, q, count * c.size);
+        return count;
+    }
+
+    switch (c.size) {
+        case 1: scatter_scalar<1>(p, stride, count, q); break;
+        case 2: scatter_scalar<2>(p, stride, count, q); break;
+        case 4: scatter_scalar<4>(p, stride, count, q); break;
+        case 8: scatter_scalar<8>(p, stride, count, q); break;
+        default:
+            for (size_t i = 0; i < count; i++, p += stride, q += c.size) {
+                std::memcpy(p, q, c.size);
+            }
+    }
+
+    return count;
+}
@@ -0,0 +1,70 @@
+#include <archimedes.hpp>
+
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+
+namespace archimedes {
+namespace detail {
+void registry::assign_invoke_stats() {
+    const auto assign =
+        [this](function_type_info &f) {
+            if (!f.invoker) {
+                return;
+            }
+
+            auto &stats = this->invoke_stats_by_invoker[f.invoker];
+            if (!stats) {
+                stats = std::make_unique<invoke_stats>();
+            }
+
+            f.stats = stats.get();
+        };
+
+    for (auto &[_, t] : this->types_by_id) {
+        for (auto &[_, fos] : t.record.functions) {
+            for (auto &f : fos.functions) {
+                assign(f);
+            }
+        }
+    }
+
+    for (auto &[_, fs] : this->functions_by_type) {
+        for (auto &f : fs) {
+            assign(f);
+        }
+    }
+
+    for (auto &[_, sets] : this->functions_by_name) {
+        for (auto &fos : sets) {
+            for (auto &f : fos.functions) {
+                assign(f);
+            }
+        }
+    }
+}
+
+invoke_result invoke_instrumented(
+    const function_type_info &f,
+    std::span<any> args) {
+    // not loaded through the registry, nothing to record into
+    if (!f.stats) {
+        return f.invoker(args);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = f.invoker(args);
+    const auto time = std::chrono::steady_clock::now() - start;
+
+    const auto n = f.stats->calls.fetch_add(1, std::memory_order_relaxed);
+    f.stats->record(time);
+
+    const auto &r = registry::instance();
+    if (r.hook && r.hook_period != 0 && n % r.hook_period == 0) {
+        r.hook(reflected_function(&f), result, time);
+    }
+
+    return result;
+}
+} // namespace detail
+} // namespace archimedes
+
+#endif
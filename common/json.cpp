@@ -0,0 +1,831 @@
+#include <archimedes/json.hpp>
+#include <archimedes/bits.hpp>
+#include <archimedes/members.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+using namespace archimedes;
+
+// escape s as a json string onto out
+static void write_string(std::string &out, std::string_view s) {
+    out += '"';
+
+    size_t start = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        const auto c = static_cast<uint8_t>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        out.append(s.data() + start, i - start);
+        start = i + 1;
+
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                char buf[7] = "\\u00";
+                buf[4] = "0123456789abcdef"[c >> 4];
+                buf[5] = "0123456789abcdef"[c & 0xF];
+                out.append(buf, 6);
+            }
+        }
+    }
+
+    out.append(s.data() + start, s.size() - start);
+    out += '"';
+}
+
+template <typename T>
+static void write_number(std::string &out, T t) {
+    char buf[64];
+    const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), t);
+    out.append(buf, end);
+}
+
+static int64_t load_signed(const uint8_t *p, size_t size) {
+    switch (size) {
+        case 1: { int8_t v; std::memcpy(&v, p, 1); return v; }
+        case 2: { int16_t v; std::memcpy(&v, p, 2); return v; }
+        case 4: { int32_t v; std::memcpy(&v, p, 4); return v; }
+        default: { int64_t v; std::memcpy(&v, p, 8); return v; }
+    }
+}
+
+// write scalar (BOOL/SIGNED/UNSIGNED/ENUM) of plan with bits v
+static void write_bits(
+    const json_plan &plan,
+    uint64_t v,
+    std::string &out) {
+    switch (plan.kind) {
+        case json_plan::BOOL:
+            out += v ? "true" : "false";
+            break;
+        case json_plan::SIGNED:
+            write_number(out, static_cast<int64_t>(v));
+            break;
+        case json_plan::UNSIGNED:
+            write_number(out, v);
+            break;
+        case json_plan::ENUM: {
+            const auto &e = *plan.enum_type;
+            char buf[256];
+            if (const auto name = e.name_of(v)) {
+                write_string(out, *name);
+            } else if (e.is_flags()) {
+                if (const auto s = e.format_flags(v, buf)) {
+                    write_string(out, *s);
+                } else {
+                    write_number(out, v);
+                }
+            } else if (plan.is_signed_enum) {
+                write_number(
+                    out,
+                    load_signed(
+                        reinterpret_cast<const uint8_t*>(&v), plan.size));
+            } else {
+                write_number(out, v);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void write_value(
+    const json_plan &plan,
+    const uint8_t *p,
+    std::string &out) {
+    switch (plan.kind) {
+        case json_plan::BOOL:
+            out += *p ? "true" : "false";
+            break;
+        case json_plan::SIGNED:
+            write_number(out, load_signed(p, plan.size));
+            break;
+        case json_plan::UNSIGNED:
+            write_number(out, detail::load_uint(p, plan.size));
+            break;
+        case json_plan::FLOAT:
+            if (plan.size == sizeof(float)) {
+                float f;
+                std::memcpy(&f, p, sizeof(f));
+                if (std::isfinite(f)) {
+                    write_number(out, f);
+                } else {
+                    out += "null";
+                }
+            } else {
+                double d;
+                std::memcpy(&d, p, sizeof(d));
+                if (std::isfinite(d)) {
+                    write_number(out, d);
+                } else {
+                    out += "null";
+                }
+            }
+            break;
+        case json_plan::ENUM:
+            write_bits(plan, detail::load_uint(p, plan.size), out);
+            break;
+        case json_plan::STRING:
+            write_string(out, *reinterpret_cast<const std::string*>(p));
+            break;
+        case json_plan::CHARS: {
+            const auto *s = reinterpret_cast<const char*>(p);
+            write_string(out, std::string_view(s, strnlen(s, plan.length)));
+            break;
+        }
+        case json_plan::ARRAY:
+            out += '[';
+            for (size_t i = 0; i < plan.length; i++) {
+                if (i != 0) {
+                    out += ',';
+                }
+
+                write_value(*plan.element, p + (i * plan.stride), out);
+            }
+            out += ']';
+            break;
+        case json_plan::RECORD:
+            out += '{';
+            for (size_t i = 0; i < plan.fields.size(); i++) {
+                const auto &f = plan.fields[i];
+                if (i != 0) {
+                    out += ',';
+                }
+
+                out += f.key;
+                if (f.bit_size != 0) {
+                    write_bits(
+                        *f.plan,
+                        detail::load_bits(
+                            p,
+                            f.offset,
+                            f.bit_size,
+                            f.plan->kind == json_plan::SIGNED
+                                || f.plan->is_signed_enum),
+                        out);
+                } else {
+                    write_value(*f.plan, p + f.offset, out);
+                }
+            }
+            out += '}';
+            break;
+    }
+}
+
+namespace {
+struct json_reader {
+    std::string_view in;
+    size_t pos = 0;
+    std::string &scratch;
+
+    void skip_ws() {
+        while (this->pos < this->in.size()
+                && (this->in[this->pos] == ' '
+                    || this->in[this->pos] == '\n'
+                    || this->in[this->pos] == '\r'
+                    || this->in[this->pos] == '\t')) {
+            this->pos++;
+        }
+    }
+
+    // next non-whitespace character, 0 if at end
+    char peek() {
+        this->skip_ws();
+        return this->pos < this->in.size() ? this->in[this->pos] : '\0';
+    }
+
+    bool consume(char c) {
+        if (this->peek() != c) {
+            return false;
+        }
+
+        this->pos++;
+        return true;
+    }
+
+    bool consume_literal(std::string_view s) {
+        this->skip_ws();
+        if (this->in.substr(this->pos, s.size()) != s) {
+            return false;
+        }
+
+        this->pos += s.size();
+        return true;
+    }
+
+    // parse string into out, which views in if the string has no escapes and
+    // scratch otherwise
+    std::optional<json_error> parse_string(std::string_view &out) {
+        if (!this->consume('"')) {
+            return json_error::SYNTAX;
+        }
+
+        const auto start = this->pos;
+        while (this->pos < this->in.size()
+                && this->in[this->pos] != '"'
+                && this->in[this->pos] != '\\') {
+            this->pos++;
+        }
+
+        if (this->pos == this->in.size()) {
+            return json_error::SYNTAX;
+        } else if (this->in[this->pos] == '"') {
+            out = this->in.substr(start, this->pos - start);
+            this->pos++;
+            return std::nullopt;
+        }
+
+        this->scratch.assign(this->in.data() + start, this->pos - start);
+        while (this->pos < this->in.size() && this->in[this->pos] != '"') {
+            const auto c = this->in[this->pos++];
+            if (c != '\\') {
+                this->scratch += c;
+                continue;
+            } else if (this->pos == this->in.size()) {
+                return json_error::SYNTAX;
+            }
+
+            switch (this->in[this->pos++]) {
+                case '"': this->scratch += '"'; break;
+                case '\\': this->scratch += '\\'; break;
+                case '/': this->scratch += '/'; break;
+                case 'b': this->scratch += '\b'; break;
+                case 'f': this->scratch += '\f'; break;
+                case 'n': this->scratch += '\n'; break;
+                case 'r': this->scratch += '\r'; break;
+                case 't': this->scratch += '\t'; break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!this->parse_hex4(cp)) {
+                        return json_error::SYNTAX;
+                    }
+
+                    // surrogate pair
+                    if (cp >= 0xD800 && cp < 0xDC00) {
+                        uint32_t lo = 0;
+                        if (!this->consume_literal("\\u")
+                                || !this->parse_hex4(lo)
+                                || lo < 0xDC00
+                                || lo >= 0xE000) {
+                            return json_error::SYNTAX;
+                        }
+
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    }
+
+                    this->append_utf8(cp);
+                    break;
+                }
+                default:
+                    return json_error::SYNTAX;
+            }
+        }
+
+        if (this->pos == this->in.size()) {
+            return json_error::SYNTAX;
+        }
+
+        this->pos++;
+        out = this->scratch;
+        return std::nullopt;
+    }
+
+    bool parse_hex4(uint32_t &cp) {
+        if (this->in.size() - this->pos < 4) {
+            return false;
+        }
+
+        const auto *first = this->in.data() + this->pos;
+        const auto [end, ec] = std::from_chars(first, first + 4, cp, 16);
+        if (ec != std::errc() || end != first + 4) {
+            return false;
+        }
+
+        this->pos += 4;
+        return true;
+    }
+
+    void append_utf8(uint32_t cp) {
+        if (cp < 0x80) {
+            this->scratch += char(cp);
+        } else if (cp < 0x800) {
+            this->scratch += char(0xC0 | (cp >> 6));
+            this->scratch += char(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            this->scratch += char(0xE0 | (cp >> 12));
+            this->scratch += char(0x80 | ((cp >> 6) & 0x3F));
+            this->scratch += char(0x80 | (cp & 0x3F));
+        } else {
+            this->scratch += char(0xF0 | (cp >> 18));
+            this->scratch += char(0x80 | ((cp >> 12) & 0x3F));
+            this->scratch += char(0x80 | ((cp >> 6) & 0x3F));
+            this->scratch += char(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // characters of a json number
+    std::string_view parse_number() {
+        this->skip_ws();
+        const auto start = this->pos;
+        while (this->pos < this->in.size()
+                && std::strchr("+-.eE0123456789", this->in[this->pos])
+                && this->in[this->pos] != '\0') {
+            this->pos++;
+        }
+
+        return this->in.substr(start, this->pos - start);
+    }
+
+    // skip any value
+    std::optional<json_error> skip_value() {
+        std::string_view s;
+        switch (this->peek()) {
+            case '"':
+                return this->parse_string(s);
+            case '{':
+                this->pos++;
+                if (this->consume('}')) {
+                    return std::nullopt;
+                }
+
+                do {
+                    if (const auto err = this->parse_string(s)) {
+                        return err;
+                    } else if (!this->consume(':')) {
+                        return json_error::SYNTAX;
+                    } else if (const auto err = this->skip_value()) {
+                        return err;
+                    }
+                } while (this->consume(','));
+
+                return this->consume('}') ?
+                    std::nullopt : std::make_optional(json_error::SYNTAX);
+            case '[':
+                this->pos++;
+                if (this->consume(']')) {
+                    return std::nullopt;
+                }
+
+                do {
+                    if (const auto err = this->skip_value()) {
+                        return err;
+                    }
+                } while (this->consume(','));
+
+                return this->consume(']') ?
+                    std::nullopt : std::make_optional(json_error::SYNTAX);
+            case 't':
+                return this->consume_literal("true") ?
+                    std::nullopt : std::make_optional(json_error::SYNTAX);
+            case 'f':
+                return this->consume_literal("false") ?
+                    std::nullopt : std::make_optional(json_error::SYNTAX);
+            case 'n':
+                return this->consume_literal("null") ?
+                    std::nullopt : std::make_optional(json_error::SYNTAX);
+            default:
+                return this->parse_number().empty() ?
+                    std::make_optional(json_error::SYNTAX) : std::nullopt;
+        }
+    }
+
+    // parse integer which must fit in bits, sign extended into v
+    std::optional<json_error> parse_integer(
+        uint64_t &v,
+        size_t bits,
+        bool is_signed) {
+        const auto s = this->parse_number();
+        if (s.empty()) {
+            return json_error::TYPE_MISMATCH;
+        }
+
+        if (is_signed) {
+            int64_t i = 0;
+            const auto [end, ec] =
+                std::from_chars(s.data(), s.data() + s.size(), i);
+            if (ec == std::errc::result_out_of_range) {
+                return json_error::OUT_OF_RANGE;
+            } else if (ec != std::errc() || end != s.data() + s.size()) {
+                return json_error::TYPE_MISMATCH;
+            } else if (bits < 64
+                    && (i < -(int64_t(1) << (bits - 1))
+                        || i >= (int64_t(1) << (bits - 1)))) {
+                return json_error::OUT_OF_RANGE;
+            }
+
+            v = static_cast<uint64_t>(i);
+        } else {
+            const auto [end, ec] =
+                std::from_chars(s.data(), s.data() + s.size(), v);
+            if (ec == std::errc::result_out_of_range
+                    || (!s.empty() && s[0] == '-')) {
+                return json_error::OUT_OF_RANGE;
+            } else if (ec != std::errc() || end != s.data() + s.size()) {
+                return json_error::TYPE_MISMATCH;
+            } else if (bits < 64 && v >= (uint64_t(1) << bits)) {
+                return json_error::OUT_OF_RANGE;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // parse enum names ("A", "A|B" for flags, "0x10" for unnamed bits)
+    std::optional<json_error> parse_enum_names(
+        const json_plan &plan,
+        uint64_t &v) {
+        std::string_view s;
+        if (const auto err = this->parse_string(s)) {
+            return err;
+        }
+
+        const auto &e = *plan.enum_type;
+        v = 0;
+        while (!s.empty()) {
+            const auto sep =
+                e.is_flags() ? s.find('|') : std::string_view::npos;
+            auto name = s.substr(0, sep);
+            s = sep == std::string_view::npos ? "" : s.substr(sep + 1);
+
+            if (const auto value = e.value_of<uint64_t>(name)) {
+                v |= *value;
+            } else if (name.starts_with("0x")) {
+                uint64_t bits = 0;
+                const auto [end, ec] =
+                    std::from_chars(
+                        name.data() + 2, name.data() + name.size(), bits, 16);
+                if (ec != std::errc() || end != name.data() + name.size()) {
+                    return json_error::UNKNOWN_ENUM_VALUE;
+                }
+
+                v |= bits;
+            } else {
+                return json_error::UNKNOWN_ENUM_VALUE;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // parse BOOL/SIGNED/UNSIGNED/ENUM of plan into bits v, fitting in bits
+    std::optional<json_error> parse_bits(
+        const json_plan &plan,
+        uint64_t &v,
+        size_t bits) {
+        switch (plan.kind) {
+            case json_plan::BOOL:
+                if (this->consume_literal("true")) {
+                    v = 1;
+                } else if (this->consume_literal("false")) {
+                    v = 0;
+                } else {
+                    return json_error::TYPE_MISMATCH;
+                }
+                return std::nullopt;
+            case json_plan::SIGNED:
+                return this->parse_integer(v, bits, true);
+            case json_plan::UNSIGNED:
+                return this->parse_integer(v, bits, false);
+            case json_plan::ENUM:
+                return this->peek() == '"' ?
+                    this->parse_enum_names(plan, v)
+                    : this->parse_integer(v, bits, plan.is_signed_enum);
+            default:
+                return json_error::TYPE_MISMATCH;
+        }
+    }
+
+    std::optional<json_error> read_value(const json_plan &plan, uint8_t *p) {
+        if (this->peek() == 'n') {
+            return this->consume_literal("null") ?
+                std::nullopt : std::make_optional(json_error::SYNTAX);
+        }
+
+        switch (plan.kind) {
+            case json_plan::BOOL:
+            case json_plan::SIGNED:
+            case json_plan::UNSIGNED:
+            case json_plan::ENUM: {
+                uint64_t v = 0;
+                if (const auto err = this->parse_bits(plan, v, plan.size * 8)) {
+                    return err;
+                }
+
+                detail::store_uint(p, plan.size, v);
+                return std::nullopt;
+            }
+            case json_plan::FLOAT: {
+                const auto s = this->parse_number();
+                const auto *end = s.data() + s.size();
+                std::from_chars_result r;
+                if (plan.size == sizeof(float)) {
+                    float f = 0.0f;
+                    r = std::from_chars(s.data(), end, f);
+                    std::memcpy(p, &f, sizeof(f));
+                } else {
+                    double d = 0.0;
+                    r = std::from_chars(s.data(), end, d);
+                    std::memcpy(p, &d, sizeof(d));
+                }
+
+                if (r.ec == std::errc::result_out_of_range) {
+                    return json_error::OUT_OF_RANGE;
+                }
+
+                return s.empty() || r.ec != std::errc() || r.ptr != end ?
+                    std::make_optional(json_error::TYPE_MISMATCH)
+                    : std::nullopt;
+            }
+            case json_plan::STRING:
+            case json_plan::CHARS: {
+                if (this->peek() != '"') {
+                    return json_error::TYPE_MISMATCH;
+                }
+
+                std::string_view s;
+                if (const auto err = this->parse_string(s)) {
+                    return err;
+                }
+
+                if (plan.kind == json_plan::STRING) {
+                    reinterpret_cast<std::string*>(p)->assign(s);
+                } else if (s.size() > plan.length) {
+                    return json_error::OUT_OF_RANGE;
+                } else {
+                    std::memcpy(p, s.data(), s.size());
+                    std::memset(p + s.size(), 0, plan.length - s.size());
+                }
+
+                return std::nullopt;
+            }
+            case json_plan::ARRAY: {
+                if (!this->consume('[')) {
+                    return json_error::TYPE_MISMATCH;
+                } else if (this->consume(']')) {
+                    return std::nullopt;
+                }
+
+                size_t i = 0;
+                do {
+                    if (i == plan.length) {
+                        return json_error::OUT_OF_RANGE;
+                    } else if (const auto err =
+                            this->read_value(
+                                *plan.element, p + (i * plan.stride))) {
+                        return err;
+                    }
+
+                    i++;
+                } while (this->consume(','));
+
+                return this->consume(']') ?
+                    std::nullopt : std::make_optional(json_error::SYNTAX);
+            }
+            case json_plan::RECORD:
+                return this->read_record(plan, p);
+        }
+
+        return json_error::UNSUPPORTED_TYPE;
+    }
+
+    std::optional<json_error> read_record(const json_plan &plan, uint8_t *p) {
+        if (!this->consume('{')) {
+            return json_error::TYPE_MISMATCH;
+        } else if (this->consume('}')) {
+            return std::nullopt;
+        }
+
+        // keys usually come in the order they were written, try the next field
+        // before looking up by name
+        size_t next = 0;
+        do {
+            std::string_view key;
+            if (const auto err = this->parse_string(key)) {
+                return err;
+            } else if (!this->consume(':')) {
+                return json_error::SYNTAX;
+            }
+
+            const json_plan::field *f = nullptr;
+            if (next < plan.fields.size() && plan.fields[next].name == key) {
+                f = &plan.fields[next];
+            } else if (const auto it = plan.field_indices.find(key);
+                    it != plan.field_indices.end()) {
+                f = &plan.fields[it->second];
+            }
+
+            if (!f) {
+                if (const auto err = this->skip_value()) {
+                    return err;
+                }
+
+                continue;
+            }
+
+            next = (f - plan.fields.data()) + 1;
+
+            if (f->bit_size == 0) {
+                if (const auto err =
+                        this->read_value(*f->plan, p + f->offset)) {
+                    return err;
+                }
+
+                continue;
+            } else if (this->peek() == 'n') {
+                if (!this->consume_literal("null")) {
+                    return json_error::SYNTAX;
+                }
+
+                continue;
+            }
+
+            uint64_t v = 0;
+            if (const auto err = this->parse_bits(*f->plan, v, f->bit_size)) {
+                return err;
+            }
+
+            detail::store_bits(p, f->offset, f->bit_size, v);
+        } while (this->consume(','));
+
+        return this->consume('}') ?
+            std::nullopt : std::make_optional(json_error::SYNTAX);
+    }
+};
+} // namespace
+
+result<const json_plan*, json_error> json_serializer::plan(type_id id) {
+    if (auto it = this->plans.find(id); it != this->plans.end()) {
+        return it->second.get();
+    }
+
+    auto plan = std::make_unique<json_plan>();
+    plan->id = id;
+
+    // std::string is usually not reflected
+    if (id == type_id::from<std::string>()) {
+        plan->kind = json_plan::STRING;
+        plan->size = sizeof(std::string);
+        return this->plans.emplace(id, std::move(plan)).first->second.get();
+    }
+
+    const auto type = reflect(id);
+    if (!type) {
+        return json_error::COULD_NOT_REFLECT;
+    }
+
+    plan->size = type->size();
+    switch (type->kind()) {
+        case BOOL:
+            plan->kind = json_plan::BOOL;
+            break;
+        case CHAR:
+        case U_CHAR:
+        case U_SHORT:
+        case U_INT:
+        case U_LONG:
+        case U_LONG_LONG:
+        case I_CHAR:
+        case I_SHORT:
+        case I_INT:
+        case I_LONG:
+        case I_LONG_LONG:
+            plan->kind =
+                detail::is_signed_kind(type->kind()) ?
+                    json_plan::SIGNED : json_plan::UNSIGNED;
+            break;
+        case FLOAT:
+        case DOUBLE:
+            if (plan->size != sizeof(float) && plan->size != sizeof(double)) {
+                return json_error::UNSUPPORTED_TYPE;
+            }
+
+            plan->kind = json_plan::FLOAT;
+            break;
+        case ENUM:
+            plan->kind = json_plan::ENUM;
+            plan->enum_type = type->as_enum();
+            plan->is_signed_enum =
+                detail::is_signed_kind(type->as_enum().base_type().type().kind());
+            break;
+        case ARRAY: {
+            const auto array = type->as_array();
+            const auto element = this->plan(array.element_type_id());
+            if (!element) {
+                return element.unwrap_error();
+            }
+
+            plan->kind =
+                array.element_type_id() == type_id::from<char>() ?
+                    json_plan::CHARS : json_plan::ARRAY;
+            plan->element = *element;
+            plan->length = array.length();
+            plan->stride =
+                plan->length == 0 ? 0 : plan->size / plan->length;
+            break;
+        }
+        case STRUCT: {
+            plan->kind = json_plan::RECORD;
+            const auto members = detail::record_members(type->as_record());
+            if (!members) {
+                return json_error::UNSUPPORTED_TYPE;
+            }
+
+            for (const auto &m : *members) {
+                const auto field_plan = this->plan(m.field.field_type_id());
+                if (!field_plan) {
+                    return field_plan.unwrap_error();
+                }
+
+                auto &jf =
+                    plan->fields.emplace_back(
+                        json_plan::field {
+                            .name = std::string(m.field.name()),
+                            .key = "",
+                            .offset = m.bit_position / 8,
+                            .bit_size = 0,
+                            .plan = *field_plan
+                        });
+
+                if (m.field.is_bit_field()) {
+                    const auto kind = jf.plan->kind;
+                    if (kind != json_plan::BOOL
+                            && kind != json_plan::SIGNED
+                            && kind != json_plan::UNSIGNED
+                            && kind != json_plan::ENUM) {
+                        return json_error::UNSUPPORTED_TYPE;
+                    }
+
+                    jf.offset = m.bit_position;
+                    jf.bit_size = *m.field.bit_field_size();
+                }
+            }
+
+            // shadowed names would be duplicate keys, first one wins
+            vector<json_plan::field> fields;
+            for (auto &f : plan->fields) {
+                if (std::none_of(
+                        fields.begin(),
+                        fields.end(),
+                        [&](const auto &g) { return g.name == f.name; })) {
+                    fields.push_back(std::move(f));
+                }
+            }
+
+            plan->fields = std::move(fields);
+            for (size_t i = 0; i < plan->fields.size(); i++) {
+                auto &f = plan->fields[i];
+                write_string(f.key, f.name);
+                f.key += ':';
+                plan->field_indices[f.name] = i;
+            }
+            break;
+        }
+        default:
+            return json_error::UNSUPPORTED_TYPE;
+    }
+
+    return this->plans.emplace(id, std::move(plan)).first->second.get();
+}
+
+std::optional<json_error> json_serializer::write(
+    type_id id,
+    const void *p,
+    std::string &out) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    write_value(**plan, static_cast<const uint8_t*>(p), out);
+    return std::nullopt;
+}
+
+result<size_t, json_error> json_serializer::read(
+    type_id id,
+    void *p,
+    std::string_view in) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    json_reader r { .in = in, .pos = 0, .scratch = this->scratch };
+    if (const auto err = r.read_value(**plan, static_cast<uint8_t*>(p))) {
+        return *err;
+    }
+
+    return r.pos;
+}
@@ -15,6 +15,7 @@ void registry::load() {
 
     this->_loaded = true;
 
+    const auto start = std::chrono::steady_clock::now();
     for (const auto &l : this->loaders) {
         l();
     }
@@ -27,6 +28,14 @@ void registry::load() {
 
         this->types_by_type_id_hashes[t.type_id_hash] = &t;
     }
+
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+    this->assign_invoke_stats();
+#endif
+
+    if (this->collect_load_stats) {
+        this->load_time = std::chrono::steady_clock::now() - start;
+    }
 }
 
 vector<const type_info*> registry::find_by_annotations(
@@ -101,7 +110,7 @@ std::optional<const type_info*> registry::type_from_name(
 std::optional<const vector<function_overload_set>*> registry::function_by_name(
     std::string_view name) const {
     auto expanded = expand_namespaces(name);
-    auto it = this->functions_by_name.find(std::string(expanded));
+    auto it = this->functions_by_name.find(expanded);
     return it == this->functions_by_name.end() ?
         std::nullopt
         : std::make_optional(&it->second);
@@ -119,28 +128,72 @@ void registry::set_collision_callback(collision_callback &&tcc) {
     this->tcc = tcc;
 }
 
+// load invokers for function set, I(index) -> invoker_ptr
+template <typename I>
+static void load_invokers(function_overload_set &fos, I &&invoker) {
+    for (auto &f : fos.functions) {
+        if (f.invoker_index != NO_ARRAY_INDEX) {
+            f.invoker = invoker(f.invoker_index);
+        }
+    }
+}
+
+// patch indexed values (dyncasts, constexpr values, invokers, template
+// parameter values) of a deserialized type, each functor maps an index to its
+// value in the module the type was loaded from
+template <typename D, typename C, typename I, typename P>
+static void patch_type(
+    type_info &t,
+    D &&dyncast,
+    C &&constexpr_value,
+    I &&invoker,
+    P &&template_param_value) {
+    if (t.kind != STRUCT && t.kind != UNION) {
+        return;
+    }
+
+    for (auto &p : t.record.template_parameters) {
+        if (p.value_index != NO_ARRAY_INDEX) {
+            p.value = template_param_value(p.value_index);
+        }
+    }
+
+    for (auto &b : t.record.bases) {
+        if (b.dyncast_down_index != NO_ARRAY_INDEX) {
+            b.dyncast_down = dyncast(b.dyncast_down_index);
+        }
+
+        if (b.dyncast_up_index != NO_ARRAY_INDEX) {
+            b.dyncast_up = dyncast(b.dyncast_up_index);
+        }
+    }
+
+    for (auto &[_, f] : t.record.static_fields) {
+        if (f.constexpr_value_index != NO_ARRAY_INDEX) {
+            f.constexpr_value = constexpr_value(f.constexpr_value_index);
+        }
+    }
+
+    for (auto &[_, fos] : t.record.functions) {
+        load_invokers(fos, invoker);
+    }
+}
+
 static void load_module_internal(
     registry &registry,
+    std::string_view name,
     const vector<std::function<void*(void*)>> &dyncasts,
     const vector<any> &constexpr_values,
     const vector<invoker_ptr> &invokers,
     const vector<any> &template_param_values,
     const vector<size_t> &type_id_hashes,
+    const vector<const value_ops*> &ops,
+    std::span<const uint8_t> strings_data,
     std::span<const uint8_t> functions_data,
     std::span<const uint8_t> types_data,
     std::span<const uint8_t> typedefs_data,
     std::span<const uint8_t> aliases_data,
     std::span<const uint8_t> usings_data) {
-    // load invokers from array for fuction set
-    const auto load_invokers =
-        [&](function_overload_set &fos) {
-            for (auto &f : fos.functions) {
-                if (f.invoker_index != NO_ARRAY_INDEX) {
-                    f.invoker = invokers[f.invoker_index];
-                }
-            }
-        };
-
     // std::move all of src onto dst
     const auto append =
         [](auto &dst, auto &src) {
@@ -151,107 +204,114 @@ static void load_module_internal(
             src.clear();
         };
 
-    // load src_data (serialized vector of same type as dst) and append data
-    // onto dst
-    const auto load_basic =
-        [&append](auto &dst, auto &src_data) {
-            using V = std::remove_reference_t<decltype(dst)>;
-            auto vec = vector<typename V::value_type>();
-            auto is = bytestream(src_data);
-            deserialize(is, vec);
-            append(dst, vec);
-        };
+    const auto deserialize_start = std::chrono::steady_clock::now();
+
+    // all blobs in a module share one string table
+    const auto strings =
+        deserialize_string_table(strings_data, registry.strings);
 
     auto types =
-        deserialize<vector<type_info>>(types_data);
+        deserialize<vector<type_info>>(types_data, strings);
 
     auto functions =
-        deserialize<name_map<function_overload_set>>(functions_data);
+        deserialize<name_map<function_overload_set>>(functions_data, strings);
 
-    // patch indexed values for each type, function
-    for (auto &t : types) {
-        if (t.type_id_hash_index != NO_ARRAY_INDEX) {
-            t.type_id_hash = type_id_hashes[t.type_id_hash_index];
-        }
+    auto typedefs =
+        deserialize<vector<typedef_info>>(typedefs_data, strings);
 
-        if (t.kind != STRUCT && t.kind != UNION) {
-            continue;
-        }
+    auto aliases =
+        deserialize<vector<namespace_alias_info>>(aliases_data, strings);
 
-        for (auto &p : t.record.template_parameters) {
-            if (p.value_index != NO_ARRAY_INDEX) {
-                p.value = template_param_values[p.value_index];
-            }
-        }
+    auto usings =
+        deserialize<vector<namespace_using_info>>(usings_data, strings);
 
-        for (auto &b : t.record.bases) {
-            if (b.dyncast_down_index != NO_ARRAY_INDEX) {
-                b.dyncast_down = dyncasts[b.dyncast_down_index];
-            }
+    const auto merge_start = std::chrono::steady_clock::now();
+    const auto collisions_start = registry.num_collisions;
 
-            if (b.dyncast_up_index != NO_ARRAY_INDEX) {
-                b.dyncast_up = dyncasts[b.dyncast_up_index];
-            }
+    // patch indexed values for each type, function
+    for (auto &t : types) {
+        if (t.type_id_hash_index != NO_ARRAY_INDEX) {
+            t.type_id_hash = type_id_hashes[t.type_id_hash_index];
         }
 
-        for (auto &[_, f] : t.record.static_fields) {
-            if (f.constexpr_value_index != NO_ARRAY_INDEX) {
-                f.constexpr_value =
-                    constexpr_values[f.constexpr_value_index];
-            }
+        if (t.value_ops_index != NO_ARRAY_INDEX) {
+            t.ops = ops[t.value_ops_index];
         }
 
-        for (auto &[_, fos] : t.record.functions) {
-            load_invokers(fos);
-        }
+        patch_type(
+            t,
+            [&](size_t i) { return dyncasts[i]; },
+            [&](size_t i) { return constexpr_values[i]; },
+            [&](size_t i) { return invokers[i]; },
+            [&](size_t i) { return template_param_values[i]; });
     }
 
     for (auto &[_, fos] : functions) {
-        load_invokers(fos);
+        load_invokers(fos, [&](size_t i) { return invokers[i]; });
     }
 
     registry.load_types(types);
     registry.load_functions(functions);
 
-    /* auto vec = vector<typedef_info>(); */
-    /* auto is = bytestream(typedefs_data); */
-    /* deserialize(is, vec); */
-    /* for (const auto &v : vec) { */
-    /*     std::cout */
-    /*         << "got typedef " */
-    /*         << v.name */
-    /*         << " <- " */
-    /*         << v.aliased_type.id */
-    /*         << std::endl; */
-    /* } */
-
     // insert typedefs, aliases, usings directly
-    load_basic(registry.typedefs, typedefs_data);
-    load_basic(registry.namespace_aliases, aliases_data);
-    load_basic(registry.namespace_usings, usings_data);
+    append(registry.typedefs, typedefs);
+    append(registry.namespace_aliases, aliases);
+    append(registry.namespace_usings, usings);
+
+    if (registry.collect_load_stats) {
+        const auto end = std::chrono::steady_clock::now();
+
+        size_t num_functions = 0;
+        for (const auto &[_, fos] : functions) {
+            num_functions += fos.functions.size();
+        }
+
+        registry.module_stats.push_back(
+            module_load_stats {
+                .name = name,
+                .deserialize_time = merge_start - deserialize_start,
+                .merge_time = end - merge_start,
+                .types = types.size(),
+                .functions = num_functions,
+                .collisions = registry.num_collisions - collisions_start,
+                .bytes_read =
+                    strings_data.size()
+                        + functions_data.size()
+                        + types_data.size()
+                        + typedefs_data.size()
+                        + aliases_data.size()
+                        + usings_data.size()
+            });
+    }
 }
 
 
 void registry::load_module(
+    std::string_view name,
     const vector<std::function<void*(void*)>> &dyncasts,
     const vector<any> &constexpr_values,
     const vector<invoker_ptr> &invokers,
     const vector<any> &template_param_values,
     const vector<size_t> &type_id_hashes,
+    const vector<const value_ops*> &ops,
+    std::span<const uint8_t> strings_data,
     std::span<const uint8_t> functions_data,
     std::span<const uint8_t> types_data,
     std::span<const uint8_t> typedefs_data,
     std::span<const uint8_t> aliases_data,
     std::span<const uint8_t> usings_data) {
     const auto f =
-        [=, &dyncasts, &constexpr_values, &invokers]() {
+        [=, &dyncasts, &constexpr_values, &invokers, &ops]() {
             load_module_internal(
                 *this,
+                name,
                 dyncasts,
                 constexpr_values,
                 invokers,
                 template_param_values,
                 type_id_hashes,
+                ops,
+                strings_data,
                 functions_data,
                 types_data,
                 typedefs_data,
@@ -262,6 +322,83 @@ void registry::load_module(
     this->loaders.push_back(f);
 }
 
+void registry::load_module_entries(
+    std::string_view name,
+    std::span<const module_type_entry *const> roots) {
+    this->loaders.push_back(
+        [this, name, roots]() {
+            const auto deserialize_start = std::chrono::steady_clock::now();
+            size_t bytes_read = 0;
+
+            // walk dependencies from roots, entries can be reachable from
+            // multiple modules but are only ever loaded once
+            vector<const module_type_entry*> stack(roots.begin(), roots.end());
+            vector<type_info> types;
+            while (!stack.empty()) {
+                const auto *e = stack.back();
+                stack.pop_back();
+
+                if (!e || this->loaded_entries.contains(e)) {
+                    continue;
+                }
+
+                this->loaded_entries.emplace(e);
+                stack.insert(stack.end(), e->deps.begin(), e->deps.end());
+                bytes_read += e->data.size() + e->strings.size();
+
+                const auto strings =
+                    deserialize_string_table(e->strings, this->strings);
+                auto &t =
+                    types.emplace_back(
+                        deserialize<type_info>(e->data, strings));
+                if (e->type_id_hash) {
+                    t.type_id_hash = e->type_id_hash();
+                }
+
+                t.ops = e->ops;
+
+                patch_type(
+                    t,
+                    [&](size_t i) { return dyncast_fn(e->dyncasts[i]); },
+                    [&](size_t i) { return e->constexpr_values[i](); },
+                    [&](size_t i) { return e->invokers[i]; },
+                    [&](size_t i) { return e->template_param_values[i](); });
+            }
+
+            const auto merge_start = std::chrono::steady_clock::now();
+            const auto collisions_start = this->num_collisions;
+            this->load_types(types);
+
+            if (this->collect_load_stats) {
+                this->module_stats.push_back(
+                    module_load_stats {
+                        .name = name,
+                        .deserialize_time = merge_start - deserialize_start,
+                        .merge_time =
+                            std::chrono::steady_clock::now() - merge_start,
+                        .types = types.size(),
+                        .functions = 0,
+                        .collisions = this->num_collisions - collisions_start,
+                        .bytes_read = bytes_read
+                    });
+            }
+        });
+}
+
+// fill in bit_access of all bit fields of record t
+static void build_bit_accessors(type_info &t) {
+    for (auto &[_, f] : t.record.fields) {
+        if (f.is_bit_field) {
+            f.bit_access =
+                bit_field_accessor::make(
+                    f.bit_offset,
+                    f.bit_size,
+                    f.is_signed_bit_field,
+                    t.size);
+        }
+    }
+}
+
 // load a set of types into the registry
 // TODO: std::move values
 void registry::load_types(const vector<type_info> is) {
@@ -287,6 +424,7 @@ void registry::load_types(const vector<type_info> is) {
                 this->types_by_id[i.id] = i;
             } else {
                 // resolve type collision
+                this->num_collisions++;
                 const auto *info =
                     this->tcc(
                         reflected_type(&other),
@@ -296,6 +434,12 @@ void registry::load_types(const vector<type_info> is) {
             }
         }
     }
+
+    for (const auto &i : is) {
+        if (i.kind == STRUCT || i.kind == UNION) {
+            build_bit_accessors(this->types_by_id[i.id]);
+        }
+    }
 }
 
 // load a set of function overloads into the registry
@@ -344,11 +488,130 @@ expand:
         if (expanded.starts_with(na.name)) {
             std::string old = expanded;
             expanded =
-                na.aliased + expanded.substr(na.name.length());
+                std::string(na.aliased) + expanded.substr(na.name.length());
             goto expand;
         }
     }
     return expanded;
 }
+
+// accumulates approximate heap usage of registry containers
+namespace {
+struct memory_counter {
+    memory_stats &stats;
+
+    // nodes are assumed to hold two pointers alongside their value
+    template <typename M>
+    void map(const M &m) {
+        this->stats.maps +=
+            m.size() * (sizeof(typename M::value_type) + 2 * sizeof(void*));
+        if constexpr (requires { m.bucket_count(); }) {
+            this->stats.maps += m.bucket_count() * sizeof(void*);
+        }
+    }
+
+    template <typename V>
+    void vec(const V &v) {
+        this->stats.vectors += v.capacity() * sizeof(typename V::value_type);
+    }
+
+    void value(const any &a) {
+        if (a.id()) {
+            // values larger than a pointer are stored out of line
+            this->stats.constexpr_values +=
+                sizeof(any) + (a.size() > sizeof(void*) ? a.size() : 0);
+        }
+    }
+
+    void function(const function_type_info &f) {
+        this->vec(f.parameters);
+        this->vec(f.annotations);
+    }
+
+    void overloads(const function_overload_set &fos) {
+        this->vec(fos.functions);
+        for (const auto &f : fos.functions) {
+            this->function(f);
+        }
+    }
+
+    void type(const type_info &t) {
+        this->vec(t.annotations);
+
+        this->vec(t.record.template_parameters);
+        for (const auto &p : t.record.template_parameters) {
+            this->value(p.value);
+        }
+
+        this->vec(t.record.bases);
+        this->map(t.record.typedefs);
+
+        this->map(t.record.fields);
+        for (const auto &[_, f] : t.record.fields) {
+            this->vec(f.annotations);
+        }
+
+        this->map(t.record.static_fields);
+        for (const auto &[_, f] : t.record.static_fields) {
+            this->vec(f.annotations);
+            this->value(f.constexpr_value);
+        }
+
+        this->map(t.record.functions);
+        for (const auto &[_, fos] : t.record.functions) {
+            this->overloads(fos);
+        }
+
+        this->vec(t.function.parameters);
+
+        this->map(t.enum_.name_to_value);
+        this->map(t.enum_.value_to_name);
+        this->vec(t.enum_.tables.entries);
+        this->vec(t.enum_.tables.dense);
+        this->vec(t.enum_.tables.hash_displacements);
+        this->vec(t.enum_.tables.hash_slots);
+        this->vec(t.enum_.tables.flags);
+        for (const auto &[_, ns] : t.enum_.value_to_name) {
+            this->vec(ns);
+        }
+    }
+};
+}
+
+memory_stats registry::memory() const {
+    memory_stats stats;
+    memory_counter c { stats };
+
+    stats.strings = this->strings.bytes();
+
+    c.map(this->types_by_type_id_hashes);
+    c.map(this->types_by_id);
+    for (const auto &[_, t] : this->types_by_id) {
+        c.type(t);
+    }
+
+    c.map(this->functions_by_type);
+    for (const auto &[_, fs] : this->functions_by_type) {
+        c.vec(fs);
+        for (const auto &f : fs) {
+            c.function(f);
+        }
+    }
+
+    c.map(this->functions_by_name);
+    for (const auto &[_, sets] : this->functions_by_name) {
+        c.vec(sets);
+        for (const auto &fos : sets) {
+            c.overloads(fos);
+        }
+    }
+
+    c.vec(this->namespace_aliases);
+    c.vec(this->namespace_usings);
+    c.vec(this->typedefs);
+    c.vec(this->module_stats);
+    c.vec(this->loaders);
+    return stats;
+}
 } // namespace detail
 } // namespace archimedes
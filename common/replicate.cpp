@@ -0,0 +1,458 @@
+#include <archimedes/replicate.hpp>
+#include <archimedes/bits.hpp>
+#include <archimedes/members.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace archimedes;
+
+using field = replication_plan::field;
+
+static void write_varint(binary_writer &w, uint64_t v) {
+    uint8_t buf[10];
+    size_t n = 0;
+    while (v >= 0x80) {
+        buf[n++] = static_cast<uint8_t>(v) | 0x80;
+        v >>= 7;
+    }
+    buf[n++] = static_cast<uint8_t>(v);
+    w.write(buf, n);
+}
+
+static uint64_t read_varint(binary_reader &r) {
+    uint64_t v = 0;
+    for (size_t shift = 0; shift < 64; shift += 7) {
+        uint8_t b = 0;
+        r.read(b);
+        if (!r.ok) {
+            return 0;
+        }
+
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return v;
+        }
+    }
+
+    // too long
+    r.ok = false;
+    return 0;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// sign extend low bits of v
+static int64_t sign_extend(uint64_t v, size_t bits) {
+    if (bits >= 64) {
+        return static_cast<int64_t>(v);
+    }
+
+    const auto shift = 64 - bits;
+    return static_cast<int64_t>(v << shift) >> shift;
+}
+
+static double load_float(const uint8_t *p, size_t size) {
+    if (size == sizeof(float)) {
+        float f;
+        std::memcpy(&f, p, sizeof(f));
+        return f;
+    }
+
+    double d;
+    std::memcpy(&d, p, sizeof(d));
+    return d;
+}
+
+static void store_float(uint8_t *p, size_t size, double d) {
+    if (size == sizeof(float)) {
+        const auto f = static_cast<float>(d);
+        std::memcpy(p, &f, sizeof(f));
+    } else {
+        std::memcpy(p, &d, sizeof(d));
+    }
+}
+
+// value as a multiple of quantum, non-finite values are 0
+static int64_t quantize(double v, double quantum) {
+    const auto q = v / quantum;
+    return std::isfinite(q) && std::abs(q) < 9.0e18 ? std::llround(q) : 0;
+}
+
+// delta of field between object and baseline, 0 if unchanged. only for
+// INTEGER, BITS and quantized FLOAT fields.
+static int64_t delta_of(
+    const field &f,
+    const uint8_t *obj,
+    const uint8_t *base) {
+    switch (f.kind) {
+        case field::INTEGER:
+            return sign_extend(
+                detail::load_uint(obj + f.offset, f.size)
+                    - detail::load_uint(base + f.offset, f.size),
+                f.size * 8);
+        case field::BITS:
+            return sign_extend(
+                detail::load_bits(obj, f.offset, f.size, false)
+                    - detail::load_bits(base, f.offset, f.size, false),
+                f.size);
+        case field::FLOAT:
+            return quantize(load_float(obj + f.offset, f.size), f.quantum)
+                - quantize(load_float(base + f.offset, f.size), f.quantum);
+        default:
+            return 0;
+    }
+}
+
+static bool is_changed(
+    const field &f,
+    const uint8_t *obj,
+    const uint8_t *base) {
+    switch (f.kind) {
+        case field::FLOAT:
+            if (f.quantum == 0.0) {
+                return std::memcmp(obj + f.offset, base + f.offset, f.size)
+                    != 0;
+            }
+            return delta_of(f, obj, base) != 0;
+        case field::VALUE:
+            return !object_comparer::equals(
+                *f.compare, obj + f.offset, base + f.offset);
+        default:
+            return delta_of(f, obj, base) != 0;
+    }
+}
+
+static void write_field(
+    const field &f,
+    const uint8_t *obj,
+    const uint8_t *base,
+    binary_writer &w) {
+    if (f.kind == field::VALUE) {
+        binary_serializer::write(*f.binary, obj + f.offset, w);
+    } else if (f.kind == field::FLOAT && f.quantum == 0.0) {
+        w.write(obj + f.offset, f.size);
+    } else {
+        write_varint(w, zigzag(delta_of(f, obj, base)));
+    }
+}
+
+static void read_field(const field &f, uint8_t *obj, binary_reader &r) {
+    if (f.kind == field::VALUE) {
+        binary_serializer::read(*f.binary, obj + f.offset, r);
+        return;
+    } else if (f.kind == field::FLOAT && f.quantum == 0.0) {
+        r.read(obj + f.offset, f.size);
+        return;
+    }
+
+    const auto delta = unzigzag(read_varint(r));
+    if (!r.ok) {
+        return;
+    }
+
+    switch (f.kind) {
+        case field::INTEGER:
+            detail::store_uint(
+                obj + f.offset,
+                f.size,
+                detail::load_uint(obj + f.offset, f.size) + delta);
+            break;
+        case field::BITS:
+            detail::store_bits(
+                obj,
+                f.offset,
+                f.size,
+                detail::load_bits(obj, f.offset, f.size, false) + delta);
+            break;
+        case field::FLOAT:
+            store_float(
+                obj + f.offset,
+                f.size,
+                static_cast<double>(
+                    static_cast<int64_t>(
+                        static_cast<uint64_t>(
+                            quantize(
+                                load_float(obj + f.offset, f.size),
+                                f.quantum))
+                            + static_cast<uint64_t>(delta)))
+                    * f.quantum);
+            break;
+        default:
+            break;
+    }
+}
+
+std::optional<replication_error> replicator::add_field(
+    replication_plan &plan,
+    const reflected_field &f,
+    size_t offset) {
+    auto &rf =
+        plan.fields.emplace_back(
+            field {
+                .name = std::string(f.name()),
+                .kind = field::VALUE,
+                .offset = offset + f.offset(),
+                .size = f.size()
+            });
+
+    if (f.is_bit_field()) {
+        rf.kind = field::BITS;
+        rf.offset = (offset * 8) + *f.bit_offset();
+        rf.size = *f.bit_field_size();
+        return std::nullopt;
+    }
+
+    const auto t = reflect(f.field_type_id());
+    if (t && t->is_numeric()) {
+        rf.size = t->size();
+        if (t->kind() == FLOAT || t->kind() == DOUBLE) {
+            if (rf.size != sizeof(float) && rf.size != sizeof(double)) {
+                return replication_error::UNSUPPORTED_TYPE;
+            }
+
+            rf.kind = field::FLOAT;
+        } else if (rf.size <= sizeof(uint64_t)) {
+            rf.kind = field::INTEGER;
+        }
+
+        if (rf.kind != field::VALUE) {
+            return std::nullopt;
+        }
+    }
+
+    const auto binary = this->binary.plan(f.field_type_id());
+    if (!binary) {
+        return binary.unwrap_error() == binary_error::COULD_NOT_REFLECT ?
+            replication_error::COULD_NOT_REFLECT
+            : replication_error::UNSUPPORTED_TYPE;
+    }
+
+    const auto compare = this->comparer.plan(f.field_type_id());
+    if (!compare) {
+        return compare.unwrap_error() == compare_error::COULD_NOT_REFLECT ?
+            replication_error::COULD_NOT_REFLECT
+            : replication_error::UNSUPPORTED_TYPE;
+    }
+
+    rf.binary = *binary;
+    rf.compare = *compare;
+    return std::nullopt;
+}
+
+result<const replication_plan*, replication_error> replicator::plan(
+    type_id id) {
+    if (auto it = this->plans.find(id); it != this->plans.end()) {
+        return it->second.get();
+    }
+
+    const auto type = reflect(id);
+    if (!type) {
+        return replication_error::COULD_NOT_REFLECT;
+    } else if (type->kind() != STRUCT) {
+        return replication_error::UNSUPPORTED_TYPE;
+    }
+
+    auto plan = std::make_unique<replication_plan>();
+    plan->id = id;
+    plan->size = type->size();
+    const auto members = detail::record_members(type->as_record());
+    if (!members) {
+        return replication_error::UNSUPPORTED_TYPE;
+    }
+
+    for (const auto &m : *members) {
+        if (const auto err = this->add_field(*plan, m.field, m.offset)) {
+            return *err;
+        }
+    }
+
+    return this->plans.emplace(id, std::move(plan)).first->second.get();
+}
+
+std::optional<replication_error> replicator::set_quantization(
+    type_id id,
+    std::string_view name,
+    double step) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    // plans are only const to users
+    auto &fields = const_cast<replication_plan*>(*plan)->fields;
+    const auto it =
+        std::find_if(
+            fields.begin(),
+            fields.end(),
+            [&](const field &f) { return f.name == name; });
+
+    if (it == fields.end()) {
+        return replication_error::UNKNOWN_FIELD;
+    } else if (it->kind != field::FLOAT || !(step >= 0.0)) {
+        return replication_error::UNSUPPORTED_TYPE;
+    }
+
+    it->quantum = step;
+    return std::nullopt;
+}
+
+result<any_vector, replication_error> replicator::snapshot(
+    type_id id,
+    const void *objects,
+    size_t count) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    const auto type = reflect(id);
+    if (!type->ops() || !type->ops()->copy) {
+        return replication_error::UNSUPPORTED_TYPE;
+    }
+
+    any_vector v(*type);
+    v.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        v.push_back(
+            static_cast<const uint8_t*>(objects) + (i * (*plan)->size));
+    }
+
+    return result<any_vector, replication_error>(std::move(v));
+}
+
+result<size_t, replication_error> replicator::encode(
+    type_id id,
+    const void *objects,
+    size_t count,
+    any_vector &baseline,
+    std::span<uint8_t> out) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    } else if (baseline.id() != id || baseline.size() != count) {
+        return replication_error::COUNT_MISMATCH;
+    }
+
+    const auto &p = **plan;
+    binary_writer w { .buffer = out };
+    write_varint(w, count);
+
+    // change mask is filled in as objects are written
+    const auto mask_pos = w.pos, mask_size = (count + 7) / 8;
+    for (size_t i = 0; i < mask_size; i++) {
+        w.write(uint8_t(0));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const auto
+            *obj = static_cast<const uint8_t*>(objects) + (i * p.size),
+            *base = static_cast<const uint8_t*>(baseline[i]);
+
+        this->changed.clear();
+        for (size_t j = 0; j < p.fields.size(); j++) {
+            if (is_changed(p.fields[j], obj, base)) {
+                this->changed.push_back(j);
+            }
+        }
+
+        if (this->changed.empty()) {
+            continue;
+        }
+
+        if (w.ok && out.data()) {
+            out[mask_pos + (i / 8)] |= uint8_t(1) << (i % 8);
+        }
+
+        write_varint(w, this->changed.size());
+
+        size_t next = 0;
+        for (const auto j : this->changed) {
+            write_varint(w, j - next);
+            write_field(p.fields[j], obj, base, w);
+            next = j + 1;
+        }
+    }
+
+    if (!w.ok) {
+        return replication_error::BUFFER_TOO_SMALL;
+    }
+
+    // baseline becomes exactly what the receiver gets
+    if (out.data()) {
+        const auto n =
+            this->apply(
+                id, baseline.data(), count, std::span(out.data(), w.pos));
+        if (!n) {
+            return n.unwrap_error();
+        }
+    }
+
+    return w.pos;
+}
+
+result<size_t, replication_error> replicator::apply(
+    type_id id,
+    void *objects,
+    size_t count,
+    std::span<const uint8_t> in) {
+    const auto plan = this->plan(id);
+    if (!plan) {
+        return plan.unwrap_error();
+    }
+
+    const auto &p = **plan;
+    binary_reader r { .buffer = in };
+    const auto n = read_varint(r);
+    if (!r.ok) {
+        return replication_error::TRUNCATED;
+    } else if (n != count) {
+        return replication_error::COUNT_MISMATCH;
+    }
+
+    const auto mask_pos = r.pos, mask_size = (count + 7) / 8;
+    r.skip(mask_size);
+    if (!r.ok) {
+        return replication_error::TRUNCATED;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!(in[mask_pos + (i / 8)] & (uint8_t(1) << (i % 8)))) {
+            continue;
+        }
+
+        auto *obj = static_cast<uint8_t*>(objects) + (i * p.size);
+        const auto num_fields = read_varint(r);
+        if (num_fields > p.fields.size()) {
+            return replication_error::BAD_PATCH;
+        }
+
+        size_t next = 0;
+        for (size_t j = 0; r.ok && j < num_fields; j++) {
+            const auto gap = read_varint(r);
+            if (gap >= p.fields.size() - next) {
+                return r.ok ?
+                    replication_error::BAD_PATCH
+                    : replication_error::TRUNCATED;
+            }
+
+            const auto index = next + gap;
+            read_field(p.fields[index], obj, r);
+            next = index + 1;
+        }
+
+        if (!r.ok) {
+            return replication_error::TRUNCATED;
+        }
+    }
+
+    return r.pos;
+}
@@ -0,0 +1,223 @@
+#include <archimedes/soa.hpp>
+#include <archimedes/members.hpp>
+#include <archimedes.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace archimedes;
+
+// assign value at src to initialized value at dst. non-trivial values are
+// copied into a temporary first, so dst is left intact if the copy throws
+static void assign(const any_vector &v, void *dst, const void *src) {
+    const auto *ops = v.ops();
+    if (ops->is_trivial) {
+        std::memcpy(dst, src, v.stride());
+        return;
+    }
+
+    // storage is released on every path out, the value only once copied
+    struct temporary {
+        void *ptr;
+        std::align_val_t align;
+
+        ~temporary() {
+            ::operator delete(this->ptr, this->align);
+        }
+    };
+
+    const auto align = std::align_val_t(v.align());
+    const temporary tmp = { ::operator new(v.stride(), align), align };
+    ops->copy(tmp.ptr, src);
+
+    if (ops->swap) {
+        ops->swap(dst, tmp.ptr);
+    } else {
+        if (ops->destroy) {
+            ops->destroy(dst);
+        }
+
+        if (ops->move) {
+            ops->move(dst, tmp.ptr);
+        } else {
+            ops->copy(dst, tmp.ptr);
+        }
+    }
+
+    if (ops->destroy) {
+        ops->destroy(tmp.ptr);
+    }
+}
+
+result<any_soa_vector, soa_error> any_soa_vector::make(type_id id) {
+    const auto type = reflect(id);
+    if (!type) {
+        return soa_error::COULD_NOT_REFLECT;
+    } else if (type->kind() != STRUCT) {
+        return soa_error::UNSUPPORTED_TYPE;
+    }
+
+    const auto members = detail::record_members(type->as_record());
+    if (!members) {
+        return soa_error::UNSUPPORTED_TYPE;
+    }
+
+    any_soa_vector soa;
+    soa._id = id;
+    soa.record_ops = type->ops();
+    soa.record_size = type->size();
+    soa.record_align = std::max<size_t>(type->align(), 1);
+    soa._columns.reserve(members->size());
+
+    for (const auto &m : *members) {
+        const auto field_type = reflect(m.field.field_type_id());
+        if (!field_type) {
+            return soa_error::COULD_NOT_REFLECT;
+        } else if (!any_vector::supports(*field_type)) {
+            return soa_error::UNSUPPORTED_TYPE;
+        }
+
+        auto &c =
+            soa._columns.emplace_back(
+                column_info {
+                    .field = m.field,
+                    .offset = m.offset,
+                    .bits = {},
+                    .values = any_vector(*field_type)
+                });
+
+        const auto *ops = c.values.ops();
+        if (!ops->is_trivial && !ops->copy) {
+            return soa_error::UNSUPPORTED_TYPE;
+        }
+
+        if (m.field.is_bit_field()) {
+            const auto bits = m.field.bit_accessor();
+            if (!bits) {
+                return soa_error::UNSUPPORTED_TYPE;
+            }
+            c.bits = *bits;
+        } else {
+            c.offset = m.offset + m.field.offset();
+        }
+    }
+
+    return soa;
+}
+
+std::optional<size_t> any_soa_vector::column_index(
+    std::string_view name) const {
+    // fields of bases come first, search backwards so derived fields win
+    for (size_t i = this->_columns.size(); i != 0; i--) {
+        if (this->_columns[i - 1].field.name() == name) {
+            return i - 1;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void any_soa_vector::push_back(const void *record) {
+    const auto *p = static_cast<const uint8_t*>(record);
+    for (auto &c : this->_columns) {
+        if (c.bits.is_valid()) {
+            uint64_t v;
+            detail::store_uint(
+                &v, c.values.stride(), c.bits.load(p + c.offset));
+            c.values.push_back(&v);
+        } else {
+            c.values.push_back(p + c.offset);
+        }
+    }
+
+    this->_size++;
+}
+
+void any_soa_vector::load(size_t i, void *record) const {
+    auto *p = static_cast<uint8_t*>(record);
+    for (const auto &c : this->_columns) {
+        if (c.bits.is_valid()) {
+            c.bits.store(
+                p + c.offset,
+                detail::load_uint(c.values[i], c.values.stride()));
+        } else {
+            assign(c.values, p + c.offset, c.values[i]);
+        }
+    }
+}
+
+void any_soa_vector::store(size_t i, const void *record) {
+    const auto *p = static_cast<const uint8_t*>(record);
+    for (auto &c : this->_columns) {
+        if (c.bits.is_valid()) {
+            detail::store_uint(
+                c.values[i],
+                c.values.stride(),
+                c.bits.load(p + c.offset));
+        } else {
+            assign(c.values, c.values[i], p + c.offset);
+        }
+    }
+}
+
+void any_soa_vector::reserve(size_t n) {
+    for (auto &c : this->_columns) {
+        c.values.reserve(n);
+    }
+}
+
+void any_soa_vector::resize(size_t n) {
+    if (n <= this->_size || !this->record_ops || !this->record_ops->construct) {
+        for (auto &c : this->_columns) {
+            c.values.resize(n);
+        }
+        this->_size = n;
+        return;
+    }
+
+    // default construct a record once and copy its fields into the new rows
+    auto *record =
+        static_cast<uint8_t*>(
+            ::operator new(
+                this->record_size, std::align_val_t(this->record_align)));
+    this->record_ops->construct(record);
+
+    this->reserve(n);
+    while (this->_size < n) {
+        this->push_back(static_cast<const void*>(record));
+    }
+
+    if (this->record_ops->destroy) {
+        this->record_ops->destroy(record);
+    }
+    ::operator delete(record, std::align_val_t(this->record_align));
+}
+
+void any_soa_vector::pop_back() {
+    for (auto &c : this->_columns) {
+        c.values.pop_back();
+    }
+    this->_size--;
+}
+
+void any_soa_vector::erase(size_t i) {
+    for (auto &c : this->_columns) {
+        c.values.erase(i);
+    }
+    this->_size--;
+}
+
+void any_soa_vector::swap_erase(size_t i) {
+    for (auto &c : this->_columns) {
+        c.values.swap_erase(i);
+    }
+    this->_size--;
+}
+
+void any_soa_vector::clear() {
+    for (auto &c : this->_columns) {
+        c.values.clear();
+    }
+    this->_size = 0;
+}
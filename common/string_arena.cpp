@@ -0,0 +1,37 @@
+#include <cstring>
+#include <archimedes/string_arena.hpp>
+
+using namespace archimedes::detail;
+
+std::string_view string_arena::intern(std::string_view s) {
+    if (s.empty()) {
+        return std::string_view();
+    }
+
+    if (const auto it = this->strings.find(s); it != this->strings.end()) {
+        return *it;
+    }
+
+    char *dst;
+    if (s.size() > CHUNK_SIZE) {
+        // oversized, give it its own chunk but keep filling the current one
+        const auto it =
+            this->chunks.emplace(
+                this->chunks.end() - (this->chunks.empty() ? 0 : 1),
+                std::make_unique<char[]>(s.size()));
+        dst = it->get();
+        this->allocated += s.size();
+    } else {
+        if (this->chunk_used + s.size() > CHUNK_SIZE) {
+            this->chunks.emplace_back(std::make_unique<char[]>(CHUNK_SIZE));
+            this->chunk_used = 0;
+            this->allocated += CHUNK_SIZE;
+        }
+
+        dst = this->chunks.back().get() + this->chunk_used;
+        this->chunk_used += s.size();
+    }
+
+    std::memcpy(dst, s.data(), s.size());
+    return *this->strings.emplace(dst, s.size()).first;
+}
@@ -48,6 +48,17 @@ extern template class
 #include "archimedes/types.hpp"
 #include "archimedes/registry.hpp"
 #include "archimedes/cast.hpp"
+#include "archimedes/static_reflect.hpp"
+#include "archimedes/factory.hpp"
+#include "archimedes/any_vector.hpp"
+#include "archimedes/soa.hpp"
+#include "archimedes/field_path.hpp"
+#include "archimedes/gather.hpp"
+#include "archimedes/binary.hpp"
+#include "archimedes/archive.hpp"
+#include "archimedes/json.hpp"
+#include "archimedes/compare.hpp"
+#include "archimedes/replicate.hpp"
 
 namespace archimedes {
 // load type data if not already loaded
@@ -60,6 +71,23 @@ inline bool loaded() {
     return detail::registry::instance().loaded();
 }
 
+// enable collection of per-module statistics, see load_stats()
+// must be called before load()
+inline void enable_load_stats() {
+    detail::registry::instance().collect_load_stats = true;
+}
+
+// statistics for load() and current registry memory usage
+// per-module statistics are only present if enable_load_stats() was called
+inline load_statistics load_stats() {
+    const auto &r = detail::registry::instance();
+    return load_statistics {
+        .modules = r.module_stats,
+        .total_time = r.load_time,
+        .memory = r.memory()
+    };
+}
+
 // set the type collision callback
 // a function which accepts two reflected_types and chooses between them
 // which type the type name should resolve to
@@ -68,6 +96,24 @@ inline void set_collision_callback(collision_callback &&tcc) {
         .set_collision_callback(std::move(tcc));
 }
 
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+// set callback sampling reflected function invocations, called after every
+// period-th invocation of each function with its result and duration
+// NOTE: not synchronized with concurrent invocations, set before calling
+inline void set_invoke_hook(invoke_hook &&hook, size_t period = 1) {
+    auto &r = detail::registry::instance();
+    r.hook = std::move(hook);
+    r.hook_period = period;
+}
+
+// reset invocation statistics of all functions
+inline void reset_invoke_stats() {
+    for (auto &[_, s] : detail::registry::instance().invoke_stats_by_invoker) {
+        s->reset();
+    }
+}
+#endif
+
 // get reflected type by annotations
 inline vector<reflected_type> reflect_by_annotations(
     std::span<const std::string_view> annotations) {
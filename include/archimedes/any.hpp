@@ -2,11 +2,13 @@
 
 #include <type_traits>
 #include <cstdlib>
+#include <cstring>
 #include <utility>
 #include <span>
 
 #include "errors.hpp"
 #include "type_id.hpp"
+#include "value_ops.hpp"
 
 #include <iostream>
 
@@ -15,8 +17,6 @@ struct reflected_type;
 
 // generic storage for any type
 // TODO: optimize so types with size < sizeof(void*) don't heap allocate
-// TODO: store info (functions, etc.) in another structure that is not
-// duplicated per-any
 struct any {
     any() = default;
 
@@ -33,15 +33,19 @@ struct any {
         this->data =
             this->data_size ? std::malloc(this->data_size) : other.data;
         this->is_data_owned = this->data_size != 0;
-        this->copy_fn = other.copy_fn;
-        this->dtor_fn = other.dtor_fn;
+        this->ops = other.ops;
+        this->uses_invokers = other.uses_invokers;
 
         if (this->data_size != 0) {
-            if (!this->copy_fn) {
+            if (this->ops && this->ops->copy) {
+                this->ops->copy(this->data, other.data);
+            } else if (this->ops && this->ops->is_trivial) {
+                std::memcpy(this->data, other.data, this->data_size);
+            } else if (this->uses_invokers) {
+                this->copy_with_invokers(other.data);
+            } else {
                 ARCHIMEDES_FAIL("attempt to copy uncopyable type");
             }
-
-            (*this->copy_fn)(this->data, other.data);
         }
 
         return *this;
@@ -59,8 +63,8 @@ struct any {
         this->data_size = other.data_size;
         this->data = other.data;
         this->is_data_owned = other.is_data_owned;
-        this->copy_fn = std::move(other.copy_fn);
-        this->dtor_fn = std::move(other.dtor_fn);
+        this->ops = other.ops;
+        this->uses_invokers = other.uses_invokers;
         other.data = nullptr;
         other.is_data_owned = false;
 
@@ -162,8 +166,7 @@ struct any {
         any a = make_of_size(
             id ? id : type_id::from<T>(),
             sizeof(T),
-            get_copy<T>(),
-            get_dtor<T>());
+            &value_ops_of<T>);
         new (a.data) T(t);
         return a;
     }
@@ -184,8 +187,7 @@ struct any {
         any a = make_of_size(
             id ? id : type_id::from<U>(),
             sizeof(T),
-            get_copy<U>(),
-            get_dtor<U>());
+            &value_ops_of<U>);
         new (a.data) T(std::move(t));
         return a;
     }
@@ -228,44 +230,15 @@ struct any {
     }
 
 protected:
-    template <typename T>
-    static std::optional<std::function<void(void*, void*)>> get_copy() {
-        if constexpr (std::is_copy_constructible_v<T>) {
-            return [](void *p, void *o) {
-                new (p) T(*reinterpret_cast<T*>(o));
-            };
-        } else if constexpr (
-            std::is_copy_assignable_v<T>
-            && std::is_default_constructible_v<T>) {
-            return [](void *p, void *o) {
-                new (p) T();
-                *reinterpret_cast<T*>(p) = *reinterpret_cast<T*>(o);
-            };
-        }
-
-        return std::nullopt;
-    }
-
-    template <typename T>
-    static std::optional<std::function<void(void*)>> get_dtor() {
-        if constexpr (!std::is_trivially_destructible_v<T>) {
-            return [](void *p) { reinterpret_cast<T*>(p)->~T(); };
-        }
-
-        return std::nullopt;
-    }
-
     // make any with arbitrarily sized storage
     static inline any make_of_size(
         type_id id,
         size_t data_size = 0,
-        std::optional<std::function<void(void*, void*)>> copy = std::nullopt,
-        std::optional<std::function<void(void*)>> dtor = std::nullopt) {
+        const value_ops *ops = nullptr) {
         any a;
         a._id = id;
         a.data_size = data_size;
-        a.copy_fn = copy;
-        a.dtor_fn = dtor;
+        a.ops = ops;
 
         if (a.data_size != 0) {
             a.data = std::malloc(data_size);
@@ -282,8 +255,7 @@ protected:
         any a;
         a._id = id;
         a.data_size = 0;
-        a.copy_fn = std::nullopt;
-        a.dtor_fn = std::nullopt;
+        a.ops = nullptr;
         a.is_data_owned = false;
         return a;
     }
@@ -300,10 +272,17 @@ protected:
     // if true, data must be free'd
     bool is_data_owned = false;
 
-    // copy/move from arg 1 to arg 0
-    std::optional<std::function<void(void*, void*)>> copy_fn;
+    // copy/destroy operations for owned data, nullptr if none
+    const value_ops *ops = nullptr;
+
+    // true if data is a record without value_ops, which is copied and
+    // destroyed through its reflected copy ctor/dtor instead
+    bool uses_invokers = false;
 
-    // destructor
-    std::optional<std::function<void(void*)>> dtor_fn;
+private:
+    // copy construct src into data with the reflected copy ctor (or default
+    // ctor and copy assignment)
+    // implemented in common/any.cpp
+    void copy_with_invokers(const void *src);
 };
 } // end namespace archimedes
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <span>
+#include <utility>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "value_ops.hpp"
+
+namespace archimedes {
+// contiguous array of values of one runtime (reflected) type, laid out using
+// the reflected size/align and managed with the type's value_ops. values are
+// relocated with memcpy if the type is trivial, otherwise moved (or copied)
+// and destroyed.
+// implemented in common/any_vector.cpp
+struct any_vector {
+    any_vector() = default;
+
+    // empty vector of reflected type, which must have value_ops or be trivial
+    // (numeric, pointer, arrays of those). trivial types without a default
+    // ctor are zeroed by resize/emplace_back.
+    explicit any_vector(const reflected_type &type);
+
+    any_vector(const any_vector &other);
+    any_vector &operator=(const any_vector &other);
+
+    any_vector(any_vector &&other) {
+        *this = std::move(other);
+    }
+
+    any_vector &operator=(any_vector &&other);
+
+    ~any_vector();
+
+    // true if an any_vector can hold values of type
+    // implemented in common/any_vector.cpp
+    static bool supports(const reflected_type &type);
+
+    // id of element type
+    type_id id() const {
+        return this->_id;
+    }
+
+    // value_ops of element type
+    const value_ops *ops() const {
+        return this->_ops;
+    }
+
+    // number of elements
+    size_t size() const {
+        return this->_size;
+    }
+
+    // number of elements which fit without reallocating
+    size_t capacity() const {
+        return this->_capacity;
+    }
+
+    bool empty() const {
+        return this->_size == 0;
+    }
+
+    // size of one element in bytes (distance between elements)
+    size_t stride() const {
+        return this->elem_size;
+    }
+
+    // alignment of element type
+    size_t align() const {
+        return this->alignment;
+    }
+
+    void *data() {
+        return this->_data;
+    }
+
+    const void *data() const {
+        return this->_data;
+    }
+
+    // pointer to element i, NOT bounds checked
+    void *operator[](size_t i) {
+        return this->_data + (i * this->elem_size);
+    }
+
+    // pointer to element i, NOT bounds checked
+    const void *operator[](size_t i) const {
+        return this->_data + (i * this->elem_size);
+    }
+
+    // pointer to element i, nullptr if out of bounds
+    void *at(size_t i) {
+        return i < this->_size ? (*this)[i] : nullptr;
+    }
+
+    // pointer to element i, nullptr if out of bounds
+    const void *at(size_t i) const {
+        return i < this->_size ? (*this)[i] : nullptr;
+    }
+
+    // reserve space for at least n elements
+    void reserve(size_t n);
+
+    // resize to n elements, new elements are default constructed
+    void resize(size_t n);
+
+    // append a default constructed element, returns pointer to it
+    void *emplace_back();
+
+    // append a copy of the value at src, which must be of this vector's type
+    void *push_back(const void *src);
+
+    // append by moving the value at src, which must be of this vector's type
+    void *push_back_move(void *src);
+
+    // append a T constructed from args, T must be this vector's type
+    template <typename T, typename ...Args>
+    T &emplace_back(Args&&... args) {
+        this->check_type<T>();
+        void *p = this->grow_one();
+        T *t = ::new (p) T(std::forward<Args>(args)...);
+        this->_size++;
+        return *t;
+    }
+
+    // destroy last element
+    void pop_back();
+
+    // erase element i
+    void erase(size_t i) {
+        this->erase(i, i + 1);
+    }
+
+    // erase elements [first, last), elements after are shifted down
+    void erase(size_t first, size_t last);
+
+    // erase element i by moving the last element into its place
+    void swap_erase(size_t i);
+
+    // destroy all elements, keeps capacity
+    void clear();
+
+    // reallocate so capacity == size
+    void shrink_to_fit();
+
+    // typed view over elements, T must be this vector's type
+    template <typename T>
+    std::span<T> as() {
+        this->check_type<T>();
+        return std::span<T>(reinterpret_cast<T*>(this->_data), this->_size);
+    }
+
+    // typed view over elements, T must be this vector's type
+    template <typename T>
+    std::span<const T> as() const {
+        this->check_type<T>();
+        return std::span<const T>(
+            reinterpret_cast<const T*>(this->_data), this->_size);
+    }
+
+    // true if elements are of type T
+    template <typename T>
+    bool is() const {
+        return this->_id == type_id::from<T>();
+    }
+
+private:
+    template <typename T>
+    void check_type() const {
+        if (!this->is<T>() || sizeof(T) != this->elem_size) {
+            ARCHIMEDES_FAIL("any_vector accessed as wrong type");
+        }
+    }
+
+    // make room for one more element, returns pointer to its (uninitialized)
+    // storage. does not change size.
+    void *grow_one();
+
+    // move n elements from src to uninitialized dst, destroying sources
+    void relocate(uint8_t *dst, uint8_t *src, size_t n) const;
+
+    // destroy elements [first, last)
+    void destroy(size_t first, size_t last);
+
+    // reallocate storage to exactly n elements
+    void reallocate(size_t n);
+
+    type_id _id = type_id::none();
+    const value_ops *_ops = nullptr;
+    size_t elem_size = 0, alignment = 1;
+    uint8_t *_data = nullptr;
+    size_t _size = 0, _capacity = 0;
+};
+} // namespace archimedes
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+// hash of the memory layout of type id (size, alignment, fields, bases and
+// nested types) in the current build, error if type or any type it contains
+// is not trivially copyable or is a pointer/reference
+result<uint64_t, archive_error> layout_hash(type_id id);
+
+// writes archives of arrays of trivially copyable reflected objects which
+// archive::open can map and use in place. the format is host endian and
+// ties sections to the layout of their types in the writing build.
+// implemented in common/archive.cpp
+struct archive_writer {
+    // add count objects of type id at data as section name
+    // data is NOT copied and must stay alive until written
+    std::optional<archive_error> add(
+        std::string_view name,
+        type_id id,
+        const void *data,
+        size_t count);
+
+    template <typename T>
+    std::optional<archive_error> add(
+        std::string_view name,
+        std::span<const T> ts) {
+        return this->add(name, type_id::from<T>(), ts.data(), ts.size());
+    }
+
+    // size in bytes of written archive
+    size_t size() const;
+
+    // write archive to out, returns bytes written
+    result<size_t, archive_error> write(std::span<uint8_t> out) const;
+
+    // write archive to file at path
+    std::optional<archive_error> write(const std::string &path) const;
+
+private:
+    struct entry {
+        std::string name;
+        type_id id;
+        uint64_t layout_hash;
+        const void *data;
+        size_t count, stride, align;
+    };
+
+    // offset of each entry's data followed by total size
+    vector<size_t> layout() const;
+
+    // write header, section table and names to out
+    void write_prefix(
+        const vector<size_t> &offsets,
+        std::span<uint8_t> out) const;
+
+    vector<entry> entries;
+};
+
+// read-only archive written by archive_writer. sections are validated against
+// the current build's layouts when opened and then accessed in place.
+// implemented in common/archive.cpp
+struct archive {
+    struct section {
+        std::string_view name;
+        type_id id = type_id::none();
+        const void *data = nullptr;
+        size_t count = 0, stride = 0;
+    };
+
+    archive() = default;
+    archive(const archive&) = delete;
+    archive &operator=(const archive&) = delete;
+
+    archive(archive &&other) {
+        *this = std::move(other);
+    }
+
+    archive &operator=(archive &&other);
+
+    ~archive();
+
+    // memory map archive at path
+    static result<archive, archive_error> open(const std::string &path);
+
+    // archive over bytes, which must outlive it and be aligned as the
+    // sections in it (at most 64 bytes unless a type is overaligned)
+    static result<archive, archive_error> view(std::span<const uint8_t> bytes);
+
+    const vector<section> &sections() const {
+        return this->_sections;
+    }
+
+    // section by name, nullptr if not present
+    const section *find(std::string_view name) const;
+
+    // objects in section name, which must be of type T
+    template <typename T>
+    result<std::span<const T>, archive_error> get(std::string_view name) const {
+        const auto *s = this->find(name);
+        if (!s) {
+            return archive_error::NOT_FOUND;
+        } else if (s->id != type_id::from<T>() || s->stride != sizeof(T)) {
+            return archive_error::WRONG_TYPE;
+        }
+
+        return std::span<const T>(static_cast<const T*>(s->data), s->count);
+    }
+
+private:
+    // validate bytes and fill sections
+    std::optional<archive_error> parse(std::span<const uint8_t> bytes);
+
+    // mapping if opened from file
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+
+    vector<section> _sections;
+};
+} // namespace archimedes
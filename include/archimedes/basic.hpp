@@ -60,6 +60,14 @@
 #define ARCHIMEDES_REFLECT_TYPE_REGEX(rx)                                      \
     ARCHIMEDES_PRAGMA(_archimedes_reflect_regex_type_1 rx)
 
+// places emitted data in its own section so that it can be discarded by the
+// linker when unreferenced (Mach-O dead strips per symbol, no section needed)
+#if defined(__ELF__)
+#define ARCHIMEDES_SECTION(_s) __attribute__((section(_s)))
+#else
+#define ARCHIMEDES_SECTION(_s)
+#endif
+
 // use to force template instantiation
 #define ARCHIMEDES_FORCE_TEMPLATE_TYPE_INSTANTIATION(...)                      \
     extern template <> struct __VA_ARGS__;
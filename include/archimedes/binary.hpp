@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+// sequential writer over a caller supplied buffer, a writer without a buffer
+// (buffer.data() == nullptr) only counts bytes
+struct binary_writer {
+    std::span<uint8_t> buffer;
+    size_t pos = 0;
+
+    // false if a write did not fit, nothing is written past buffer.size()
+    bool ok = true;
+
+    void write(const void *p, size_t n) {
+        if (!this->buffer.data()) {
+            this->pos += n;
+            return;
+        } else if (!this->ok || this->buffer.size() - this->pos < n) {
+            this->ok = false;
+            return;
+        }
+
+        std::memcpy(this->buffer.data() + this->pos, p, n);
+        this->pos += n;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const T &t) {
+        this->write(&t, sizeof(T));
+    }
+};
+
+// sequential reader over a caller supplied buffer
+struct binary_reader {
+    std::span<const uint8_t> buffer;
+    size_t pos = 0;
+
+    // false if a read ran past the end of buffer
+    bool ok = true;
+
+    void read(void *p, size_t n) {
+        if (!this->ok || this->buffer.size() - this->pos < n) {
+            this->ok = false;
+            return;
+        }
+
+        std::memcpy(p, this->buffer.data() + this->pos, n);
+        this->pos += n;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void read(T &t) {
+        this->read(&t, sizeof(T));
+    }
+
+    void skip(size_t n) {
+        if (!this->ok || this->buffer.size() - this->pos < n) {
+            this->ok = false;
+            return;
+        }
+
+        this->pos += n;
+    }
+};
+
+// (de)serializes a value of some type which cannot be copied bytewise (fx.
+// std::string), registered with binary_serializer::set_codec
+struct binary_codec {
+    void (*write)(binary_writer&, const void*) = nullptr;
+    void (*read)(binary_reader&, void*) = nullptr;
+};
+
+// compiled (de)serialization plan for one reflected record type
+// the wire format is every field in order of offset (recursing into bases,
+// nested records and arrays) in host byte order without padding. fields which
+// are adjacent in memory are coalesced into one memcpy run.
+struct binary_plan {
+    struct op {
+        // offset into object
+        size_t offset;
+
+        // size in bytes of memcpy run, 0 if codec
+        size_t size;
+
+        // codec for non-bytewise values, nullptr if memcpy run
+        const binary_codec *codec;
+    };
+
+    type_id id = type_id::none();
+
+    // ops in wire order
+    vector<op> ops;
+
+    // total size of memcpy runs, if is_fixed_size this is the wire size
+    size_t fixed_size = 0;
+
+    // true if plan contains no codecs
+    bool is_fixed_size = true;
+};
+
+// field layout of a record as written to versioned streams, see
+// binary_serializer::write_schema. fields of (non-virtual) bases are flattened
+// into the record, all fields are in order of offset.
+// on the wire each field is
+// * bit fields: u64 value
+// * fixed size fields: their binary_plan output
+// * variable size fields (containing codecs): u32 length + plan output
+struct binary_schema {
+    struct field {
+        std::string name;
+        type_id id = type_id::none();
+
+        // size of field type
+        size_t size = 0;
+
+        // size on the wire, 0 if variable size
+        size_t wire_size = 0;
+
+        // width of bit field, 0 if not a bit field
+        size_t bit_size = 0;
+
+        // offset into record, in bits if bit field
+        size_t offset = 0;
+
+        // true if bit field is of a signed type (and is sign extended)
+        bool is_signed = false;
+
+        // hash of names, offsets and types of the fields of records nested in
+        // field type (recursively), 0 if it is not a record or array of them
+        uint64_t layout = 0;
+
+        // plan for field type, nullptr if bit field
+        const binary_plan *plan = nullptr;
+    };
+
+    type_id id = type_id::none();
+    vector<field> fields;
+
+    // hash of id and fields, equal fingerprints mean equal layouts
+    uint64_t fingerprint = 0;
+
+    // true if there are no bit fields or variable size fields, in which case
+    // versioned objects are written exactly as by binary_serializer::write
+    bool is_plain = true;
+
+    // fields as written by binary_serializer::write_schema
+    vector<uint8_t> encoded;
+
+    // fingerprint of type id with encoded fields
+    static uint64_t hash(type_id id, std::span<const uint8_t> encoded);
+};
+
+// maps a schema read from a stream onto the current schema of its type
+struct binary_mapping {
+    struct op {
+        // field to read into, nullptr if the written field no longer exists
+        // (or changed type) and is skipped
+        const binary_schema::field *field;
+
+        // size on the wire, 0 if variable size
+        size_t wire_size;
+
+        bool is_bit_field;
+    };
+
+    // current schema
+    const binary_schema *schema = nullptr;
+
+    // fingerprint of written schema
+    uint64_t fingerprint = 0;
+
+    // size of written schema in bytes
+    size_t schema_size = 0;
+
+    // true if written schema is the current schema
+    bool is_identical = false;
+
+    // true if some current fields are not in the written schema
+    bool has_missing = false;
+
+    // one op per written field, in wire order
+    vector<op> ops;
+};
+
+// binary serializer for reflected records, compiling a plan per type on first
+// use. plans and codecs are per-instance, NOT thread safe.
+// implemented in common/binary.cpp
+struct binary_serializer {
+    // registers a codec for std::string
+    binary_serializer();
+
+    // use codec for all values of type id
+    // must be called before any plan using type id is compiled
+    void set_codec(type_id id, binary_codec codec);
+
+    // set codec for T
+    template <typename T>
+    void set_codec(binary_codec codec) {
+        this->set_codec(type_id::from<T>(), codec);
+    }
+
+    // compiled plan for type, error if type is not reflected or contains a
+    // field which cannot be serialized (pointer, reference, etc.)
+    result<const binary_plan*, binary_error> plan(type_id id);
+
+    // bytes needed to write object p of type id
+    result<size_t, binary_error> size_of(type_id id, const void *p);
+
+    // write object p of type id to out, returns bytes written
+    result<size_t, binary_error> write(
+        type_id id,
+        const void *p,
+        std::span<uint8_t> out);
+
+    // read object p of type id from in, returns bytes read
+    // p must be a constructed object, its fields are overwritten
+    result<size_t, binary_error> read(
+        type_id id,
+        void *p,
+        std::span<const uint8_t> in);
+
+    template <typename T>
+    result<size_t, binary_error> size_of(const T &t) {
+        return this->size_of(type_id::from<T>(), &t);
+    }
+
+    template <typename T>
+    result<size_t, binary_error> write(const T &t, std::span<uint8_t> out) {
+        return this->write(type_id::from<T>(), &t, out);
+    }
+
+    template <typename T>
+    result<size_t, binary_error> read(T &t, std::span<const uint8_t> in) {
+        return this->read(type_id::from<T>(), &t, in);
+    }
+
+    // versioned streams: write_schema once, then any number of objects with
+    // write_versioned. on load read_schema maps the written layout onto the
+    // current one (cached by fingerprint) and read_versioned remaps fields by
+    // name, leaving fields which were added or changed type at their default.
+    // identical layouts without bit fields or codecs are read with memcpys.
+
+    // schema of record type id
+    result<const binary_schema*, binary_error> schema(type_id id);
+
+    // write schema of record type id to out, returns bytes written
+    result<size_t, binary_error> write_schema(
+        type_id id,
+        std::span<uint8_t> out);
+
+    // read schema written by write_schema for type id from in, mapping it onto
+    // the current layout of type id. mapping->schema_size bytes are read.
+    result<const binary_mapping*, binary_error> read_schema(
+        type_id id,
+        std::span<const uint8_t> in);
+
+    // write object p of record type id as described by its schema, returns
+    // bytes written
+    result<size_t, binary_error> write_versioned(
+        type_id id,
+        const void *p,
+        std::span<uint8_t> out);
+
+    // read object p with mapping from read_schema, returns bytes read
+    // p must be a constructed object. if fields are missing from the stream
+    // and the type is default constructible, p is reset (destroyed and
+    // constructed) first so they have their default values.
+    result<size_t, binary_error> read_versioned(
+        const binary_mapping &mapping,
+        void *p,
+        std::span<const uint8_t> in);
+
+    // run plan against object p
+    static void write(const binary_plan &plan, const void *p, binary_writer &w);
+    static void read(const binary_plan &plan, void *p, binary_reader &r);
+
+private:
+    // append ops for value of type id at offset to plan
+    std::optional<binary_error> compile(
+        binary_plan &plan,
+        type_id id,
+        size_t offset);
+
+    // append fields of record type (and its bases) to schema
+    std::optional<binary_error> compile_schema(
+        binary_schema &schema,
+        const reflected_record_type &type);
+
+    map<type_id, binary_codec> codecs;
+    map<type_id, std::unique_ptr<binary_plan>> plans;
+    map<type_id, std::unique_ptr<binary_schema>> schemas;
+
+    // by fingerprint of written schema
+    map<uint64_t, std::unique_ptr<binary_mapping>> mappings;
+};
+} // namespace archimedes
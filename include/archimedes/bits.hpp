@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace archimedes::detail {
+// bit field access on raw record memory, bit_offset is relative to base and
+// bits are numbered from the least significant bit of each byte
+
+// read bit_size bits at bit_offset from base, sign extended if is_signed
+inline uint64_t load_bits(
+    const uint8_t *base,
+    size_t bit_offset,
+    size_t bit_size,
+    bool is_signed) {
+    const auto first = bit_offset / 8, shift = bit_offset % 8;
+    const auto n = (shift + bit_size + 7) / 8;
+
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t b = base[first + i];
+        const auto s = static_cast<ptrdiff_t>(i * 8) - ptrdiff_t(shift);
+        if (s < 0) {
+            v |= b >> -s;
+        } else if (s < 64) {
+            v |= b << s;
+        }
+    }
+
+    if (bit_size < 64) {
+        v &= (uint64_t(1) << bit_size) - 1;
+        if (is_signed && bit_size != 0 && (v >> (bit_size - 1)) & 1) {
+            v |= ~uint64_t(0) << bit_size;
+        }
+    }
+
+    return v;
+}
+
+// write low bit_size bits of v at bit_offset into base
+inline void store_bits(
+    uint8_t *base,
+    size_t bit_offset,
+    size_t bit_size,
+    uint64_t v) {
+    const auto first = bit_offset / 8, shift = bit_offset % 8;
+    const auto n = (shift + bit_size + 7) / 8;
+
+    for (size_t i = 0; i < n; i++) {
+        const auto
+            lo = i == 0 ? shift : 0,
+            hi = std::min<size_t>(8, shift + bit_size - (i * 8));
+        const auto mask = static_cast<uint8_t>(((1u << (hi - lo)) - 1) << lo);
+        const auto bits =
+            static_cast<uint8_t>((v >> ((i * 8) + lo - shift)) << lo);
+        base[first + i] = (base[first + i] & ~mask) | (bits & mask);
+    }
+}
+} // namespace archimedes::detail
+
+namespace archimedes {
+// precomputed access to one bit field of up to 64 bits, built once per
+// reflected field when its record is loaded (see
+// reflected_field::bit_accessor()). the field is read as a single 1/2/4/8
+// byte little endian word placed so that it does not run past the end of the
+// record, then shifted, masked and sign extended without branches. fields
+// which fit in no such word (wider than 57 bits, or in records of odd sizes)
+// go through detail::load_bits/store_bits instead. stores only write the bytes
+// the field covers, as the word may include neighbouring members.
+struct bit_field_accessor {
+    // offset of word containing field, from start of record
+    uint32_t word_offset = 0;
+
+    // size of word in bytes, 0 if not a bit field
+    uint8_t word_size = 0;
+
+    // number of bytes the field covers
+    uint8_t store_size = 0;
+
+    // bit position of field in word
+    uint8_t shift = 0;
+
+    // width of field in bits
+    uint8_t bit_size = 0;
+
+    // 64 - bit_size if signed, 0 if not: sign extension is then always an
+    // arithmetic shift up and back down
+    uint8_t sign_shift = 0;
+
+    // true if field fits in no word, word_offset/shift are then the first
+    // byte of the field and position in it
+    bool is_bytewise = false;
+
+    // bit_size low bits
+    uint64_t mask = 0;
+
+    // accessor for bit field bit_size wide at bit_offset of a record
+    // record_size bytes large
+    static constexpr bit_field_accessor make(
+        size_t bit_offset,
+        size_t bit_size,
+        bool is_signed,
+        size_t record_size) {
+        bit_field_accessor a;
+        a.bit_size = static_cast<uint8_t>(bit_size);
+        a.mask = bit_size >= 64 ? ~uint64_t(0) : (uint64_t(1) << bit_size) - 1;
+        a.sign_shift =
+            is_signed && bit_size != 0 ?
+                static_cast<uint8_t>(64 - bit_size)
+                : 0;
+
+        if (bit_size == 0) {
+            return a;
+        }
+
+        a.store_size =
+            static_cast<uint8_t>(((bit_offset % 8) + bit_size + 7) / 8);
+
+        // smallest word inside the record which contains the field
+        const auto first = bit_offset / 8;
+        for (size_t w = 1; w <= 8 && w <= record_size; w *= 2) {
+            const auto start = std::min(first, record_size - w);
+            if (bit_offset - (start * 8) + bit_size <= w * 8) {
+                a.word_offset = static_cast<uint32_t>(start);
+                a.word_size = static_cast<uint8_t>(w);
+                a.shift = static_cast<uint8_t>(bit_offset - (start * 8));
+                return a;
+            }
+        }
+
+        a.word_offset = static_cast<uint32_t>(first);
+        a.word_size = 1;
+        a.shift = static_cast<uint8_t>(bit_offset % 8);
+        a.is_bytewise = true;
+        return a;
+    }
+
+    bool is_valid() const {
+        return this->word_size != 0;
+    }
+
+    // value of field in record, sign extended if signed
+    uint64_t load(const void *record) const {
+        const auto *p = static_cast<const uint8_t*>(record) + this->word_offset;
+        if (this->is_bytewise) {
+            return this->load_bytewise(p);
+        }
+
+        switch (this->word_size) {
+            case 1: return this->extract<uint8_t>(p);
+            case 2: return this->extract<uint16_t>(p);
+            case 4: return this->extract<uint32_t>(p);
+            default: return this->extract<uint64_t>(p);
+        }
+    }
+
+    // set field in record to low bit_size bits of v
+    void store(void *record, uint64_t v) const {
+        this->store_at(static_cast<uint8_t*>(record), v);
+    }
+
+    // load field of count records stride bytes apart into out, truncated to T
+    template <typename T>
+    void load_n(
+        const void *records,
+        size_t stride,
+        size_t count,
+        T *out) const {
+        const auto *p = static_cast<const uint8_t*>(records);
+        if (this->is_bytewise) {
+            p += this->word_offset;
+            for (size_t i = 0; i < count; i++, p += stride) {
+                out[i] = static_cast<T>(this->load_bytewise(p));
+            }
+            return;
+        }
+
+        switch (this->word_size) {
+            case 1: this->load_words<uint8_t>(p, stride, count, out); break;
+            case 2: this->load_words<uint16_t>(p, stride, count, out); break;
+            case 4: this->load_words<uint32_t>(p, stride, count, out); break;
+            default: this->load_words<uint64_t>(p, stride, count, out);
+        }
+    }
+
+    // store count values from in into field of records stride bytes apart
+    template <typename T>
+    void store_n(
+        void *records,
+        size_t stride,
+        size_t count,
+        const T *in) const {
+        auto *p = static_cast<uint8_t*>(records);
+        for (size_t i = 0; i < count; i++, p += stride) {
+            this->store_at(p, static_cast<uint64_t>(in[i]));
+        }
+    }
+
+private:
+    uint64_t load_bytewise(const uint8_t *p) const {
+        return detail::load_bits(
+            p, this->shift, this->bit_size, this->sign_shift != 0);
+    }
+
+    // p points to word
+    template <typename W>
+    uint64_t extract(const uint8_t *p) const {
+        W w;
+        std::memcpy(&w, p, sizeof(W));
+        const auto v = (uint64_t(w) >> this->shift) & this->mask;
+        return static_cast<uint64_t>(
+            static_cast<int64_t>(v << this->sign_shift) >> this->sign_shift);
+    }
+
+    // p points to record, writes store_size bytes from the first byte of the
+    // field
+    void store_at(uint8_t *p, uint64_t v) const {
+        p += this->word_offset + (this->shift / 8);
+        const auto shift = this->shift % 8;
+        switch (this->store_size) {
+            case 1: this->insert<uint8_t>(p, shift, v); break;
+            case 2: this->insert<uint16_t>(p, shift, v); break;
+            case 4: this->insert<uint32_t>(p, shift, v); break;
+            case 8: this->insert<uint64_t>(p, shift, v); break;
+            default: detail::store_bits(p, shift, this->bit_size, v);
+        }
+    }
+
+    template <typename W>
+    void insert(uint8_t *p, size_t shift, uint64_t v) const {
+        v &= this->mask;
+
+        W w;
+        std::memcpy(&w, p, sizeof(W));
+        w = static_cast<W>(
+            (w & ~static_cast<W>(this->mask << shift))
+                | static_cast<W>(v << shift));
+        std::memcpy(p, &w, sizeof(W));
+    }
+
+    template <typename W, typename T>
+    void load_words(
+        const uint8_t *p,
+        size_t stride,
+        size_t count,
+        T *out) const {
+        p += this->word_offset;
+        for (size_t i = 0; i < count; i++, p += stride) {
+            out[i] = static_cast<T>(this->extract<W>(p));
+        }
+    }
+};
+} // namespace archimedes
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+// equality and hash of a value of some type which cannot be compared bytewise
+// (fx. std::string), registered with object_comparer::set_compare
+struct compare_fns {
+    bool (*equals)(const void*, const void*) = nullptr;
+    uint64_t (*hash)(const void*) = nullptr;
+};
+
+// compiled equality/hash/diff plan for one reflected type
+// values are compared member by member in order of offset (recursing into
+// bases, nested records and arrays), never looking at padding. numeric values
+// are compared bitwise (so NaN == NaN if the bits are equal, -0.0 != 0.0) and
+// pointers by address.
+struct compare_plan {
+    struct op {
+        enum kind_type : uint8_t {
+            // memcmp run
+            BYTES,
+
+            // bit field(s)
+            BITS,
+
+            // compare_fns
+            CUSTOM,
+
+            // reflected operator== of a record which cannot be compared
+            // member by member, not hashed
+            MEMBER
+        };
+
+        kind_type kind;
+
+        // offset into object, in bits if BITS
+        size_t offset;
+
+        // size in bytes, in bits if BITS
+        size_t size;
+
+        // if CUSTOM
+        const compare_fns *fns = nullptr;
+
+        // if MEMBER, operator== and type of compared record
+        std::optional<reflected_function> member = std::nullopt;
+        type_id id = type_id::none();
+    };
+
+    // diffed member, fields of bases are flattened into the record
+    struct field {
+        std::string name;
+
+        // range of field_ops comparing this field
+        size_t first_op = 0, num_ops = 0;
+    };
+
+    type_id id = type_id::none();
+
+    // ops for equals/hash, adjacent runs merged across fields
+    vector<op> ops;
+
+    // ops for diff, never crossing fields
+    vector<op> field_ops;
+
+    // fields in order of offset, bit i of a diff mask is fields[i]. a type
+    // which is not a record has one unnamed field.
+    vector<field> fields;
+
+    // false if some ops are MEMBER, whose values do not contribute to hashes
+    bool is_fully_hashed = true;
+
+    // words needed for a diff mask
+    size_t mask_size() const {
+        return (this->fields.size() + 63) / 64;
+    }
+};
+
+// compiled deep equality, hashing and field diffs for reflected types. values
+// equal under equals() always have equal hash()es. types which cannot be
+// compared bytewise go through compare_fns from set_compare, std::string has
+// them by default; records containing other unsupported members fall back to
+// their reflected operator==, if any.
+// plans and compare_fns are per-instance, NOT thread safe.
+// implemented in common/compare.cpp
+struct object_comparer {
+    // registers compare_fns for std::string
+    object_comparer();
+
+    // use fns for all values of type id
+    // must be called before any plan using type id is compiled
+    void set_compare(type_id id, compare_fns fns);
+
+    template <typename T>
+    void set_compare(compare_fns fns) {
+        this->set_compare(type_id::from<T>(), fns);
+    }
+
+    // compare T with its operator== and hash it with std::hash<T>
+    template <typename T>
+    void set_compare() {
+        this->set_compare<T>(
+            compare_fns {
+                .equals =
+                    [](const void *a, const void *b) {
+                        return *static_cast<const T*>(a)
+                            == *static_cast<const T*>(b);
+                    },
+                .hash =
+                    [](const void *p) {
+                        return static_cast<uint64_t>(
+                            std::hash<T>()(*static_cast<const T*>(p)));
+                    }
+            });
+    }
+
+    // compiled plan for type, error if type is not reflected or contains a
+    // member which cannot be compared (reference, virtual base, etc.)
+    result<const compare_plan*, compare_error> plan(type_id id);
+
+    // true if objects a and b of type id are equal
+    result<bool, compare_error> equals(
+        type_id id,
+        const void *a,
+        const void *b);
+
+    // hash of object p of type id
+    result<uint64_t, compare_error> hash(type_id id, const void *p);
+
+    // set bit i of mask for each plan field i which differs between a and b,
+    // clearing all other bits. mask must have at least plan->mask_size() words.
+    // returns number of differing fields.
+    result<size_t, compare_error> diff(
+        type_id id,
+        const void *a,
+        const void *b,
+        std::span<uint64_t> mask);
+
+    template <typename T>
+    result<bool, compare_error> equals(const T &a, const T &b) {
+        return this->equals(type_id::from<T>(), &a, &b);
+    }
+
+    template <typename T>
+    result<uint64_t, compare_error> hash(const T &t) {
+        return this->hash(type_id::from<T>(), &t);
+    }
+
+    template <typename T>
+    result<size_t, compare_error> diff(
+        const T &a,
+        const T &b,
+        std::span<uint64_t> mask) {
+        return this->diff(type_id::from<T>(), &a, &b, mask);
+    }
+
+    // execute already compiled plans, for hot loops
+    static bool equals(const compare_plan &plan, const void *a, const void *b);
+    static uint64_t hash(const compare_plan &plan, const void *p);
+    static size_t diff(
+        const compare_plan &plan,
+        const void *a,
+        const void *b,
+        std::span<uint64_t> mask);
+
+private:
+    // append ops comparing value of type id at offset to ops
+    std::optional<compare_error> compile(
+        vector<compare_plan::op> &ops,
+        type_id id,
+        size_t offset);
+
+    // append ops comparing members of record at offset to ops
+    std::optional<compare_error> compile_record(
+        vector<compare_plan::op> &ops,
+        const reflected_record_type &record,
+        size_t offset);
+
+    map<type_id, compare_fns> fns;
+    map<type_id, std::unique_ptr<compare_plan>> plans;
+};
+} // namespace archimedes
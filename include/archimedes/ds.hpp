@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <type_traits>
 #include "errors.hpp"
@@ -37,10 +38,10 @@ using set = ARCHIMEDES_SET_TYPE<T>;
 template <typename V>
     requires (
         requires (V v) {
-            { v.name } -> std::convertible_to<std::string>;
+            { v.name } -> std::convertible_to<std::string_view>;
         })
 struct name_map_default_getter {
-    std::string operator()(const V &v) const {
+    std::string_view operator()(const V &v) const {
         return v.name;
     }
 };
@@ -49,8 +50,8 @@ struct name_map_default_getter {
 // by using (N::operator()(const V&) const) to retrieve string_view names under
 // initialization
 template <typename V, typename N = name_map_default_getter<V>>
-struct name_map : public map<std::string, V> {
-    using Base = map<std::string, V>;
+struct name_map : public map<std::string_view, V> {
+    using Base = map<std::string_view, V>;
     using Base::Base;
 
     using key_type = typename Base::key_type;
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "ds.hpp"
+
+namespace archimedes::detail {
+// precomputed conversion tables for an enum, built by the plugin and
+// serialized with the enum's type_info. values are stored zero-extended from
+// the width of the enum's integer type, fx. -1 in an enum of type int is
+// 0xFFFFFFFF, and all lookups are non-allocating.
+struct enum_tables {
+    static constexpr uint32_t NO_ENTRY = std::numeric_limits<uint32_t>::max();
+
+    struct entry {
+        std::string_view name;
+        std::uintmax_t value;
+    };
+
+    // all enumerators sorted by value, ties in declaration order
+    vector<entry> entries;
+
+    // mask of bits in the enum's integer type
+    std::uintmax_t value_mask = std::numeric_limits<std::uintmax_t>::max();
+
+    // true if the enum's integer type is signed
+    bool is_signed = false;
+
+    // if not empty, enum values are contiguous enough for a direct lookup:
+    // dense[(value - dense_min) & value_mask] is the index of the first entry
+    // with value, or NO_ENTRY
+    std::uintmax_t dense_min = 0;
+    vector<uint32_t> dense;
+
+    // perfect hash (hash and displace) of names: the entry for name is at
+    // hash_slots[slot(h, hash_displacements[bucket(h)])] with
+    // h = hash(name, hash_seed). empty if no perfect hash was found, names
+    // are then searched linearly
+    uint64_t hash_seed = 0;
+    vector<uint32_t> hash_displacements;
+    vector<uint32_t> hash_slots;
+
+    // if not empty, enum is a flag enum (all values are made up of single
+    // bit enumerators). indices of single bit entries in ascending order.
+    vector<uint32_t> flags;
+
+    // build tables from enumerators in declaration order
+    // implemented in common/enum_tables.cpp
+    static enum_tables build(
+        std::span<const entry> enumerators,
+        std::uintmax_t value_mask,
+        bool is_signed);
+
+    // seeded FNV-1a
+    static constexpr uint64_t hash(std::string_view s, uint64_t seed) {
+        uint64_t h = 14695981039346656037u ^ (seed * 0x9E3779B97F4A7C15u);
+        for (const char c : s) {
+            h = (h ^ static_cast<uint8_t>(c)) * 1099511628211u;
+        }
+        return h;
+    }
+
+    // splitmix64 finalizer
+    static constexpr uint64_t mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9u;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBu;
+        return x ^ (x >> 31);
+    }
+
+    size_t bucket(uint64_t h) const {
+        return (h >> 32) & (this->hash_displacements.size() - 1);
+    }
+
+    size_t slot(uint64_t h, uint32_t displacement) const {
+        return mix(h + displacement) & (this->hash_slots.size() - 1);
+    }
+
+    // convert some enum or integral value into the stored representation
+    template <typename T>
+        requires (std::is_enum_v<T> || std::is_integral_v<T>)
+    std::uintmax_t to_bits(T t) const {
+        if constexpr (std::is_enum_v<T>) {
+            return static_cast<std::uintmax_t>(
+                static_cast<std::underlying_type_t<T>>(t)) & this->value_mask;
+        } else {
+            return static_cast<std::uintmax_t>(t) & this->value_mask;
+        }
+    }
+
+    // stored representation -> T, sign extending for signed enums
+    template <typename T>
+    T from_bits(std::uintmax_t v) const {
+        const auto sign = (this->value_mask >> 1) + 1;
+        if (this->is_signed && (v & sign)) {
+            return static_cast<T>(
+                static_cast<std::intmax_t>(v | ~this->value_mask));
+        }
+        return static_cast<T>(v);
+    }
+
+    // first entry with value v
+    const entry *by_value(std::uintmax_t v) const {
+        if (!this->dense.empty()) {
+            const auto i = (v - this->dense_min) & this->value_mask;
+            if (i >= this->dense.size() || this->dense[i] == NO_ENTRY) {
+                return nullptr;
+            }
+            return &this->entries[this->dense[i]];
+        }
+
+        // first entry with value >= v
+        size_t lo = 0, hi = this->entries.size();
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo) / 2;
+            if (this->entries[mid].value < v) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        return lo != this->entries.size() && this->entries[lo].value == v ?
+            &this->entries[lo]
+            : nullptr;
+    }
+
+    // entry with name
+    const entry *by_name(std::string_view name) const {
+        // no hash table could be built, see build()
+        if (this->hash_slots.empty()) {
+            for (const auto &e : this->entries) {
+                if (e.name == name) {
+                    return &e;
+                }
+            }
+            return nullptr;
+        }
+
+        const auto h = hash(name, this->hash_seed);
+        const auto i =
+            this->hash_slots[
+                this->slot(h, this->hash_displacements[this->bucket(h)])];
+        return i != NO_ENTRY && this->entries[i].name == name ?
+            &this->entries[i]
+            : nullptr;
+    }
+
+    // call f(name) for each flag set in v, returns bits of v which are not
+    // covered by any flag
+    template <typename F>
+    std::uintmax_t for_each_flag(std::uintmax_t v, F &&f) const {
+        for (const auto i : this->flags) {
+            const auto &e = this->entries[i];
+            if ((v & e.value) == e.value) {
+                f(e.name);
+                v &= ~e.value;
+            }
+        }
+        return v;
+    }
+};
+} // namespace archimedes::detail
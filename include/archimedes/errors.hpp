@@ -64,6 +64,88 @@ enum class any_error {
     INVALID_TYPE
 };
 
+// object factory error codes
+enum class factory_error {
+    COULD_NOT_REFLECT,
+    NO_DEFAULT_CTOR,
+    INVALID_TYPE
+};
+
+// field path error codes
+enum class path_error {
+    COULD_NOT_REFLECT,
+    SYNTAX,
+    NO_SUCH_FIELD,
+    NOT_A_RECORD,
+    NOT_AN_ARRAY,
+    OUT_OF_RANGE
+};
+
+// gather/scatter error codes
+enum class gather_error {
+    COULD_NOT_REFLECT,
+    UNSUPPORTED_TYPE,
+    SIZE_MISMATCH,
+    BUFFER_TOO_SMALL,
+    WRONG_TYPE
+};
+
+// structure of arrays error codes
+enum class soa_error {
+    COULD_NOT_REFLECT,
+    UNSUPPORTED_TYPE
+};
+
+// binary serializer error codes
+enum class binary_error {
+    COULD_NOT_REFLECT,
+    UNSUPPORTED_TYPE,
+    BUFFER_TOO_SMALL,
+    TRUNCATED,
+    BAD_SCHEMA,
+    SCHEMA_MISMATCH
+};
+
+// json serializer error codes
+enum class json_error {
+    COULD_NOT_REFLECT,
+    UNSUPPORTED_TYPE,
+    SYNTAX,
+    TYPE_MISMATCH,
+    OUT_OF_RANGE,
+    UNKNOWN_ENUM_VALUE
+};
+
+// object comparer error codes
+enum class compare_error {
+    COULD_NOT_REFLECT,
+    UNSUPPORTED_TYPE,
+    BUFFER_TOO_SMALL
+};
+
+// replicator error codes
+enum class replication_error {
+    COULD_NOT_REFLECT,
+    UNSUPPORTED_TYPE,
+    UNKNOWN_FIELD,
+    COUNT_MISMATCH,
+    BUFFER_TOO_SMALL,
+    TRUNCATED,
+    BAD_PATCH
+};
+
+// archive error codes
+enum class archive_error {
+    COULD_NOT_REFLECT,
+    UNSUPPORTED_TYPE,
+    DUPLICATE_SECTION,
+    IO_ERROR,
+    BAD_ARCHIVE,
+    LAYOUT_MISMATCH,
+    NOT_FOUND,
+    WRONG_TYPE
+};
+
 // basic result type
 template <typename T, typename E>
 struct result : public std::variant<T, E> {
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "value_ops.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+// pool of objects of one reflected type, allocated in slabs from a
+// std::pmr::memory_resource and default constructed/destroyed with the type's
+// value_ops. objects never move once created. NOT thread safe.
+// implemented in common/factory.cpp
+struct object_pool {
+    // type must have a default ctor (value_ops::construct), see
+    // object_factory::pool() for a checked way to make pools
+    explicit object_pool(
+        const reflected_type &type,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource(),
+        size_t objects_per_slab = 64);
+
+    object_pool(const object_pool&) = delete;
+    object_pool &operator=(const object_pool&) = delete;
+
+    // destroys all live objects and frees all slabs
+    ~object_pool();
+
+    // type of objects in this pool
+    reflected_type type() const {
+        return this->_type;
+    }
+
+    // create one default constructed object
+    void *create();
+
+    // create out.size() default constructed objects into out
+    void create_n(std::span<void*> out);
+
+    // destroy object previously returned by create()/create_n()
+    void destroy(void *p);
+
+    // destroy multiple objects
+    void destroy_n(std::span<void *const> ps);
+
+    // destroy all live objects, slabs are kept for reuse
+    void clear();
+
+    // clear() and free all slabs
+    void release();
+
+    // number of live objects
+    size_t size() const {
+        return this->num_live;
+    }
+
+    // number of objects which can be live without allocating another slab
+    size_t capacity() const {
+        return this->num_slots;
+    }
+
+    // true if p is a live object in this pool
+    bool owns(const void *p) const;
+
+    // distance between consecutive objects in a slab
+    size_t stride() const {
+        return this->_stride;
+    }
+
+private:
+    struct slab {
+        uint8_t *data;
+        size_t count;
+
+        // bit i is set if object i is live
+        std::pmr::vector<uint64_t> live;
+    };
+
+    // slab containing p, nullptr if none
+    slab *find_slab(const void *p);
+    const slab *find_slab(const void *p) const;
+
+    // allocate a slab of at least count objects and add its slots to the free
+    // list
+    void grow(size_t count);
+
+    reflected_type _type;
+    const value_ops *ops;
+    std::pmr::memory_resource *resource;
+    size_t objects_per_slab;
+    size_t _stride;
+    size_t alignment;
+
+    // slabs sorted by address
+    std::pmr::vector<slab> slabs;
+
+    // free slots are linked through their first sizeof(void*) bytes
+    void *free_list = nullptr;
+
+    size_t num_live = 0, num_slots = 0;
+};
+
+// hands out objects of reflected types by type_id or name from per-type
+// object_pools sharing one memory resource. NOT thread safe.
+// implemented in common/factory.cpp
+struct object_factory {
+    explicit object_factory(
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource(),
+        size_t objects_per_slab = 64)
+        : resource(resource),
+          objects_per_slab(objects_per_slab) {}
+
+    // pool for type, created on first use
+    result<object_pool*, factory_error> pool(type_id id);
+
+    // pool for type by name
+    result<object_pool*, factory_error> pool(std::string_view name);
+
+    // create one default constructed object of type
+    result<void*, factory_error> create(type_id id);
+
+    // create one default constructed object of type by name
+    result<void*, factory_error> create(std::string_view name);
+
+    // create one default constructed T
+    template <typename T>
+    result<T*, factory_error> create() {
+        auto r = this->create(type_id::from<T>());
+        return r ?
+            result<T*, factory_error>(static_cast<T*>(*r))
+            : result<T*, factory_error>(r.unwrap_error());
+    }
+
+    // create out.size() default constructed objects of type into out
+    result<object_pool*, factory_error> create_n(
+        type_id id,
+        std::span<void*> out);
+
+    // destroy object of type previously created by this factory
+    void destroy(type_id id, void *p);
+
+    // destroy multiple objects of type
+    void destroy_n(type_id id, std::span<void *const> ps);
+
+    // destroy all live objects in all pools
+    void clear();
+
+private:
+    std::pmr::memory_resource *resource;
+    size_t objects_per_slab;
+    map<type_id, std::unique_ptr<object_pool>> pools;
+};
+} // namespace archimedes
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string_view>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "bits.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+// accessor for a nested field, compiled once by compile_path from a path like
+// "transform.position.x" or "bones[3].rotation". all field/base/array hops
+// fold into one constant offset, except for hops through virtual bases which
+// need a dynamic cast. resolving a path does no lookups.
+struct field_path {
+    // hop through a virtual base
+    struct step {
+        // offset to the record containing the base
+        size_t offset;
+        reflected_base base;
+    };
+
+    // type path is compiled for
+    type_id root = type_id::none();
+
+    // type of field at end of path
+    type_id leaf = type_id::none();
+
+    // casts through virtual bases, in order
+    vector<step> steps;
+
+    // offset of leaf after steps, of the record containing it if bit field
+    size_t offset = 0;
+
+    // if leaf is a bit field, accessor for it relative to its record
+    bit_field_accessor bits = {};
+
+    bool is_bit_field() const {
+        return this->bits.is_valid();
+    }
+
+    // pointer to leaf in object p of type root. for bit fields this is the
+    // record containing the bit field.
+    void *resolve(void *p) const {
+        auto *q = static_cast<uint8_t*>(p);
+        for (const auto &s : this->steps) {
+            q = static_cast<uint8_t*>(s.base.cast_up(q + s.offset));
+        }
+        return q + this->offset;
+    }
+
+    const void *resolve(const void *p) const {
+        return this->resolve(const_cast<void*>(p));
+    }
+
+    // reference to leaf of object p, T must be the leaf type
+    // NOTE: not for bit fields
+    template <typename T>
+    T &get(void *p) const {
+        return *static_cast<T*>(this->resolve(p));
+    }
+
+    template <typename T>
+    const T &get(const void *p) const {
+        return *static_cast<const T*>(this->resolve(p));
+    }
+
+    // value of bit field leaf of object p (sign extended if signed)
+    uint64_t get_bits(const void *p) const {
+        return this->bits.load(this->resolve(p));
+    }
+
+    // set bit field leaf of object p to the low bits of v
+    void set_bits(void *p, uint64_t v) const {
+        this->bits.store(this->resolve(p), v);
+    }
+};
+
+// compile path of fields from record type id. segments are separated by '.',
+// each a field name followed by any number of array indices ("a[1][2]").
+// fields of bases are found through the bases, a segment naming a base type
+// explicitly hops into that base ("Base.x").
+// implemented in common/field_path.cpp
+result<field_path, path_error> compile_path(type_id id, std::string_view path);
+
+template <typename T>
+inline result<field_path, path_error> compile_path(std::string_view path) {
+    return compile_path(type_id::from<T>(), path);
+}
+} // namespace archimedes
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include "errors.hpp"
+#include "types.hpp"
+
+namespace archimedes {
+// instruction set used by gather/scatter, picked once at runtime
+enum class simd_level {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// best simd_level supported by this machine, SCALAR if built without x86 simd
+// support or with ARCHIMEDES_NO_SIMD defined
+// implemented in common/gather.cpp
+simd_level gather_simd_level();
+
+namespace detail {
+// use the gather kernels of level, or of the best supported level below it if
+// this machine does not support it. returns the level now in use.
+// NOTE: for testing each kernel, not thread safe
+// implemented in common/gather.cpp
+simd_level set_gather_simd_level(simd_level level);
+
+// error if field is not at the same offset in objects of type as in its parent
+// (it is declared on type or on a base of it at offset 0)
+// implemented in common/gather.cpp
+std::optional<gather_error> check_field_of(
+    const reflected_field &field,
+    type_id type);
+} // namespace detail
+
+// size of one gathered value of field (size of its type), error if field
+// cannot be gathered
+// implemented in common/gather.cpp
+result<size_t, gather_error> column_size(const reflected_field &field);
+
+// copy field of count objects, starting at objects and stride bytes apart, into
+// out as a packed array of the field's type. 4 and 8 byte fields use vector
+// gathers where supported, bit fields are widened to their declared type
+// (sign extended if signed). objects must be of the field's parent type and
+// its type must be trivially copyable. returns number of objects gathered.
+// implemented in common/gather.cpp
+result<size_t, gather_error> gather(
+    const reflected_field &field,
+    const void *objects,
+    size_t stride,
+    size_t count,
+    void *out);
+
+// inverse of gather, copy count packed values from in into field of each
+// object. bit fields are truncated to their width.
+// implemented in common/gather.cpp
+result<size_t, gather_error> scatter(
+    const reflected_field &field,
+    void *objects,
+    size_t stride,
+    size_t count,
+    const void *in);
+
+// gather field of out.size() objects, F must be the size of the field's type
+template <typename F>
+inline result<size_t, gather_error> gather(
+    const reflected_field &field,
+    const void *objects,
+    size_t stride,
+    std::span<F> out) {
+    const auto size = column_size(field);
+    if (!size) {
+        return size.unwrap_error();
+    } else if (*size != sizeof(F)) {
+        return gather_error::SIZE_MISMATCH;
+    }
+
+    return gather(field, objects, stride, out.size(), out.data());
+}
+
+template <typename F>
+inline result<size_t, gather_error> scatter(
+    const reflected_field &field,
+    void *objects,
+    size_t stride,
+    std::span<const F> in) {
+    const auto size = column_size(field);
+    if (!size) {
+        return size.unwrap_error();
+    } else if (*size != sizeof(F)) {
+        return gather_error::SIZE_MISMATCH;
+    }
+
+    return scatter(field, objects, stride, in.size(), in.data());
+}
+
+// gather field of every T in ts into out. error if field is declared on a
+// base of T at a nonzero offset.
+template <typename F, typename T>
+inline result<size_t, gather_error> gather(
+    const reflected_field &field,
+    std::span<const T> ts,
+    std::span<F> out) {
+    if (out.size() < ts.size()) {
+        return gather_error::BUFFER_TOO_SMALL;
+    } else if (const auto err =
+            detail::check_field_of(field, type_id::from<T>())) {
+        return *err;
+    }
+
+    return gather(field, ts.data(), sizeof(T), out.subspan(0, ts.size()));
+}
+
+// scatter in into field of every T in ts
+template <typename F, typename T>
+inline result<size_t, gather_error> scatter(
+    const reflected_field &field,
+    std::span<T> ts,
+    std::span<const F> in) {
+    if (in.size() < ts.size()) {
+        return gather_error::BUFFER_TOO_SMALL;
+    } else if (const auto err =
+            detail::check_field_of(field, type_id::from<T>())) {
+        return *err;
+    }
+
+    return scatter(field, ts.data(), sizeof(T), in.subspan(0, ts.size()));
+}
+} // namespace archimedes
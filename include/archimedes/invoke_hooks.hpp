@@ -0,0 +1,107 @@
+#pragma once
+
+// instrumentation of reflected function invocations, only present if
+// ARCHIMEDES_INVOKE_HOOKS is defined. NOTE: this changes the layout of
+// function_type_info, so it must be defined (or not) for the runtime library
+// and every translation unit which includes archimedes alike
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <functional>
+#include <span>
+
+#include "any.hpp"
+#include "invoke.hpp"
+
+namespace archimedes {
+struct reflected_function;
+
+// per-function call counter and latency histogram
+// updated with relaxed atomics, values are approximate while calls are in
+// flight on other threads
+struct invoke_stats {
+    // bucket i counts calls which took [2^(i - 1), 2^i) ns, the last bucket
+    // counts everything longer
+    static constexpr size_t NUM_BUCKETS = 32;
+
+    std::atomic<uint64_t> calls = 0;
+    std::atomic<uint64_t> total_ns = 0;
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> histogram = {};
+
+    static constexpr size_t bucket(uint64_t ns) {
+        return std::min<size_t>(std::bit_width(ns), NUM_BUCKETS - 1);
+    }
+
+    // upper bound of bucket i
+    static constexpr std::chrono::nanoseconds bucket_limit(size_t i) {
+        return std::chrono::nanoseconds(uint64_t(1) << i);
+    }
+
+    void record(std::chrono::nanoseconds t) {
+        const auto ns = static_cast<uint64_t>(std::max<int64_t>(t.count(), 0));
+        this->total_ns.fetch_add(ns, std::memory_order_relaxed);
+        this->histogram[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::chrono::nanoseconds total_time() const {
+        return std::chrono::nanoseconds(
+            this->total_ns.load(std::memory_order_relaxed));
+    }
+
+    std::chrono::nanoseconds mean_time() const {
+        const auto n = this->calls.load(std::memory_order_relaxed);
+        return std::chrono::nanoseconds(
+            n == 0 ? 0 : this->total_ns.load(std::memory_order_relaxed) / n);
+    }
+
+    // upper bound of bucket containing the p-th (0..1) percentile latency
+    std::chrono::nanoseconds percentile(double p) const {
+        uint64_t total = 0;
+        for (const auto &b : this->histogram) {
+            total += b.load(std::memory_order_relaxed);
+        }
+
+        const auto target = static_cast<uint64_t>(p * total);
+        uint64_t n = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; i++) {
+            n += this->histogram[i].load(std::memory_order_relaxed);
+            if (n > target || (n == total && n != 0)) {
+                return bucket_limit(i);
+            }
+        }
+
+        return std::chrono::nanoseconds(0);
+    }
+
+    void reset() {
+        this->calls.store(0, std::memory_order_relaxed);
+        this->total_ns.store(0, std::memory_order_relaxed);
+        for (auto &b : this->histogram) {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// user sampling callback, see set_invoke_hook()
+using invoke_hook =
+    std::function<void(
+        const reflected_function&,
+        const invoke_result&,
+        std::chrono::nanoseconds)>;
+
+namespace detail {
+struct function_type_info;
+
+// invoke f, recording statistics and calling the invoke hook
+// implemented in common/invoke_hooks.cpp
+invoke_result invoke_instrumented(
+    const function_type_info &f,
+    std::span<any> args);
+} // namespace detail
+} // namespace archimedes
+
+#endif
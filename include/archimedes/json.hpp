@@ -0,0 +1,101 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+// compiled json layout of one reflected type, see json_serializer
+struct json_plan {
+    enum kind_type : uint8_t {
+        BOOL,
+        SIGNED,
+        UNSIGNED,
+        FLOAT,
+        ENUM,
+        STRING,
+        CHARS,
+        ARRAY,
+        RECORD
+    };
+
+    struct field {
+        std::string name;
+
+        // "\"name\":", written before value
+        std::string key;
+
+        // offset into record, in bits if bit field
+        size_t offset = 0;
+
+        // width of bit field, 0 if not a bit field
+        size_t bit_size = 0;
+
+        // plan for field type
+        const json_plan *plan = nullptr;
+    };
+
+    type_id id = type_id::none();
+    kind_type kind = RECORD;
+    size_t size = 0;
+
+    // if ENUM
+    std::optional<reflected_enum_type> enum_type;
+    bool is_signed_enum = false;
+
+    // if ARRAY/CHARS
+    const json_plan *element = nullptr;
+    size_t length = 0, stride = 0;
+
+    // if RECORD, fields of record and its bases in order of offset
+    vector<field> fields;
+
+    // if RECORD, index into fields by name
+    map<std::string_view, size_t> field_indices;
+};
+
+// streaming json writer/reader for reflected types, working directly on object
+// memory through plans compiled per type on first use. records are written as
+// objects (with fields of bases flattened in), arrays as arrays, enums by name
+// ("A|B" for flags) and std::string/char arrays as strings. on read unknown
+// keys are skipped, missing fields and nulls leave values untouched.
+// plans are per-instance, NOT thread safe.
+// implemented in common/json.cpp
+struct json_serializer {
+    // compiled plan for type, error if type is not reflected or contains
+    // values which have no json representation (pointers, unions, etc.)
+    result<const json_plan*, json_error> plan(type_id id);
+
+    // append json for object p of type id to out
+    std::optional<json_error> write(
+        type_id id,
+        const void *p,
+        std::string &out);
+
+    // parse one json value from in into object p of type id, returns number of
+    // characters read. p must be a constructed object.
+    result<size_t, json_error> read(type_id id, void *p, std::string_view in);
+
+    template <typename T>
+    std::optional<json_error> write(const T &t, std::string &out) {
+        return this->write(type_id::from<T>(), &t, out);
+    }
+
+    template <typename T>
+    result<size_t, json_error> read(T &t, std::string_view in) {
+        return this->read(type_id::from<T>(), &t, in);
+    }
+
+private:
+    map<type_id, std::unique_ptr<json_plan>> plans;
+
+    // unescaped strings while reading
+    std::string scratch;
+};
+} // namespace archimedes
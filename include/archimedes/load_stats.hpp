@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <string_view>
+
+#include "ds.hpp"
+
+namespace archimedes {
+// statistics for a single module (translation unit) loaded by load()
+struct module_load_stats {
+    // source file of module
+    std::string_view name;
+
+    // time spent deserializing module data
+    std::chrono::nanoseconds deserialize_time;
+
+    // time spent patching and merging module data into the registry
+    std::chrono::nanoseconds merge_time;
+
+    size_t types, functions, collisions;
+
+    // size of serialized data
+    size_t bytes_read;
+};
+
+// approximate heap memory used by the registry, in bytes
+struct memory_stats {
+    // string arena
+    size_t strings = 0;
+
+    // map nodes and buckets
+    size_t maps = 0;
+
+    // vector storage
+    size_t vectors = 0;
+
+    // constexpr static field and template parameter values
+    size_t constexpr_values = 0;
+
+    size_t total() const {
+        return this->strings
+            + this->maps
+            + this->vectors
+            + this->constexpr_values;
+    }
+};
+
+struct load_statistics {
+    // per-module statistics, only present if enabled before load()
+    vector<module_load_stats> modules;
+
+    // total time spent in load(), zero if not enabled
+    std::chrono::nanoseconds total_time = {};
+
+    memory_stats memory;
+};
+}
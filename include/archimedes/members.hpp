@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+#include "type_kind.hpp"
+#include "types.hpp"
+#include "ds.hpp"
+
+namespace archimedes::detail {
+// shared helpers for the record walking serializers/comparers
+
+// true if values of kind are signed integers
+inline bool is_signed_kind(type_kind kind) {
+    return (kind >= I_CHAR && kind <= I_LONG_LONG)
+        || (kind == CHAR && std::is_signed_v<char>);
+}
+
+// read unsigned integer of size (1/2/4/8) bytes at p
+inline uint64_t load_uint(const void *p, size_t size) {
+    switch (size) {
+        case 1: { uint8_t v; std::memcpy(&v, p, 1); return v; }
+        case 2: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+        case 4: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        default: { uint64_t v; std::memcpy(&v, p, 8); return v; }
+    }
+}
+
+// store low size (1/2/4/8) bytes of v at p
+inline void store_uint(void *p, size_t size, uint64_t v) {
+    switch (size) {
+        case 1: { const auto w = uint8_t(v); std::memcpy(p, &w, 1); break; }
+        case 2: { const auto w = uint16_t(v); std::memcpy(p, &w, 2); break; }
+        case 4: { const auto w = uint32_t(v); std::memcpy(p, &w, 4); break; }
+        default: std::memcpy(p, &v, 8);
+    }
+}
+
+// field of a record or one of its bases at its position in the record
+struct record_member {
+    // position in bits
+    size_t bit_position;
+
+    // offset of record containing field
+    size_t offset;
+
+    reflected_field field;
+};
+
+// append fields of record and its bases at offset to members, false if a
+// record has virtual bases (their offsets depend on the most derived type)
+inline bool collect_members(
+    const reflected_record_type &record,
+    size_t offset,
+    vector<record_member> &members) {
+    if (!record.vbases().empty()) {
+        return false;
+    }
+
+    for (const auto &b : record.bases()) {
+        if (!collect_members(b.type(), offset + b.offset(), members)) {
+            return false;
+        }
+    }
+
+    for (const auto &f : record.fields()) {
+        members.push_back(
+            record_member {
+                .bit_position =
+                    f.is_bit_field() ?
+                        (offset * 8) + *f.bit_offset()
+                        : (offset + f.offset()) * 8,
+                .offset = offset,
+                .field = f
+            });
+    }
+
+    return true;
+}
+
+// fields of record and its bases in order of position, nullopt if it has
+// virtual bases
+inline std::optional<vector<record_member>> record_members(
+    const reflected_record_type &record) {
+    vector<record_member> members;
+    if (!collect_members(record, 0, members)) {
+        return std::nullopt;
+    }
+
+    std::stable_sort(
+        members.begin(),
+        members.end(),
+        [](const record_member &a, const record_member &b) {
+            return a.bit_position < b.bit_position;
+        });
+    return members;
+}
+} // namespace archimedes::detail
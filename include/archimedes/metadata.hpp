@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+namespace archimedes {
+// categories of optional metadata, the emitted subset is configured through
+// the plugin argument "level-{minimal,runtime,full}"
+enum metadata : uint8_t {
+    METADATA_NONE = 0,
+
+    // definition paths of types and functions
+    METADATA_DEFINITION_PATHS = (1 << 0),
+
+    // mangled type names
+    METADATA_MANGLED_NAMES = (1 << 1),
+
+    // annotations on types, fields, static fields, and functions
+    METADATA_ANNOTATIONS = (1 << 2),
+
+    // names of function parameters
+    METADATA_PARAMETER_NAMES = (1 << 3),
+
+    // typedef-s/using-s, both on records and global
+    METADATA_TYPEDEFS = (1 << 4),
+
+    // implicit functions which are not required by the runtime (implicit move
+    // constructors and copy/move assignment operators)
+    METADATA_IMPLICIT_FUNCTIONS = (1 << 5),
+
+    METADATA_ALL = (1 << 6) - 1
+};
+
+constexpr metadata operator|(metadata a, metadata b) {
+    return static_cast<metadata>(
+        static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+}
+
+constexpr metadata operator&(metadata a, metadata b) {
+    return static_cast<metadata>(
+        static_cast<uint8_t>(a) & static_cast<uint8_t>(b));
+}
+
+constexpr metadata operator~(metadata a) {
+    return static_cast<metadata>(~static_cast<uint8_t>(a) & METADATA_ALL);
+}
+
+// "level-full": everything
+inline constexpr auto METADATA_LEVEL_FULL = METADATA_ALL;
+
+// "level-runtime": everything which can be queried through the runtime
+inline constexpr auto METADATA_LEVEL_RUNTIME =
+    METADATA_ALL & ~(METADATA_DEFINITION_PATHS | METADATA_MANGLED_NAMES);
+
+// "level-minimal": only what is required for lookup by name (including through
+// typedefs), fields, and invocation
+inline constexpr auto METADATA_LEVEL_MINIMAL = METADATA_TYPEDEFS;
+} // namespace archimedes
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <span>
 
@@ -7,6 +8,7 @@
 #include "type_info.hpp"
 #include "types.hpp"
 #include "serialize.hpp"
+#include "load_stats.hpp"
 #include "ds.hpp"
 
 namespace archimedes {
@@ -15,6 +17,38 @@ using collision_callback =
     std::function<reflected_type(reflected_type, reflected_type)>;
 
 namespace detail {
+// signature of emitted dynamic cast functions
+using dyncast_ptr = void*(*)(void*);
+
+// signature of emitted functions producing constant values
+using value_thunk = any(*)();
+
+// per-type reflection data emitted by the plugin in "gc-sections" mode
+// each entry is placed in its own section and points to the entries of all
+// types it references, so that linking with --gc-sections (-dead_strip on
+// macOS) keeps exactly the types reachable from some module's roots
+struct module_type_entry {
+    // serialized type_info, array indices are into the spans below
+    std::span<const uint8_t> data;
+
+    // string table for data
+    std::span<const uint8_t> strings;
+
+    // entries of referenced types (nullptr if discarded by the linker)
+    std::span<const module_type_entry *const> deps;
+
+    std::span<const dyncast_ptr> dyncasts;
+    std::span<const value_thunk> constexpr_values;
+    std::span<const invoker_ptr> invokers;
+    std::span<const value_thunk> template_param_values;
+
+    // typeid(...).hash_code() of type, nullptr if not available
+    size_t (*type_id_hash)() = nullptr;
+
+    // lifetime operations of type, nullptr if not emitted
+    const value_ops *ops = nullptr;
+};
+
 // global type registry
 struct registry {
     // implemented in runtime/archimedes.cpp (must be linked!)
@@ -64,17 +98,27 @@ struct registry {
     // NOTE: INTERNAL USE ONLY!
     // called from each archimedes translation unit to load stored data
     void load_module(
+        std::string_view name,
         const vector<std::function<void*(void*)>> &dyncasts,
         const vector<any> &constexpr_values,
         const vector<invoker_ptr> &invokers,
         const vector<any> &template_param_values,
         const vector<size_t> &type_id_hashes,
+        const vector<const value_ops*> &ops,
+        std::span<const uint8_t> strings_data,
         std::span<const uint8_t> functions_data,
         std::span<const uint8_t> types_data,
         std::span<const uint8_t> typedefs_data,
         std::span<const uint8_t> aliases_data,
         std::span<const uint8_t> usings_data);
 
+    // NOTE: INTERNAL USE ONLY!
+    // called from each archimedes translation unit emitted in "gc-sections"
+    // mode, loads all entries transitively reachable from roots
+    void load_module_entries(
+        std::string_view name,
+        std::span<const module_type_entry *const> roots);
+
     // load a set of types into the registry
     // TODO: std::move values
     void load_types(const vector<type_info> is);
@@ -107,7 +151,7 @@ struct registry {
                         && !n.starts_with(nu.used)) {
                     // replace with used namespace, try again
                     auto replaced =
-                        nu.used
+                        std::string(nu.used)
                             + std::string(n.substr(nu.containing.length()));
                     if (g(replaced)) {
                         return true;
@@ -124,11 +168,41 @@ struct registry {
     mutable bool _loaded = false;
     vector<std::function<void(void)>> loaders;
 
+    // module type entries which have already been loaded
+    set<const module_type_entry*> loaded_entries;
+
+    // storage for all strings referenced by loaded type info
+    string_arena strings;
+
+    // if true, per-module statistics are collected during load()
+    bool collect_load_stats = false;
+    vector<module_load_stats> module_stats;
+    std::chrono::nanoseconds load_time = {};
+
+    // number of type collisions resolved so far
+    size_t num_collisions = 0;
+
+    // approximate memory usage of registry
+    memory_stats memory() const;
+
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+    // sampling callback, called for every hook_period-th invocation of each
+    // function
+    invoke_hook hook;
+    size_t hook_period = 1;
+
+    // invocation statistics by invoker, shared by all copies of a function
+    map<invoker_ptr, std::unique_ptr<invoke_stats>> invoke_stats_by_invoker;
+
+    // point stats of all loaded functions into invoke_stats_by_invoker
+    void assign_invoke_stats();
+#endif
+
     // backing storage containers
     map<size_t, type_info*> types_by_type_id_hashes;
     map<type_id, type_info> types_by_id;
     map<type_id, vector<function_type_info>> functions_by_type;
-    map<std::string, vector<function_overload_set>> functions_by_name;
+    map<std::string_view, vector<function_overload_set>> functions_by_name;
     vector<namespace_alias_info> namespace_aliases;
     vector<namespace_using_info> namespace_usings;
     vector<typedef_info> typedefs;
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "any_vector.hpp"
+#include "binary.hpp"
+#include "compare.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+// replicated fields of one reflected record type, see replicator
+struct replication_plan {
+    struct field {
+        enum kind_type : uint8_t {
+            // bool/char/integer/enum, sent as zigzag varint delta
+            INTEGER,
+
+            // bit field, sent as zigzag varint delta
+            BITS,
+
+            // float/double, sent raw or as varint delta of quantized value
+            FLOAT,
+
+            // anything else, sent whole with binary_serializer
+            VALUE
+        };
+
+        std::string name;
+        kind_type kind;
+
+        // offset into record, in bits if BITS
+        size_t offset = 0;
+
+        // size in bytes, in bits if BITS
+        size_t size = 0;
+
+        // if FLOAT, quantization step (0 if sent exactly)
+        double quantum = 0.0;
+
+        // if VALUE
+        const binary_plan *binary = nullptr;
+        const compare_plan *compare = nullptr;
+    };
+
+    type_id id = type_id::none();
+    size_t size = 0;
+
+    // fields of record and its bases in order of offset, patches refer to
+    // fields by index into this
+    vector<field> fields;
+};
+
+// delta replication of arrays of reflected records. the sender keeps a
+// baseline (snapshot()) of what the receiver has, encode() writes only the
+// fields which changed since then and moves the baseline forward, apply()
+// patches the receiver's objects. integers are sent as varint deltas, floats
+// raw or quantized (set_quantization, which both sides must agree on) and
+// everything else whole. patches must be applied in order they were encoded.
+// a batch is:
+// * varint object count
+// * change mask, one bit per object
+// * per changed object: varint number of changed fields, then per field a
+//   varint gap to its index (from previous index + 1) and its value
+// plans are per-instance, NOT thread safe.
+// implemented in common/replicate.cpp
+struct replicator {
+    // compiled plan for record type, error if type is not reflected or
+    // contains a field which cannot be serialized
+    result<const replication_plan*, replication_error> plan(type_id id);
+
+    // send float/double field of type id as multiples of step
+    std::optional<replication_error> set_quantization(
+        type_id id,
+        std::string_view field,
+        double step);
+
+    // copy of count objects of type id as a baseline for encode()
+    result<any_vector, replication_error> snapshot(
+        type_id id,
+        const void *objects,
+        size_t count);
+
+    // write changes to count objects of type id since baseline to out and
+    // update baseline to match what the receiver has after applying them.
+    // with a null out (out.data() == nullptr) only returns the size.
+    // returns bytes written.
+    result<size_t, replication_error> encode(
+        type_id id,
+        const void *objects,
+        size_t count,
+        any_vector &baseline,
+        std::span<uint8_t> out);
+
+    // apply patch written by encode to count objects of type id, returns bytes
+    // read. objects may be partially patched if an error is returned.
+    result<size_t, replication_error> apply(
+        type_id id,
+        void *objects,
+        size_t count,
+        std::span<const uint8_t> in);
+
+    template <typename T>
+    std::optional<replication_error> set_quantization(
+        std::string_view field,
+        double step) {
+        return this->set_quantization(type_id::from<T>(), field, step);
+    }
+
+    template <typename T>
+    result<any_vector, replication_error> snapshot(std::span<const T> ts) {
+        return this->snapshot(type_id::from<T>(), ts.data(), ts.size());
+    }
+
+    template <typename T>
+    result<size_t, replication_error> encode(
+        std::span<const T> ts,
+        any_vector &baseline,
+        std::span<uint8_t> out) {
+        return this->encode(
+            type_id::from<T>(), ts.data(), ts.size(), baseline, out);
+    }
+
+    template <typename T>
+    result<size_t, replication_error> apply(
+        std::span<T> ts,
+        std::span<const uint8_t> in) {
+        return this->apply(type_id::from<T>(), ts.data(), ts.size(), in);
+    }
+
+private:
+    // append field of record at offset to plan
+    std::optional<replication_error> add_field(
+        replication_plan &plan,
+        const reflected_field &f,
+        size_t offset);
+
+    binary_serializer binary;
+    object_comparer comparer;
+    map<type_id, std::unique_ptr<replication_plan>> plans;
+
+    // indices of changed fields of current object while encoding
+    vector<size_t> changed;
+};
+} // namespace archimedes
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstring>
 #include <iostream>
 
 #include "archimedes/type_info.hpp"
+#include "archimedes/string_arena.hpp"
 
 // simple and fast (de)serialization based on iostream
 namespace archimedes {
@@ -23,14 +25,6 @@ private:
     bytebuf buf;
 };
 
-template <typename T>
-T deserialize(std::span<const uint8_t> bytes) {
-    T t;
-    auto is = bytestream(bytes);
-    deserialize(is, t);
-    return t;
-}
-
 template <typename T>
     requires (std::is_integral_v<T> || std::is_enum_v<T>)
 void serialize(std::ostream &os, const T &t) {
@@ -45,6 +39,174 @@ void deserialize(std::istream &is, T &t) {
     t = *reinterpret_cast<T*>(&buffer[0]);
 }
 
+// stream storage index for included metadata, stored as its complement such
+// that streams include everything by default
+inline int metadata_stream_index() {
+    static const int index = std::ios_base::xalloc();
+    return index;
+}
+
+// metadata included in data (de)serialized through stream s
+inline metadata stream_metadata(std::ios_base &s) {
+    return ~static_cast<metadata>(
+        static_cast<uint8_t>(s.iword(metadata_stream_index())));
+}
+
+inline void set_stream_metadata(std::ios_base &s, metadata m) {
+    s.iword(metadata_stream_index()) = static_cast<long>(~m);
+}
+
+// header for serialized blobs, configures stream according to its contents
+inline void serialize_header(std::ostream &os, metadata m) {
+    serialize(os, m);
+    set_stream_metadata(os, m);
+}
+
+inline void deserialize_header(std::istream &is) {
+    metadata m;
+    deserialize(is, m);
+    set_stream_metadata(is, m);
+}
+
+// strings (std::string_view) are not written inline but as indices into a
+// string table shared by all blobs of a module, see string_table_writer
+using string_index = uint32_t;
+
+// collects distinct strings written through a stream, assigning each an index
+// NOTE: strings are not copied and must outlive the writer
+struct string_table_writer {
+    map<std::string_view, string_index> indices;
+    vector<std::string_view> strings;
+
+    string_index index(std::string_view s) {
+        const auto [it, inserted] =
+            this->indices.emplace(s, string_index(this->strings.size()));
+        if (inserted) {
+            this->strings.push_back(s);
+        }
+        return it->second;
+    }
+};
+
+// stream storage index for attached string table
+// (string_table_writer* for output, const vector<std::string_view>* for input)
+inline int string_table_stream_index() {
+    static const int index = std::ios_base::xalloc();
+    return index;
+}
+
+inline void set_stream_string_table(
+    std::ostream &os,
+    string_table_writer *table) {
+    os.pword(string_table_stream_index()) = table;
+}
+
+inline void set_stream_string_table(
+    std::istream &is,
+    const vector<std::string_view> *table) {
+    is.pword(string_table_stream_index()) =
+        const_cast<vector<std::string_view>*>(table);
+}
+
+inline void serialize(std::ostream &os, std::string_view str) {
+    auto *table =
+        static_cast<string_table_writer*>(
+            os.pword(string_table_stream_index()));
+    if (!table) {
+        ARCHIMEDES_FAIL("attempt to serialize string without string table");
+    }
+    serialize(os, table->index(str));
+}
+
+inline void deserialize(std::istream &is, std::string_view &str) {
+    const auto *table =
+        static_cast<const vector<std::string_view>*>(
+            is.pword(string_table_stream_index()));
+    if (!table) {
+        ARCHIMEDES_FAIL("attempt to deserialize string without string table");
+    }
+
+    string_index i;
+    deserialize(is, i);
+    if (i >= table->size()) {
+        ARCHIMEDES_FAIL("string index out of range");
+    }
+    str = (*table)[i];
+}
+
+// write string table as count followed by length-prefixed strings
+inline void serialize_string_table(
+    std::ostream &os,
+    const string_table_writer &table) {
+    serialize(os, string_index(table.strings.size()));
+    for (const auto &str : table.strings) {
+        serialize(os, string_index(str.length()));
+        os.write(str.data(), str.length());
+    }
+}
+
+// read string table from bytes, interning each string into arena. fails if
+// the table runs past the end of bytes (truncated or corrupt module).
+inline vector<std::string_view> deserialize_string_table(
+    std::span<const uint8_t> bytes,
+    string_arena &arena) {
+    const auto *p = reinterpret_cast<const char*>(bytes.data());
+    const auto *end = p + bytes.size();
+
+    // read one string_index from p, false on overrun
+    const auto read_index =
+        [&](string_index &i) {
+            if (static_cast<size_t>(end - p) < sizeof(i)) {
+                return false;
+            }
+            std::memcpy(&i, p, sizeof(i));
+            p += sizeof(i);
+            return true;
+        };
+
+    vector<std::string_view> strings;
+
+    string_index n;
+    if (!read_index(n)) {
+        ARCHIMEDES_FAIL("string table truncated");
+        return strings;
+    }
+
+    // every string has at least its length
+    if (n > static_cast<size_t>(end - p) / sizeof(string_index)) {
+        ARCHIMEDES_FAIL("string table truncated");
+        return strings;
+    }
+
+    strings.reserve(n);
+
+    for (string_index i = 0; i < n; i++) {
+        string_index len;
+        if (!read_index(len) || len > static_cast<size_t>(end - p)) {
+            ARCHIMEDES_FAIL("string table truncated");
+            return strings;
+        }
+        strings.push_back(arena.intern(std::string_view(p, len)));
+        p += len;
+    }
+
+    return strings;
+}
+
+// deserialize T from a blob written with a header, string_views in T refer to
+// strings in table
+template <typename T>
+T deserialize(
+    std::span<const uint8_t> bytes,
+    const vector<std::string_view> &table) {
+    T t;
+    auto is = bytestream(bytes);
+    set_stream_string_table(is, &table);
+    deserialize_header(is);
+    deserialize(is, t);
+    return t;
+}
+
 template <typename T>
 void serialize(std::ostream &os, const std::unique_ptr<T> &ptr) {
     if (!ptr) {
@@ -53,6 +215,14 @@ void serialize(std::ostream &os, const std::unique_ptr<T> &ptr) {
     serialize(os, *ptr);
 }
 
+template <typename T>
+void serialize(std::ostream &os, const T *ptr) {
+    if (!ptr) {
+        ARCHIMEDES_FAIL("attempt to serialize nullptr");
+    }
+    serialize(os, *ptr);
+}
+
 template <typename T>
 void deserialize(std::istream &is, std::unique_ptr<T> &ptr) {
     if (!ptr) {
@@ -122,6 +292,22 @@ void deserialize(std::istream &is, map<K, V> &m) {
     }
 }
 
+// serialize t only if stream includes metadata m
+template <typename T>
+void serialize_if(std::ostream &os, metadata m, const T &t) {
+    if ((stream_metadata(os) & m) == m) {
+        serialize(os, t);
+    }
+}
+
+// deserialize t only if stream includes metadata m
+template <typename T>
+void deserialize_if(std::istream &is, metadata m, T &t) {
+    if ((stream_metadata(is) & m) == m) {
+        deserialize(is, t);
+    }
+}
+
 inline void serialize(std::ostream &os, const type_id &id) {
     // always go through mangled_type_name to support different uses of type
     // index impl
@@ -150,6 +336,40 @@ inline void deserialize(std::istream &is, qualified_type_info &info) {
     deserialize(is, info.is_volatile);
 }
 
+inline void serialize(std::ostream &os, const enum_tables::entry &e) {
+    serialize(os, e.name);
+    serialize(os, e.value);
+}
+
+inline void deserialize(std::istream &is, enum_tables::entry &e) {
+    deserialize(is, e.name);
+    deserialize(is, e.value);
+}
+
+inline void serialize(std::ostream &os, const enum_tables &t) {
+    serialize(os, t.entries);
+    serialize(os, t.value_mask);
+    serialize(os, t.is_signed);
+    serialize(os, t.dense_min);
+    serialize(os, t.dense);
+    serialize(os, t.hash_seed);
+    serialize(os, t.hash_displacements);
+    serialize(os, t.hash_slots);
+    serialize(os, t.flags);
+}
+
+inline void deserialize(std::istream &is, enum_tables &t) {
+    deserialize(is, t.entries);
+    deserialize(is, t.value_mask);
+    deserialize(is, t.is_signed);
+    deserialize(is, t.dense_min);
+    deserialize(is, t.dense);
+    deserialize(is, t.hash_seed);
+    deserialize(is, t.hash_displacements);
+    deserialize(is, t.hash_slots);
+    deserialize(is, t.flags);
+}
+
 inline void serialize(std::ostream &os, const struct_base_type_info &info) {
     serialize(os, info.parent_id);
     serialize(os, info.id);
@@ -185,7 +405,8 @@ inline void serialize(std::ostream &os, const field_type_info &info) {
     serialize(os, info.is_bit_field);
     serialize(os, info.bit_size);
     serialize(os, info.bit_offset);
-    serialize(os, info.annotations);
+    serialize(os, info.is_signed_bit_field);
+    serialize_if(os, METADATA_ANNOTATIONS, info.annotations);
 }
 
 inline void deserialize(std::istream &is, field_type_info &info) {
@@ -199,7 +420,8 @@ inline void deserialize(std::istream &is, field_type_info &info) {
     deserialize(is, info.is_bit_field);
     deserialize(is, info.bit_size);
     deserialize(is, info.bit_offset);
-    deserialize(is, info.annotations);
+    deserialize(is, info.is_signed_bit_field);
+    deserialize_if(is, METADATA_ANNOTATIONS, info.annotations);
 }
 
 inline void serialize(std::ostream &os, const static_field_type_info &info) {
@@ -209,7 +431,7 @@ inline void serialize(std::ostream &os, const static_field_type_info &info) {
     serialize(os, info.access);
     serialize(os, info.is_constexpr);
     serialize(os, info.constexpr_value_index);
-    serialize(os, info.annotations);
+    serialize_if(os, METADATA_ANNOTATIONS, info.annotations);
 }
 
 inline void deserialize(std::istream &is, static_field_type_info &info) {
@@ -219,17 +441,17 @@ inline void deserialize(std::istream &is, static_field_type_info &info) {
     deserialize(is, info.access);
     deserialize(is, info.is_constexpr);
     deserialize(is, info.constexpr_value_index);
-    deserialize(is, info.annotations);
+    deserialize_if(is, METADATA_ANNOTATIONS, info.annotations);
 }
 
 inline void serialize(std::ostream &os, const function_parameter_info &info) {
-    serialize(os, info.name);
+    serialize_if(os, METADATA_PARAMETER_NAMES, info.name);
     serialize(os, info.index);
     serialize(os, info.is_defaulted);
 }
 
 inline void deserialize(std::istream &is, function_parameter_info &info) {
-    deserialize(is, info.name);
+    deserialize_if(is, METADATA_PARAMETER_NAMES, info.name);
     deserialize(is, info.index);
     deserialize(is, info.is_defaulted);
 }
@@ -250,8 +472,8 @@ inline void serialize(std::ostream &os, const function_type_info &info) {
     serialize(os, info.is_deleted);
     serialize(os, info.is_defaulted);
     serialize(os, info.parameters);
-    serialize(os, info.annotations);
-    serialize(os, info.definition_path);
+    serialize_if(os, METADATA_ANNOTATIONS, info.annotations);
+    serialize_if(os, METADATA_DEFINITION_PATHS, info.definition_path);
 }
 
 inline void deserialize(std::istream &is, function_type_info &info) {
@@ -270,8 +492,9 @@ inline void deserialize(std::istream &is, function_type_info &info) {
     deserialize(is, info.is_deleted);
     deserialize(is, info.is_defaulted);
     deserialize(is, info.parameters);
-    deserialize(is, info.annotations);
-    deserialize(is, info.definition_path);
+    deserialize_if(is, METADATA_ANNOTATIONS, info.annotations);
+    deserialize_if(is, METADATA_DEFINITION_PATHS, info.definition_path);
+    info.included_metadata = stream_metadata(is);
 }
 
 inline void serialize(std::ostream &os, const function_overload_set &info) {
@@ -303,20 +526,21 @@ inline void deserialize(std::istream &is, template_parameter_info &info) {
 inline void serialize(std::ostream &os, const type_info &info) {
     serialize(os, info.id);
     serialize(os, info.type_id_hash_index);
+    serialize(os, info.value_ops_index);
     serialize(os, info.kind);
     serialize(os, info.type_name);
-    serialize(os, info.mangled_type_name);
+    serialize_if(os, METADATA_MANGLED_NAMES, info.mangled_type_name);
     serialize(os, info.type);
     serialize(os, info.size);
     serialize(os, info.align);
-    serialize(os, info.annotations);
-    serialize(os, info.definition_path);
+    serialize_if(os, METADATA_ANNOTATIONS, info.annotations);
+    serialize_if(os, METADATA_DEFINITION_PATHS, info.definition_path);
 
     if (info.kind == STRUCT || info.kind == UNION) {
         serialize(os, info.record.qualified_name);
         serialize(os, info.record.template_parameters);
         serialize(os, info.record.bases);
-        serialize(os, info.record.typedefs);
+        serialize_if(os, METADATA_TYPEDEFS, info.record.typedefs);
         serialize(os, info.record.fields);
         serialize(os, info.record.static_fields);
         serialize(os, info.record.functions);
@@ -345,28 +569,31 @@ inline void serialize(std::ostream &os, const type_info &info) {
         serialize(os, info.enum_.base_type);
         serialize(os, info.enum_.name_to_value);
         serialize(os, info.enum_.value_to_name);
+        serialize(os, info.enum_.tables);
     } else if (info.kind == MEMBER_PTR) {
         serialize(os, info.member_ptr.class_type);
     }
 }
 
 inline void deserialize(std::istream &is, type_info &info) {
+    info.included_metadata = stream_metadata(is);
     deserialize(is, info.id);
     deserialize(is, info.type_id_hash_index);
+    deserialize(is, info.value_ops_index);
     deserialize(is, info.kind);
     deserialize(is, info.type_name);
-    deserialize(is, info.mangled_type_name);
+    deserialize_if(is, METADATA_MANGLED_NAMES, info.mangled_type_name);
     deserialize(is, info.type);
     deserialize(is, info.size);
     deserialize(is, info.align);
-    deserialize(is, info.annotations);
-    deserialize(is, info.definition_path);
+    deserialize_if(is, METADATA_ANNOTATIONS, info.annotations);
+    deserialize_if(is, METADATA_DEFINITION_PATHS, info.definition_path);
 
     if (info.kind == STRUCT || info.kind == UNION) {
         deserialize(is, info.record.qualified_name);
         deserialize(is, info.record.template_parameters);
         deserialize(is, info.record.bases);
-        deserialize(is, info.record.typedefs);
+        deserialize_if(is, METADATA_TYPEDEFS, info.record.typedefs);
         deserialize(is, info.record.fields);
         deserialize(is, info.record.static_fields);
         deserialize(is, info.record.functions);
@@ -395,6 +622,7 @@ inline void deserialize(std::istream &is, type_info &info) {
         deserialize(is, info.enum_.base_type);
         deserialize(is, info.enum_.name_to_value);
         deserialize(is, info.enum_.value_to_name);
+        deserialize(is, info.enum_.tables);
     } else if (info.kind == MEMBER_PTR) {
         deserialize(is, info.member_ptr.class_type);
     }
@@ -0,0 +1,591 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "errors.hpp"
+#include "type_id.hpp"
+#include "types.hpp"
+#include "any_vector.hpp"
+#include "static_reflect.hpp"
+#include "bits.hpp"
+#include "ds.hpp"
+
+namespace archimedes {
+namespace detail {
+// column for fields of type bool, vector<bool> is bit packed and cannot be
+// viewed as a span
+struct soa_bool_column {
+    soa_bool_column() = default;
+
+    soa_bool_column(const soa_bool_column &other) {
+        *this = other;
+    }
+
+    soa_bool_column(soa_bool_column &&other) {
+        *this = std::move(other);
+    }
+
+    soa_bool_column &operator=(const soa_bool_column &other) {
+        if (this != &other) {
+            this->clear();
+            this->reserve(other._size);
+            std::copy(other.begin(), other.end(), this->begin());
+            this->_size = other._size;
+        }
+        return *this;
+    }
+
+    soa_bool_column &operator=(soa_bool_column &&other) {
+        this->_data = std::move(other._data);
+        this->_size = std::exchange(other._size, 0);
+        this->_capacity = std::exchange(other._capacity, 0);
+        return *this;
+    }
+
+    bool *data() {
+        return this->_data.get();
+    }
+
+    const bool *data() const {
+        return this->_data.get();
+    }
+
+    bool *begin() {
+        return this->data();
+    }
+
+    const bool *begin() const {
+        return this->data();
+    }
+
+    bool *end() {
+        return this->data() + this->_size;
+    }
+
+    const bool *end() const {
+        return this->data() + this->_size;
+    }
+
+    size_t size() const {
+        return this->_size;
+    }
+
+    bool &operator[](size_t i) {
+        return this->_data[i];
+    }
+
+    const bool &operator[](size_t i) const {
+        return this->_data[i];
+    }
+
+    bool &back() {
+        return this->_data[this->_size - 1];
+    }
+
+    void reserve(size_t n) {
+        if (n <= this->_capacity) {
+            return;
+        }
+
+        auto data = std::make_unique<bool[]>(n);
+        std::copy(this->begin(), this->end(), data.get());
+        this->_data = std::move(data);
+        this->_capacity = n;
+    }
+
+    void resize(size_t n) {
+        this->reserve(n);
+        std::fill(this->end(), this->data() + std::max(n, this->_size), false);
+        this->_size = n;
+    }
+
+    void push_back(bool b) {
+        if (this->_size == this->_capacity) {
+            this->reserve(std::max<size_t>(2 * this->_capacity, 8));
+        }
+        this->_data[this->_size++] = b;
+    }
+
+    void pop_back() {
+        this->_size--;
+    }
+
+    // erase element at it, elements after are shifted down
+    void erase(bool *it) {
+        std::copy(it + 1, this->end(), it);
+        this->_size--;
+    }
+
+    void clear() {
+        this->_size = 0;
+    }
+
+private:
+    std::unique_ptr<bool[]> _data;
+    size_t _size = 0, _capacity = 0;
+};
+
+// storage of column for fields of type M
+template <typename M>
+using soa_column =
+    std::conditional_t<std::is_same_v<M, bool>, soa_bool_column, vector<M>>;
+
+// std::tuple of column per field for a static_reflect<T>::fields tuple
+template <typename Fields>
+struct soa_columns;
+
+template <typename ...Fs>
+struct soa_columns<std::tuple<Fs...>> {
+    using type = std::tuple<soa_column<typename Fs::type>...>;
+};
+
+// converts to any type, to count the members of an aggregate
+struct soa_any_field {
+    template <typename U>
+    operator U() const;
+};
+
+// number of members of aggregate T (bases and bit fields included), as the
+// most initializers T can be brace initialized with. with brace elision each
+// element of an array member counts on its own
+template <typename T, typename ...As>
+constexpr size_t aggregate_size() {
+    if constexpr (requires { T { As()..., soa_any_field() }; }) {
+        return aggregate_size<T, As..., soa_any_field>();
+    } else {
+        return sizeof...(As);
+    }
+}
+
+// true if every member of T is a column of soa_vector<T>
+template <typename T>
+constexpr bool is_soa_record() {
+    if constexpr (!std::is_aggregate_v<T>) {
+        return false;
+    } else {
+        return std::tuple_size_v<
+                std::remove_cvref_t<decltype(static_reflect<T>::bases)>> == 0
+            && aggregate_size<T>() == static_field_count<T>;
+    }
+}
+} // namespace detail
+
+// structure of arrays of T, each field of T is stored in its own contiguous
+// column. the columns are fixed at compile time by the plugin's static
+// reflection header. rows are accessed through proxies, columns as spans for
+// bulk work.
+// T must be an aggregate without bases, bit fields or array members, so that
+// every field is a column and no state is lost when rows are read back as T.
+template <static_reflected_record T>
+struct soa_vector {
+    static_assert(
+        detail::is_soa_record<T>(),
+        "soa_vector<T> requires T to be an aggregate without bases, bit "
+        "fields or array members");
+
+private:
+    using fields_type =
+        std::remove_cvref_t<decltype(static_reflect<T>::fields)>;
+
+public:
+    // one column per public field of T
+    static constexpr size_t NUM_COLUMNS = static_field_count<T>;
+
+    // type of field stored in column I
+    template <size_t I>
+    using column_type = typename std::tuple_element_t<I, fields_type>::type;
+
+    // index of column for field pointer P (fx. &T::x), NUM_COLUMNS if none
+    template <auto P>
+    static constexpr size_t column_index() {
+        size_t i = 0, index = NUM_COLUMNS;
+        for_each_field<T>(
+            [&](const auto &f) {
+                if constexpr (std::is_same_v<decltype(f.ptr), decltype(P)>) {
+                    if (f.ptr == P) {
+                        index = i;
+                    }
+                }
+                i++;
+            });
+        return index;
+    }
+
+    // proxy for one row
+    template <bool IS_CONST>
+    struct basic_row {
+        using soa_type =
+            std::conditional_t<IS_CONST, const soa_vector, soa_vector>;
+
+        soa_type *soa;
+        size_t index;
+
+        // copies values, not the proxy
+        const basic_row &operator=(const basic_row &r) const
+            requires (!IS_CONST) {
+            soa_vector::for_each_column(
+                [&](auto i) {
+                    this->template get<i>() = r.template get<i>();
+                });
+            return *this;
+        }
+
+        const basic_row &operator=(const T &t) const requires (!IS_CONST) {
+            this->store(t);
+            return *this;
+        }
+
+        operator basic_row<true>() const {
+            return basic_row<true> { this->soa, this->index };
+        }
+
+        operator T() const {
+            return this->load();
+        }
+
+        // reference to field in column I
+        template <size_t I>
+        auto &get() const {
+            return std::get<I>(this->soa->columns)[this->index];
+        }
+
+        // reference to field P (fx. &T::x)
+        template <auto P>
+            requires std::is_member_object_pointer_v<decltype(P)>
+        auto &get() const {
+            static_assert(
+                column_index<P>() < NUM_COLUMNS,
+                "field is not a column of T");
+            return this->template get<column_index<P>()>();
+        }
+
+        // row as a T
+        T load() const {
+            T t {};
+            soa_vector::for_each_column(
+                [&](auto i) {
+                    std::get<i>(static_reflect<T>::fields).get(t) =
+                        this->template get<i>();
+                });
+            return t;
+        }
+
+        // set row to fields of t
+        void store(const T &t) const requires (!IS_CONST) {
+            soa_vector::for_each_column(
+                [&](auto i) {
+                    this->template get<i>() =
+                        std::get<i>(static_reflect<T>::fields).get(t);
+                });
+        }
+    };
+
+    using row = basic_row<false>;
+    using const_row = basic_row<true>;
+
+    size_t size() const {
+        return this->_size;
+    }
+
+    bool empty() const {
+        return this->_size == 0;
+    }
+
+    // proxy for row i, NOT bounds checked
+    row operator[](size_t i) {
+        return row { this, i };
+    }
+
+    const_row operator[](size_t i) const {
+        return const_row { this, i };
+    }
+
+    row back() {
+        return (*this)[this->_size - 1];
+    }
+
+    const_row back() const {
+        return (*this)[this->_size - 1];
+    }
+
+    // contiguous values of column I
+    template <size_t I>
+    std::span<column_type<I>> column() {
+        auto &c = std::get<I>(this->columns);
+        return std::span<column_type<I>>(c.data(), c.size());
+    }
+
+    template <size_t I>
+    std::span<const column_type<I>> column() const {
+        const auto &c = std::get<I>(this->columns);
+        return std::span<const column_type<I>>(c.data(), c.size());
+    }
+
+    // contiguous values of field P (fx. &T::x)
+    template <auto P>
+        requires std::is_member_object_pointer_v<decltype(P)>
+    auto column() {
+        static_assert(
+            column_index<P>() < NUM_COLUMNS,
+            "field is not a column of T");
+        return this->column<column_index<P>()>();
+    }
+
+    template <auto P>
+        requires std::is_member_object_pointer_v<decltype(P)>
+    auto column() const {
+        static_assert(
+            column_index<P>() < NUM_COLUMNS,
+            "field is not a column of T");
+        return this->column<column_index<P>()>();
+    }
+
+    void reserve(size_t n) {
+        for_each_column([&](auto i) { std::get<i>(this->columns).reserve(n); });
+    }
+
+    // resize to n rows, new rows have the fields of a default constructed T
+    void resize(size_t n) {
+        if (n <= this->_size) {
+            for_each_column(
+                [&](auto i) { std::get<i>(this->columns).resize(n); });
+            this->_size = n;
+            return;
+        }
+
+        const T t {};
+        this->reserve(n);
+        while (this->_size < n) {
+            this->push_back(t);
+        }
+    }
+
+    // append fields of t as a row
+    void push_back(const T &t) {
+        for_each_column(
+            [&](auto i) {
+                std::get<i>(this->columns).push_back(
+                    std::get<i>(static_reflect<T>::fields).get(t));
+            });
+        this->_size++;
+    }
+
+    // append a row with the fields of a default constructed T
+    row emplace_back() {
+        this->push_back(T {});
+        return this->back();
+    }
+
+    void pop_back() {
+        for_each_column([&](auto i) { std::get<i>(this->columns).pop_back(); });
+        this->_size--;
+    }
+
+    // erase row i, rows after are shifted down
+    void erase(size_t i) {
+        for_each_column(
+            [&](auto c) {
+                auto &v = std::get<c>(this->columns);
+                v.erase(v.begin() + i);
+            });
+        this->_size--;
+    }
+
+    // erase row i by moving the last row into its place
+    void swap_erase(size_t i) {
+        if (i != this->_size - 1) {
+            for_each_column(
+                [&](auto c) {
+                    auto &v = std::get<c>(this->columns);
+                    v[i] = std::move(v.back());
+                });
+        }
+        this->pop_back();
+    }
+
+    void clear() {
+        for_each_column([&](auto i) { std::get<i>(this->columns).clear(); });
+        this->_size = 0;
+    }
+
+private:
+    // call f(std::integral_constant<size_t, I>) for each column I
+    template <typename F>
+    static constexpr void for_each_column(F &&f) {
+        [&]<size_t ...Is>(std::index_sequence<Is...>) {
+            (f(std::integral_constant<size_t, Is>()), ...);
+        }(std::make_index_sequence<NUM_COLUMNS>());
+    }
+
+    typename detail::soa_columns<fields_type>::type columns;
+    size_t _size = 0;
+};
+
+// structure of arrays of a runtime (reflected) record type: every field of the
+// record and its bases gets its own any_vector column, in order of offset. bit
+// fields are stored widened to their declared type.
+// implemented in common/soa.cpp
+struct any_soa_vector {
+    struct column_info {
+        reflected_field field;
+
+        // offset of field in record, of the record containing it if bit field
+        size_t offset;
+
+        // if bit field, accessor for it relative to offset
+        bit_field_accessor bits;
+
+        any_vector values;
+    };
+
+    // proxy for one row
+    template <bool IS_CONST>
+    struct basic_row {
+        using soa_type =
+            std::conditional_t<IS_CONST, const any_soa_vector, any_soa_vector>;
+        using ptr_type = std::conditional_t<IS_CONST, const void*, void*>;
+
+        soa_type *soa;
+        size_t index;
+
+        operator basic_row<true>() const {
+            return basic_row<true> { this->soa, this->index };
+        }
+
+        // pointer to value in column i
+        ptr_type operator[](size_t i) const {
+            return this->soa->_columns[i].values[this->index];
+        }
+
+        // reference to value in column i, F must be the column's type
+        template <typename F>
+        auto &get(size_t i) const {
+            return this->soa->template column<F>(i)[this->index];
+        }
+
+        // copy row into record, which must be of the vector's type
+        void load(void *record) const {
+            this->soa->load(this->index, record);
+        }
+
+        // set row to fields of record, which must be of the vector's type
+        void store(const void *record) const requires (!IS_CONST) {
+            this->soa->store(this->index, record);
+        }
+    };
+
+    using row = basic_row<false>;
+    using const_row = basic_row<true>;
+
+    any_soa_vector() = default;
+
+    // empty vector with columns for record type id, error if the type is not
+    // a struct, has virtual bases or fields which cannot be copied
+    static result<any_soa_vector, soa_error> make(type_id id);
+
+    template <typename T>
+    static result<any_soa_vector, soa_error> make() {
+        return make(type_id::from<T>());
+    }
+
+    // id of record type
+    type_id id() const {
+        return this->_id;
+    }
+
+    size_t size() const {
+        return this->_size;
+    }
+
+    bool empty() const {
+        return this->_size == 0;
+    }
+
+    std::span<const column_info> columns() const {
+        return std::span<const column_info>(
+            this->_columns.data(), this->_columns.size());
+    }
+
+    // index of column for field name, fields of derived records shadow
+    // fields of their bases
+    std::optional<size_t> column_index(std::string_view name) const;
+
+    any_vector &column(size_t i) {
+        return this->_columns[i].values;
+    }
+
+    const any_vector &column(size_t i) const {
+        return this->_columns[i].values;
+    }
+
+    // contiguous values of column i, F must be the column's type
+    template <typename F>
+    std::span<F> column(size_t i) {
+        return this->_columns[i].values.template as<F>();
+    }
+
+    template <typename F>
+    std::span<const F> column(size_t i) const {
+        return this->_columns[i].values.template as<F>();
+    }
+
+    // proxy for row i, NOT bounds checked
+    row operator[](size_t i) {
+        return row { this, i };
+    }
+
+    const_row operator[](size_t i) const {
+        return const_row { this, i };
+    }
+
+    // append copy of fields of record, which must be of the vector's type
+    void push_back(const void *record);
+
+    template <typename T>
+        requires (!std::is_pointer_v<T>)
+    void push_back(const T &t) {
+        if (type_id::from<T>() != this->_id) {
+            ARCHIMEDES_FAIL("any_soa_vector::push_back of wrong type");
+            return;
+        }
+
+        this->push_back(static_cast<const void*>(&t));
+    }
+
+    // copy row i into record
+    void load(size_t i, void *record) const;
+
+    // set row i to fields of record
+    void store(size_t i, const void *record);
+
+    void reserve(size_t n);
+
+    // resize to n rows, new rows have the fields of a default constructed
+    // record if it has a default ctor, otherwise of default constructed fields
+    void resize(size_t n);
+
+    void pop_back();
+
+    // erase row i, rows after are shifted down
+    void erase(size_t i);
+
+    // erase row i by moving the last row into its place
+    void swap_erase(size_t i);
+
+    void clear();
+
+private:
+    type_id _id = type_id::none();
+    const value_ops *record_ops = nullptr;
+    size_t record_size = 0, record_align = 1;
+    vector<column_info> _columns;
+    size_t _size = 0;
+};
+} // namespace archimedes
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "type_id.hpp"
+
+namespace archimedes {
+// compile-time reflection data for T, specialized in headers emitted by the
+// plugin with -fplugin-arg-archimedes-emit-static-header-<path>
+// specializations of records have:
+//   type, name, id, fields, bases, functions
+// specializations of enums have:
+//   type, name, id, enumerators
+template <typename T>
+struct static_reflect;
+
+// true if T has compile-time reflection data
+template <typename T>
+concept static_reflected =
+    requires { static_reflect<std::remove_cv_t<T>>::name; };
+
+template <typename T>
+concept static_reflected_record =
+    static_reflected<T>
+        && requires { static_reflect<std::remove_cv_t<T>>::fields; };
+
+template <typename T>
+concept static_reflected_enum =
+    static_reflected<T>
+        && requires { static_reflect<std::remove_cv_t<T>>::enumerators; };
+
+// public non-static, non-bitfield field M of record C
+template <typename C, typename M>
+struct static_field {
+    using class_type = C;
+    using type = M;
+
+    std::string_view name;
+
+    // offset of field in C
+    size_t offset;
+
+    M C::*ptr;
+
+    constexpr static_field(std::string_view name, size_t offset, M C::*ptr)
+        : name(name), offset(offset), ptr(ptr) {}
+
+    constexpr M &get(C &c) const {
+        return c.*this->ptr;
+    }
+
+    constexpr const M &get(const C &c) const {
+        return c.*this->ptr;
+    }
+};
+
+// public direct base B of some record
+template <typename B>
+struct static_base {
+    using type = B;
+
+    bool is_virtual;
+
+    // offset of base in record, 0 if is_virtual
+    size_t offset;
+
+    constexpr static_base(bool is_virtual, size_t offset)
+        : is_virtual(is_virtual), offset(offset) {}
+};
+
+// public, non-overloaded member function of some record
+// F is a member function pointer, or function pointer for static methods
+template <typename F>
+struct static_function {
+    using type = F;
+
+    std::string_view name;
+    F ptr;
+
+    constexpr static_function(std::string_view name, F ptr)
+        : name(name), ptr(ptr) {}
+};
+
+template <typename E>
+struct static_enumerator {
+    std::string_view name;
+    E value;
+};
+
+// call f(static_field) for each field of T in declaration order
+template <static_reflected_record T, typename F>
+constexpr void for_each_field(F &&f) {
+    std::apply(
+        [&](const auto &...fs) { (f(fs), ...); },
+        static_reflect<std::remove_cv_t<T>>::fields);
+}
+
+// call f(static_base) for each base of T in declaration order
+template <static_reflected_record T, typename F>
+constexpr void for_each_base(F &&f) {
+    std::apply(
+        [&](const auto &...bs) { (f(bs), ...); },
+        static_reflect<std::remove_cv_t<T>>::bases);
+}
+
+// call f(static_function) for each function of T in declaration order
+template <static_reflected_record T, typename F>
+constexpr void for_each_function(F &&f) {
+    std::apply(
+        [&](const auto &...fs) { (f(fs), ...); },
+        static_reflect<std::remove_cv_t<T>>::functions);
+}
+
+// number of fields in T
+template <static_reflected_record T>
+inline constexpr size_t static_field_count =
+    std::tuple_size_v<
+        std::remove_cvref_t<
+            decltype(static_reflect<std::remove_cv_t<T>>::fields)>>;
+
+// name of first enumerator with value e
+template <static_reflected_enum E>
+constexpr std::optional<std::string_view> static_enum_name(E e) {
+    for (const auto &en : static_reflect<E>::enumerators) {
+        if (en.value == e) {
+            return en.name;
+        }
+    }
+    return std::nullopt;
+}
+
+// value of enumerator with name
+template <static_reflected_enum E>
+constexpr std::optional<E> static_enum_value(std::string_view name) {
+    for (const auto &en : static_reflect<E>::enumerators) {
+        if (en.name == name) {
+            return en.value;
+        }
+    }
+    return std::nullopt;
+}
+} // namespace archimedes
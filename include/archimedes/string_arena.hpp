@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace archimedes::detail {
+// append-only storage for strings loaded from modules, each distinct string is
+// stored exactly once and referenced by string_view for the arena's lifetime
+struct string_arena {
+    // size of each allocated chunk, strings larger than this get their own
+    static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+    string_arena() = default;
+    string_arena(const string_arena&) = delete;
+    string_arena(string_arena&&) = default;
+    string_arena &operator=(const string_arena&) = delete;
+    string_arena &operator=(string_arena&&) = default;
+
+    // returns view of s stored in this arena, copying s only if an equal
+    // string is not already present
+    std::string_view intern(std::string_view s);
+
+    // number of distinct strings
+    size_t count() const {
+        return this->strings.size();
+    }
+
+    // total bytes allocated for string storage
+    size_t bytes() const {
+        return this->allocated;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t chunk_used = CHUNK_SIZE, allocated = 0;
+    std::unordered_set<std::string_view> strings;
+};
+}
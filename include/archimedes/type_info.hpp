@@ -1,12 +1,18 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "type_id.hpp"
 #include "type_kind.hpp"
 #include "access_specifier.hpp"
+#include "metadata.hpp"
 #include "any.hpp"
 #include "invoke.hpp"
+#include "invoke_hooks.hpp"
+#include "enum_tables.hpp"
+#include "value_ops.hpp"
+#include "bits.hpp"
 #include "ds.hpp"
 
 namespace archimedes::detail {
@@ -46,7 +52,7 @@ struct qualified_type_info {
 // ALWAYS FULLY QUALIFIED
 // fx. "using A = B<int>" -> { name = A, aliased_type = B<int> }
 struct typedef_info {
-    std::string name = "";
+    std::string_view name = "";
     qualified_type_info aliased_type = qualified_type_info::none();
 };
 
@@ -57,8 +63,8 @@ struct typedef_info {
 // "namespace ab = a::b" -> { name = ab, aliased = a::b }
 // "namespace c { namespace ab = a::b; }" -> { name = c::ab, aliased = a::b }
 struct namespace_alias_info {
-    std::string name = "";
-    std::string aliased = "";
+    std::string_view name = "";
+    std::string_view aliased = "";
 };
 
 // info about a namespace using directive
@@ -68,8 +74,8 @@ struct namespace_alias_info {
 // "containing" will be empty if the using directive appears in the global
 // namespace
 struct namespace_using_info {
-    std::string containing = "";
-    std::string used = "";
+    std::string_view containing = "";
+    std::string_view used = "";
 };
 // type information for struct base types i.e. struct Foo : Bar {}
 struct struct_base_type_info {
@@ -121,7 +127,7 @@ struct field_type_info {
     qualified_type_info type = qualified_type_info::none();
 
     // name of field
-    std::string name = "";
+    std::string_view name = "";
 
     // offset of field on parent
     size_t offset = 0;
@@ -144,8 +150,16 @@ struct field_type_info {
     // if is_bit_field offset IN BITS into parent record type
     size_t bit_offset = 0;
 
+    // if is_bit_field, true if values are sign extended (signed integer, or
+    // enum with a signed underlying type)
+    bool is_signed_bit_field = false;
+
+    // if is_bit_field, shift/mask constants for bit_offset/bit_size
+    // NOTE: not serialized, built by registry::load_types
+    bit_field_accessor bit_access = {};
+
     // annotations on field
-    vector<std::string> annotations = {};
+    vector<std::string_view> annotations = {};
 };
 
 // type info for static record field
@@ -157,7 +171,7 @@ struct static_field_type_info {
     qualified_type_info type = qualified_type_info::none();
 
     // name of field
-    std::string name = "";
+    std::string_view name = "";
 
     // access specifier to field
     AccessSpecifier access = AccessSpecifier::PRIVATE;
@@ -173,7 +187,7 @@ struct static_field_type_info {
     any constexpr_value = any::none();
 
     // annotations on field
-    vector<std::string> annotations = {};
+    vector<std::string_view> annotations = {};
 
     // INTERNAL USE ONLY
     // extra data
@@ -183,7 +197,7 @@ struct static_field_type_info {
 // type info for function parameter
 struct function_parameter_info {
     // name of parameter in functino
-    std::string name = "";
+    std::string_view name = "";
 
     // index in function parameters list
     size_t index = 0;
@@ -208,10 +222,10 @@ struct function_type_info {
     type_id id = type_id::none();
 
     // qualified name of function (namespace'd/class'd/etc.)
-    std::string qualified_name = "";
+    std::string_view qualified_name = "";
 
     // name of function (no qualfiers)
-    std::string name = "";
+    std::string_view name = "";
 
     // true if member function
     bool is_member = false;
@@ -246,22 +260,31 @@ struct function_type_info {
     vector<function_parameter_info> parameters = {};
 
     // annotations on function
-    vector<std::string> annotations = {};
+    vector<std::string_view> annotations = {};
 
     // path to file which defines function
-    std::string definition_path = "";
+    std::string_view definition_path = "";
+
+    // optional metadata which was emitted for this function
+    metadata included_metadata = METADATA_ALL;
 
     // INTERNAL USE ONLY
     // extra data
     function_type_info_internal *internal = nullptr;
+
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+    // invocation statistics, shared between all copies of this function in
+    // the registry. nullptr until loaded
+    invoke_stats *stats = nullptr;
+#endif
 };
 
 struct function_overload_set {
     // qualified name of set of function overloads (namespace'd/class'd/etc.)
-    std::string qualified_name = "";
+    std::string_view qualified_name = "";
 
     // unqualified name of set of function overloads
-    std::string name = "";
+    std::string_view name = "";
 
     // list of functions in set
     vector<function_type_info> functions = {};
@@ -269,7 +292,7 @@ struct function_overload_set {
 
 struct template_parameter_info {
     // name of this template parameter
-    std::string name;
+    std::string_view name;
 
     // type of this template parameter
     qualified_type_info type;
@@ -301,14 +324,21 @@ struct type_info {
     // index of type index hash in module type index hash array
     size_t type_id_hash_index = NO_ARRAY_INDEX;
 
+    // lifetime operations, nullptr if not emitted (only emitted for records)
+    const value_ops *ops = nullptr;
+
+    // INTERNAL USE ONLY
+    // index of ops in module value ops array
+    size_t value_ops_index = NO_ARRAY_INDEX;
+
     // type kind
     type_kind kind = UNKNOWN;
 
     // type name
-    std::string type_name = "";
+    std::string_view type_name = "";
 
     // mangled type name
-    std::string mangled_type_name = "";
+    std::string_view mangled_type_name = "";
 
     // pointer/ref'd/array'd type
     // only valid for ptr, ref, rvalue ref, member ptr, array types
@@ -321,15 +351,18 @@ struct type_info {
     size_t align = 0;
 
     // annotation attribute values
-    vector<std::string> annotations = {};
+    vector<std::string_view> annotations = {};
 
     // definition file path
     // only valid for user-defined types, namely struct/union/enum
-    std::string definition_path = "";
+    std::string_view definition_path = "";
+
+    // optional metadata which was emitted for this type
+    metadata included_metadata = METADATA_ALL;
 
     struct {
         // fully namespace'd type name
-        std::string qualified_name = "";
+        std::string_view qualified_name = "";
 
         // template parameters in order of declaration
         vector<template_parameter_info> template_parameters = {};
@@ -406,10 +439,13 @@ struct type_info {
         qualified_type_info base_type = qualified_type_info::none();
 
         // map of enum names to their values
-        map<std::string, std::uintmax_t> name_to_value = {};
+        map<std::string_view, std::uintmax_t> name_to_value = {};
 
         // map of enum values to their names
-        map<std::uintmax_t, vector<std::string>> value_to_name = {};
+        map<std::uintmax_t, vector<std::string_view>> value_to_name = {};
+
+        // precomputed name <-> value lookup tables
+        enum_tables tables = {};
     } enum_;
 
     // member ptr
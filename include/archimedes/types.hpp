@@ -233,6 +233,13 @@ struct reflected_function {
         return this->info->qualified_name;
     }
 
+    // returns true if optional metadata m was emitted for this function, if
+    // not then its accessors (definition_path(), annotations(), parameter
+    // names) return empty values
+    bool has_metadata(metadata m) const {
+        return (this->info->included_metadata & m) == m;
+    }
+
     // path of file in which function is defined
     std::string_view definition_path() const {
         return this->info->definition_path;
@@ -337,7 +344,7 @@ struct reflected_function {
             }
          }(ts), ...);
 
-        return this->info->invoker(std::span { args });
+        return this->call(std::span { args });
     }
 
     // attempt to invoke function with specified arguments
@@ -347,7 +354,7 @@ struct reflected_function {
             return archimedes::invoke_result::NO_ACCESS;
         }
 
-        return this->info->invoker(args);
+        return this->call(args);
     }
 
     // attempt to invoke function with specified arguments
@@ -359,7 +366,23 @@ struct reflected_function {
                 args.size()));
     }
 
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+    // invocation statistics, nullptr if function cannot be invoked
+    const archimedes::invoke_stats *stats() const {
+        return this->info->stats;
+    }
+#endif
+
 //private:
+    // all invocations go through here
+    archimedes::invoke_result call(std::span<archimedes::any> args) const {
+#ifdef ARCHIMEDES_INVOKE_HOOKS
+        return detail::invoke_instrumented(*this->info, args);
+#else
+        return this->info->invoker(args);
+#endif
+    }
+
     const detail::function_type_info *info;
 };
 
@@ -394,11 +417,24 @@ struct reflected_type {
             : std::nullopt;
     }
 
+    // raw construct/copy/move/destroy/swap operations for this type,
+    // nullptr if the plugin did not emit them (only records have ops)
+    const value_ops *ops() const {
+        return this->info->ops;
+    }
+
     // name of type
     std::string_view name() const {
         return this->info->type_name;
     }
 
+    // returns true if optional metadata m was emitted for this type, if not
+    // then its accessors (mangled_name(), definition_path(), annotations(),
+    // type_aliases(), ...) return empty values
+    bool has_metadata(metadata m) const {
+        return (this->info->included_metadata & m) == m;
+    }
+
     // mangled name of type
     std::string_view mangled_name() const {
         return this->info->mangled_type_name;
@@ -1085,6 +1121,11 @@ struct reflected_record_type : public reflected_type {
         return this->info->record.has_trivial_dtor;
     }
 
+    // true if record is trivially copyable
+    bool is_trivially_copyable() const {
+        return this->info->record.is_trivially_copyable;
+    }
+
     // true if record is abstract (has a deleted virtual function)
     bool is_abstract() const {
         return this->info->record.is_abstract;
@@ -1234,6 +1275,11 @@ struct reflected_field {
     // type of field
     qualified_reflected_type type() const;
 
+    // id of type of field, valid even if the type itself is not reflected
+    type_id field_type_id() const {
+        return this->info->type.id;
+    }
+
     // name of field
     std::string_view name() const {
         return this->info->name;
@@ -1241,7 +1287,9 @@ struct reflected_field {
 
     // qualified name of field including record name
     std::string qualified_name() const {
-        return std::string(this->parent().name()) + "::" + this->info->name;
+        return std::string(this->parent().name())
+            + "::"
+            + std::string(this->info->name);
     }
 
     // offset of field into parent tye
@@ -1285,6 +1333,19 @@ struct reflected_field {
             field_error::IS_NOT_BIT_FIELD);
     }
 
+    // true if bit field whose values are sign extended
+    bool is_signed_bit_field() const {
+        return this->info->is_signed_bit_field;
+    }
+
+    // if bit field, returns precomputed accessor for its bits
+    result<bit_field_accessor, field_error> bit_accessor() const {
+        return result<bit_field_accessor, field_error>::make(
+            this->is_bit_field(),
+            this->info->bit_access,
+            field_error::IS_NOT_BIT_FIELD);
+    }
+
     // annotations on field
     auto annotations() const {
         return detail::transform<vector<std::string_view>>(
@@ -1357,24 +1418,24 @@ struct reflected_field {
     }
 
     // get value (NOT REFERENCE) to field on some T
+    // bit fields are read through bit_accessor(), F must then be integral or
+    // an enum
     // TODO: values from any
     template <typename F, typename T>
-    result<std::reference_wrapper<F>, field_error> value(
-        const T &t) const {
+    result<F, field_error> value(const T &t) const {
         if (this->is_bit_field()) {
-            // TODO: fix for types larger than uintmax_t?
-            constexpr auto UINTMAX_BITS = sizeof(uintmax_t) * CHAR_BIT;
-            const auto bits = *this->bit_offset();
-            auto p =
-                *(reinterpret_cast<uintmax_t*>(&const_cast<T&>(t))
-                    + (bits / UINTMAX_BITS));
-            return
-                static_cast<F>(
-                    (p >> (bits % UINTMAX_BITS))
-                        & ((1 << (bits + 1)) - 1));
+            if constexpr (std::is_integral_v<F> || std::is_enum_v<F>) {
+                return static_cast<F>(this->info->bit_access.load(&t));
+            } else {
+                return field_error::WRONG_TYPE;
+            }
         }
 
-        return this->get<F>(t);
+        const auto r = this->get<F>(t);
+        if (!r) {
+            return r.unwrap_error();
+        }
+        return r->get();
     }
 
     // set field on some object T (via copy assignment)
@@ -1402,19 +1463,10 @@ struct reflected_field {
 private:
     template <typename T, typename F>
     void set_bit_field(const T &t, F f) const {
-        if constexpr (std::is_integral_v<F>) {
-            // TODO: fix for types larger than uintmax_t?
-            constexpr auto UINTMAX_BITS = sizeof(uintmax_t) * CHAR_BIT;
-            const auto
-                offset = *this->bit_offset(),
-                size = *this->bit_field_size();
-            auto *p =
-                (reinterpret_cast<uintmax_t*>(&const_cast<T&>(t))
-                    + (offset / UINTMAX_BITS));
-            const auto
-                size_mask = (1 << (size + 1)) - 1,
-                mask = size_mask << (offset % UINTMAX_BITS);
-            *p = (*p & ~mask) | ((f & size_mask) << (offset % UINTMAX_BITS));
+        if constexpr (std::is_integral_v<F> || std::is_enum_v<F>) {
+            this->info->bit_access.store(
+                &const_cast<T&>(t),
+                static_cast<uint64_t>(f));
         }
     }
 
@@ -1429,6 +1481,11 @@ struct reflected_array_type : public reflected_type {
     size_t length() const {
         return this->info->array.length;
     }
+
+    // id of element type, valid even if the type itself is not reflected
+    type_id element_type_id() const {
+        return this->info->type.id;
+    }
 };
 
 // reflected_type with kind ENUM
@@ -1465,19 +1522,100 @@ struct reflected_enum_type : public reflected_type {
 
     // string -> enum value
     template <typename T>
-    std::optional<T> value_of(std::string_view s) {
-        auto it =
-            std::find_if(
-                this->info->enum_.name_to_value.begin(),
-                this->info->enum_.name_to_value.end(),
-                [&](const auto &p) {
-                    const auto &[k, _] = p;
-                    return k == s;
+    std::optional<T> value_of(std::string_view s) const {
+        const auto &tables = this->info->enum_.tables;
+        const auto *e = tables.by_name(s);
+        return e ?
+            std::make_optional(tables.template from_bits<T>(e->value))
+            : std::nullopt;
+    }
+
+    // enum value -> first declared name, does not allocate
+    template <typename T>
+        requires (std::is_enum_v<T> || std::is_integral_v<T>)
+    std::optional<std::string_view> name_of(const T &t) const {
+        const auto &tables = this->info->enum_.tables;
+        const auto *e = tables.by_value(tables.to_bits(t));
+        return e ? std::make_optional(e->name) : std::nullopt;
+    }
+
+    // true if values are contiguous enough for name_of to be a direct lookup
+    bool is_dense() const {
+        return !this->info->enum_.tables.dense.empty();
+    }
+
+    // true if all values are (combinations of) single bit values
+    bool is_flags() const {
+        return !this->info->enum_.tables.flags.empty();
+    }
+
+    // call f(std::string_view) with the name of each flag set in t, returns
+    // bits of t which are not named by any flag. does not allocate.
+    template <typename T, typename F>
+        requires (std::is_enum_v<T> || std::is_integral_v<T>)
+    std::uintmax_t for_each_flag(const T &t, F &&f) const {
+        const auto &tables = this->info->enum_.tables;
+        return tables.for_each_flag(tables.to_bits(t), std::forward<F>(f));
+    }
+
+    // write names of flags in t separated by sep to buf, fx. "A|C|0x10"
+    // (remaining unnamed bits in hex). if t has no flags set, writes the name
+    // of t if it has one (fx. "NONE") or "0". returns std::nullopt if buf is
+    // too small.
+    template <typename T>
+        requires (std::is_enum_v<T> || std::is_integral_v<T>)
+    std::optional<std::string_view> format_flags(
+        const T &t,
+        std::span<char> buf,
+        std::string_view sep = "|") const {
+        size_t n = 0;
+        bool fits = true;
+        const auto append =
+            [&](std::string_view s) {
+                if (!fits || n + s.size() > buf.size()) {
+                    fits = false;
+                    return;
+                }
+
+                std::copy(s.begin(), s.end(), buf.begin() + n);
+                n += s.size();
+            };
+
+        const auto rest =
+            this->for_each_flag(
+                t,
+                [&](std::string_view name) {
+                    if (n != 0) {
+                        append(sep);
+                    }
+                    append(name);
                 });
-        return it == this->info->enum_.name_to_value.end() ?
-            std::nullopt
-            : std::make_optional(
-                static_cast<T>(it->second));
+
+        if (rest != 0 || n == 0) {
+            const auto name = this->name_of(rest);
+            if (n == 0 && name) {
+                append(*name);
+            } else if (n == 0 && rest == 0) {
+                append("0");
+            } else {
+                char hex[2 + 2 * sizeof(std::uintmax_t)];
+                size_t len = 0;
+                for (auto v = rest; v != 0; v >>= 4) {
+                    hex[sizeof(hex) - 1 - len++] = "0123456789abcdef"[v & 0xF];
+                }
+                hex[sizeof(hex) - 1 - len++] = 'x';
+                hex[sizeof(hex) - 1 - len++] = '0';
+
+                if (n != 0) {
+                    append(sep);
+                }
+                append(std::string_view(&hex[sizeof(hex) - len], len));
+            }
+        }
+
+        return fits ?
+            std::make_optional(std::string_view(buf.data(), n))
+            : std::nullopt;
     }
 };
 
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace archimedes {
+// raw lifetime operations for some type, operating on untyped storage
+// emitted by the plugin for reflected records (see reflected_type::ops()) and
+// generated for any::make<T>. any op is nullptr if the type does not support
+// it, dst is always uninitialized storage.
+struct value_ops {
+    // default construct into p
+    void (*construct)(void *p) = nullptr;
+
+    // copy construct from src into dst
+    void (*copy)(void *dst, const void *src) = nullptr;
+
+    // move construct from src into dst, src is left in moved-from state
+    // copies if T has no move ctor
+    void (*move)(void *dst, void *src) = nullptr;
+
+    // destroy value at p, nullptr if trivially destructible
+    void (*destroy)(void *p) = nullptr;
+
+    // swap values at a and b
+    void (*swap)(void *a, void *b) = nullptr;
+
+    // true if values can be copied/moved with memcpy and need no destructor
+    // copy/move may be nullptr for trivial types, see detail::trivial_ops
+    bool is_trivial = false;
+};
+
+// make value_ops for T
+template <typename T>
+constexpr value_ops make_value_ops() {
+    value_ops ops;
+
+    if constexpr (std::is_default_constructible_v<T>) {
+        ops.construct = [](void *p) { ::new (p) T(); };
+    }
+
+    if constexpr (std::is_copy_constructible_v<T>) {
+        ops.copy =
+            [](void *dst, const void *src) {
+                ::new (dst) T(*reinterpret_cast<const T*>(src));
+            };
+    } else if constexpr (
+        std::is_copy_assignable_v<T>
+        && std::is_default_constructible_v<T>) {
+        ops.copy =
+            [](void *dst, const void *src) {
+                ::new (dst) T();
+                *reinterpret_cast<T*>(dst) = *reinterpret_cast<const T*>(src);
+            };
+    }
+
+    if constexpr (std::is_move_constructible_v<T>) {
+        ops.move =
+            [](void *dst, void *src) {
+                ::new (dst) T(std::move(*reinterpret_cast<T*>(src)));
+            };
+    }
+
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        ops.destroy = [](void *p) { std::destroy_at(reinterpret_cast<T*>(p)); };
+    }
+
+    if constexpr (std::is_swappable_v<T>) {
+        ops.swap =
+            [](void *a, void *b) {
+                using std::swap;
+                swap(*reinterpret_cast<T*>(a), *reinterpret_cast<T*>(b));
+            };
+    }
+
+    ops.is_trivial =
+        std::is_trivially_copyable_v<T>
+            && std::is_trivially_destructible_v<T>;
+    return ops;
+}
+
+// static value_ops instance for T
+template <typename T>
+inline constexpr value_ops value_ops_of = make_value_ops<T>();
+
+namespace detail {
+// ops for trivial values of unknown type (fx. reflected numeric types),
+// copied/moved with memcpy by the caller
+inline constexpr value_ops trivial_ops = { .is_trivial = true };
+} // namespace detail
+} // namespace archimedes
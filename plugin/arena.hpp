@@ -0,0 +1,50 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <llvm/Support/Allocator.h>
+
+namespace archimedes {
+// bump allocator for objects whose lifetimes are all tied to one owner (the
+// plugin Context). objects are never freed individually, everything is torn
+// down at once when the arena is destroyed.
+struct Arena {
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena &operator=(const Arena&) = delete;
+
+    ~Arena() {
+        // destroy in reverse order of construction
+        for (auto it = this->dtors.rbegin(); it != this->dtors.rend(); it++) {
+            it->second(it->first);
+        }
+    }
+
+    // construct a T in the arena
+    template <typename T, typename ...Args>
+    T &make(Args&&... args) {
+        void *p = this->allocator.Allocate(sizeof(T), alignof(T));
+        auto *t = new (p) T(std::forward<Args>(args)...);
+
+        // trivially destructible types need no bookkeeping
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            this->dtors.emplace_back(
+                t,
+                [](void *q) { static_cast<T*>(q)->~T(); });
+        }
+
+        return *t;
+    }
+
+    // total bytes allocated by the underlying allocator
+    size_t bytes() const {
+        return this->allocator.getTotalMemory();
+    }
+
+private:
+    llvm::BumpPtrAllocator allocator;
+    std::vector<std::pair<void*, void(*)(void*)>> dtors;
+};
+}
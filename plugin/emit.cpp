@@ -9,13 +9,17 @@
 using namespace archimedes;
 using namespace archimedes::detail;
 
-// emit serialized data as an std::span<const uint8_t>
-// F(std::ostream) is called to populate data
+// name of module being emitted (main source file), see load_stats()
+static std::string module_name(const Context &ctx) {
+    const auto &sm = ctx.ast_ctx->getSourceManager();
+    const auto *entry = sm.getFileEntryForID(sm.getMainFileID());
+    return entry ? std::string(entry->tryGetRealPathName()) : "";
+}
+
+// stream buffer writing into a byte vector
 template <typename F>
     requires (requires (F f, std::ostream &os) { f(os); })
-static std::string emit_serialized(
-    std::string_view name,
-    F &&f) {
+static vector<uint8_t> write_bytes(F &&f) {
     struct outbuf : public std::streambuf {
         vector<uint8_t> &buf;
 
@@ -35,15 +39,67 @@ static std::string emit_serialized(
     outbuf ob(data);
     std::ostream os(&ob);
     f(os);
+    return data;
+}
+
+// serialize into a byte buffer prefixed by a header, F(std::ostream) is
+// called to populate data. strings are added to table.
+template <typename F>
+    requires (requires (F f, std::ostream &os) { f(os); })
+static vector<uint8_t> serialize_to_bytes(
+    const Context &ctx,
+    string_table_writer &table,
+    F &&f) {
+    StatsScope scope(ctx.stats, PHASE_SERIALIZE);
+    auto data =
+        write_bytes(
+            [&](std::ostream &os) {
+                set_stream_string_table(os, &table);
+                serialize_header(os, ctx.included_metadata);
+                f(os);
+            });
+    ctx.stats.serialized_bytes += data.size();
+    return data;
+}
+
+// serialize a string table
+static vector<uint8_t> string_table_to_bytes(
+    const Context &ctx,
+    const string_table_writer &table) {
+    StatsScope scope(ctx.stats, PHASE_SERIALIZE);
+    auto data =
+        write_bytes(
+            [&](std::ostream &os) { serialize_string_table(os, table); });
+    ctx.stats.serialized_bytes += data.size();
+    return data;
+}
+
+// emit bytes as an std::span<const uint8_t>
+static std::string emit_span(
+    std::string_view name,
+    std::span<const uint8_t> data) {
     return fmt::format(R"(
             static const uint8_t {0}_internal[] = {1};
             static const std::span<const uint8_t, {2}> {0} = {{ {0}_internal }};
         )",
         name,
-        emit_data(std::span { data }),
+        emit_data(data),
         data.size());
 }
 
+// emit serialized data as an std::span<const uint8_t>
+// F(std::ostream) is called to populate data
+template <typename F>
+    requires (requires (F f, std::ostream &os) { f(os); })
+static std::string emit_serialized(
+    const Context &ctx,
+    string_table_writer &table,
+    std::string_view name,
+    F &&f) {
+    const auto data = serialize_to_bytes(ctx, table, std::forward<F>(f));
+    return emit_span(name, std::span { data });
+}
+
 // emit a vector of Ts with specified name and type name to module
 // F(T) is cpp-ifier for Ts
 template <typename T, typename F>
@@ -59,128 +115,707 @@ static std::string emit_module_vector(
         type_name, name, emit_vector(vs, std::forward<F>(f)));
 }
 
-std::string archimedes::emit(Context &ctx) {
-    std::string output;
+// arrays of values which are referenced by index from serialized data, either
+// for a whole module or for one type entry in "gc-sections" mode
+struct module_arrays {
+    vector<std::tuple<const type_info*, const type_info*>> dyncasts;
+    vector<const std::string*> constexpr_exprs;
+    vector<const Invoker*> invokers;
+    vector<const std::string*> template_param_exprs;
+    vector<std::string> type_id_hash_exprs;
+    vector<const type_info*> value_ops;
+};
+
+// true if dyncasts can be generated between a and b
+static bool can_dyncast(
+    const Context &ctx,
+    const type_info &a,
+    const type_info &b) {
+    const auto
+        *rd_a = clang::dyn_cast<clang::CXXRecordDecl>(a.internal->decl),
+        *rd_b = clang::dyn_cast<clang::CXXRecordDecl>(b.internal->decl);
+    return rd_a->isPolymorphic()
+        && rd_b->isPolymorphic()
+        && can_emit_type(ctx, a.internal->type)
+        && can_emit_type(ctx, b.internal->type);
+}
+
+// special member function an invoker is for, if any
+static std::optional<ImplicitFunction> special_member_kind(const Invoker &i) {
+    if (i.if_kind) {
+        return i.if_kind;
+    }
+
+    if (const auto *cd =
+            clang::dyn_cast_or_null<clang::CXXConstructorDecl>(i.decl)) {
+        unsigned quals = 0;
+        if (cd->isDefaultConstructor()) {
+            return ImplicitFunction::DEFAULT_CTOR;
+        } else if (
+            cd->isCopyConstructor(quals)
+                && (quals & clang::Qualifiers::Const)) {
+            return ImplicitFunction::COPY_CTOR;
+        } else if (cd->isMoveConstructor()) {
+            return ImplicitFunction::MOVE_CTOR;
+        }
+    } else if (clang::isa_and_nonnull<clang::CXXDestructorDecl>(i.decl)) {
+        return ImplicitFunction::DTOR;
+    } else if (
+        const auto *md =
+            clang::dyn_cast_or_null<clang::CXXMethodDecl>(i.decl)) {
+        // copy assignment must accept a const T&
+        const auto param_type =
+            md->getNumParams() == 1 ?
+                md->getParamDecl(0)->getType()
+                : clang::QualType();
+        if (md->isCopyAssignmentOperator()
+                && !(param_type->isLValueReferenceType()
+                    && !param_type->getPointeeType().isConstQualified())) {
+            return ImplicitFunction::COPY_ASSIGN;
+        } else if (md->isMoveAssignmentOperator()) {
+            return ImplicitFunction::MOVE_ASSIGN;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// special member functions of record t which can be called from emitted code,
+// that is those which have invokers
+static std::array<bool, static_cast<size_t>(ImplicitFunction::COUNT)>
+    invokable_special_members(const type_info &t) {
+    std::array<bool, static_cast<size_t>(ImplicitFunction::COUNT)> result = {};
+    for (const auto &[_, fos] : t.record.functions) {
+        for (const auto &f : fos.functions) {
+            if (!f.internal->invoker) {
+                continue;
+            }
+
+            if (const auto kind = special_member_kind(*f.internal->invoker)) {
+                result[static_cast<size_t>(*kind)] = true;
+            }
+        }
+    }
+    return result;
+}
+
+// true if value_ops can be emitted for record t
+static bool can_emit_value_ops(const Context &ctx, const type_info &t) {
+    if (!can_emit_type(ctx, t.internal->type)) {
+        return false;
+    }
+
+    const auto fs = invokable_special_members(t);
+    return std::any_of(fs.begin(), fs.end(), [](bool b) { return b; });
+}
+
+// emit value_ops for record t as a static named name, each op is a
+// captureless lambda calling the corresponding special member function
+static std::string emit_value_ops(
+    Context &ctx,
+    const type_info &t,
+    std::string_view name,
+    std::string_view attributes = "") {
+    const auto fs = invokable_special_members(t);
+    const auto has =
+        [&](ImplicitFunction f) { return fs[static_cast<size_t>(f)]; };
+
+    ctx.register_emitted_type(*t.internal->type);
+    const auto type = emit_type(ctx, *t.internal->type);
+
+    std::string construct = "nullptr";
+    if (has(ImplicitFunction::DEFAULT_CTOR)) {
+        construct =
+            fmt::format("+[](void *p) {{ ::new (p) {}(); }}", type);
+    }
+
+    std::string copy = "nullptr", move = "nullptr";
+    if (has(ImplicitFunction::COPY_CTOR)) {
+        copy =
+            fmt::format(R"(
+                    +[](void *dst, const void *src) {{
+                        ::new (dst) {0}(*reinterpret_cast<const {0}*>(src));
+                    }}
+                )",
+                type);
+
+        // copy if there is no move ctor
+        move =
+            fmt::format(R"(
+                    +[](void *dst, void *src) {{
+                        ::new (dst) {0}(*reinterpret_cast<const {0}*>(src));
+                    }}
+                )",
+                type);
+    } else if (
+        has(ImplicitFunction::COPY_ASSIGN)
+            && has(ImplicitFunction::DEFAULT_CTOR)) {
+        copy =
+            fmt::format(R"(
+                    +[](void *dst, const void *src) {{
+                        ::new (dst) {0}();
+                        *reinterpret_cast<{0}*>(dst) =
+                            *reinterpret_cast<const {0}*>(src);
+                    }}
+                )",
+                type);
+    }
+
+    if (has(ImplicitFunction::MOVE_CTOR)) {
+        move =
+            fmt::format(R"(
+                    +[](void *dst, void *src) {{
+                        ::new (dst) {0}(
+                            std::move(*reinterpret_cast<{0}*>(src)));
+                    }}
+                )",
+                type);
+    }
+
+    std::string destroy = "nullptr";
+    if (has(ImplicitFunction::DTOR) && !t.record.has_trivial_dtor) {
+        destroy =
+            fmt::format(
+                "+[](void *p) {{ std::destroy_at(reinterpret_cast<{}*>(p)); }}",
+                type);
+    }
+
+    // std::swap needs move construction and assignment, which fall back to
+    // copying unless they are user-declared (and possibly deleted)
+    const auto *rd =
+        clang::cast<clang::CXXRecordDecl>(t.internal->decl)->getDefinition();
+    const auto can_swap =
+        has(ImplicitFunction::DTOR)
+            && (has(ImplicitFunction::MOVE_CTOR)
+                || (has(ImplicitFunction::COPY_CTOR)
+                    && !rd->hasUserDeclaredMoveConstructor()))
+            && (has(ImplicitFunction::MOVE_ASSIGN)
+                || (has(ImplicitFunction::COPY_ASSIGN)
+                    && !rd->hasUserDeclaredMoveAssignment()));
+
+    std::string swap = "nullptr";
+    if (can_swap) {
+        swap =
+            fmt::format(R"(
+                    +[](void *a, void *b) {{
+                        using std::swap;
+                        swap(
+                            *reinterpret_cast<{0}*>(a),
+                            *reinterpret_cast<{0}*>(b));
+                    }}
+                )",
+                type);
+    }
+
+    return fmt::format(R"(
+            {0} static const archimedes::value_ops {1} = {{
+                .construct = {2},
+                .copy = {3},
+                .move = {4},
+                .destroy = {5},
+                .swap = {6},
+                .is_trivial = {7}
+            }};
+        )",
+        attributes,
+        name,
+        construct,
+        copy,
+        move,
+        destroy,
+        swap,
+        t.record.is_trivially_copyable && t.record.has_trivial_dtor);
+}
+
+// register invokers for the function set
+static void register_invokers(
+    function_overload_set &fos,
+    module_arrays &arrays) {
+    for (auto &f : fos.functions) {
+        if (!f.internal->invoker) {
+            f.invoker_index = NO_ARRAY_INDEX;
+            continue;
+        }
+
+        f.invoker_index = arrays.invokers.size();
+        arrays.invokers.push_back(f.internal->invoker);
+    }
+}
+
+// assign array indices for all indexed values of record type t
+static void register_record(
+    Context &ctx,
+    type_info &t,
+    module_arrays &arrays) {
+    // only emit type_id(...) exprs for struct/union types
+    if (can_emit_type(ctx, t.internal->type)) {
+        t.type_id_hash_index = arrays.type_id_hash_exprs.size();
+        arrays.type_id_hash_exprs.push_back(
+            fmt::format(
+                "typeid({}).hash_code()",
+                get_full_type_name(
+                    ctx, *t.internal->type, TNF_ARRAYS_TO_POINTERS)));
+    }
+
+    for (auto &p : t.record.template_parameters) {
+        if (p.is_typename) {
+            continue;
+        }
+
+        // TODO: do we need to register?
+        ctx.register_emitted_type(*p.type.id->internal->type);
+        p.value_index = arrays.template_param_exprs.size();
+        arrays.template_param_exprs.push_back(&p.internal->value_expr);
+    }
+
+    for (auto &b : t.record.bases) {
+        if (!can_dyncast(ctx, *b.parent_id, *b.id)) {
+            b.dyncast_up_index = NO_ARRAY_INDEX;
+            b.dyncast_down_index = NO_ARRAY_INDEX;
+            continue;
+        }
+
+        b.dyncast_up_index = arrays.dyncasts.size();
+        arrays.dyncasts.push_back(
+            std::make_tuple(
+                &*b.parent_id,
+                &*b.id));
+        b.dyncast_down_index = arrays.dyncasts.size();
+        arrays.dyncasts.push_back(
+            std::make_tuple(
+                &*b.id,
+                &*b.parent_id));
+    }
+
+    for (auto &[_, f] : t.record.static_fields) {
+        if (!f.is_constexpr
+                || f.internal->constexpr_expr.empty()) {
+            f.constexpr_value_index = NO_ARRAY_INDEX;
+            continue;
+        }
+
+        ctx.register_emitted_type(*t.internal->type);
+        f.constexpr_value_index = arrays.constexpr_exprs.size();
+        arrays.constexpr_exprs.push_back(&f.internal->constexpr_expr);
+    }
+
+    for (auto &[_, fos] : t.record.functions) {
+        register_invokers(fos, arrays);
+    }
+
+    if (can_emit_value_ops(ctx, t)) {
+        t.value_ops_index = arrays.value_ops.size();
+        arrays.value_ops.push_back(&t);
+    } else {
+        t.value_ops_index = NO_ARRAY_INDEX;
+    }
+}
+
+// emit dyncast from -> to as a captureless lambda
+static std::string emit_dyncast(
+    Context &ctx,
+    const std::tuple<const type_info*, const type_info*> &t) {
+    const auto &[from, to] = t;
+    ctx.register_emitted_type(*from->internal->type);
+    ctx.register_emitted_type(*to->internal->type);
+    return
+        fmt::format(R"(
+                [](void *p) -> void* {{
+                    return dynamic_cast<{}*>(
+                        reinterpret_cast<{}*>(p));
+                }}
+            )",
+            emit_type(ctx, *to->internal->type),
+            emit_type(ctx, *from->internal->type));
+}
+
+// call f(id) for each type id directly referenced by t
+template <typename F>
+static void for_each_dependency(const type_info &t, F &&f) {
+    const auto visit =
+        [&f](type_id id) {
+            if (id != type_id::none()) {
+                f(id);
+            }
+        };
+
+    visit(t.type.id);
+    visit(t.member_ptr.class_type);
+    visit(t.enum_.base_type.id);
+    visit(t.function.return_type.id);
+
+    for (const auto &p : t.function.parameters) {
+        visit(p.id);
+    }
+
+    for (const auto &p : t.record.template_parameters) {
+        visit(p.type.id);
+    }
+
+    for (const auto &b : t.record.bases) {
+        visit(b.id);
+    }
+
+    for (const auto &[_, td] : t.record.typedefs) {
+        visit(td.aliased_type.id);
+    }
+
+    for (const auto &[_, fi] : t.record.fields) {
+        visit(fi.type.id);
+    }
+
+    for (const auto &[_, fi] : t.record.static_fields) {
+        visit(fi.type.id);
+    }
+
+    for (const auto &[_, fos] : t.record.functions) {
+        for (const auto &fi : fos.functions) {
+            visit(fi.id);
+        }
+    }
+}
+
+// name of emitted module_type_entry for runtime type id
+static std::string entry_name(type_id id) {
+    return fmt::format("type_{:016x}", id.value());
+}
+
+// emits a static array named name of element type type_name in section
+// section, returns the expression to initialize a span over it with ("{}" if
+// empty as zero length arrays are not allowed)
+template <typename T, typename F>
+    requires (requires (F f, T t) {{ f(t) } -> std::same_as<std::string>; })
+static std::string emit_entry_array(
+    std::string &output,
+    std::string_view name,
+    std::string_view type_name,
+    std::string_view section,
+    const vector<T> &vs,
+    F &&f) {
+    if (vs.empty()) {
+        return "{}";
+    }
 
-    // TODO: optional RTTI
-    // preamble
     output +=
         fmt::format(R"(
-                #include "{}"
-                #include <typeinfo>
-                // ignored diagnostics in generated code
-                #pragma clang diagnostic ignored "-Wmain"
-                #pragma clang diagnostic ignored "-Wimplicitly-unsigned-literal"
+                ARCHIMEDES_SECTION("{}")
+                static const {} {}[] = {};
             )",
-            fs::relative(
-                ctx.header_path,
-                ctx.output_path.parent_path()).string());
+            section,
+            type_name,
+            name,
+            emit_vector(vs, std::forward<F>(f)));
+    return std::string(name);
+}
 
-    // emit invokers
-    for (const auto &i : ctx.invokers) {
-        output += emit_invoker(ctx, *i);
+// emit one module_type_entry per type for "gc-sections" mode along with a
+// loader for the types which are roots in this module, see
+// registry::load_module_entries
+static std::string emit_type_entries(Context &ctx) {
+    std::string output;
+
+    // types can appear multiple times (fx. unknown types), pick one info per
+    // runtime id and prefer those which are resolved
+    map<type_id, type_info*> entries;
+    for (const auto &t : ctx.types) {
+        const auto id = type_id::from(t->type_name);
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            entries.emplace(id, t);
+        } else if (it->second->kind == UNKNOWN && t->kind != UNKNOWN) {
+            it->second = t;
+        }
     }
 
-    // traverse context data and assign indices
-    vector<std::tuple<const type_info*, const type_info*>> dyncasts;
-    vector<const std::string*> constexpr_exprs;
-    vector<const Invoker*> invokers;
-    vector<const std::string*> template_param_exprs;
-    vector<std::string> type_id_hash_exprs;
+    constexpr auto ENTRY_TYPE = "archimedes::detail::module_type_entry";
+    constexpr auto ENTRY_NAMESPACE = "archimedes::detail::module_types";
 
-    // true if dyncasts can be generated between a and b
-    const auto can_dyncast =
-        [&ctx](const type_info &a, const type_info &b) {
-            const auto
-                *rd_a = clang::dyn_cast<clang::CXXRecordDecl>(a.internal->decl),
-                *rd_b = clang::dyn_cast<clang::CXXRecordDecl>(b.internal->decl);
-            return rd_a->isPolymorphic()
-                && rd_b->isPolymorphic()
-                && can_emit_type(ctx, a.internal->type)
-                && can_emit_type(ctx, b.internal->type);
-        };
+    // declare all entries up front as they reference each other
+    output += fmt::format("namespace {} {{\n", ENTRY_NAMESPACE);
+    for (const auto &[id, _] : entries) {
+        output +=
+            fmt::format("extern const {} {};\n", ENTRY_TYPE, entry_name(id));
+    }
+    output += "}\n";
 
-    // register invokers for the function set
-    const auto register_invokers =
-        [&](function_overload_set &fos) {
-            for (auto &f : fos.functions) {
-                if (!f.internal->invoker) {
-                    f.invoker_index = NO_ARRAY_INDEX;
-                    continue;
-                }
+    for (auto &[id, t] : entries) {
+        const auto name = entry_name(id);
+        const auto section = fmt::format(".archimedes.{}", name);
+
+        module_arrays arrays;
+        if ((t->kind == STRUCT || t->kind == UNION)
+                && t->internal->is_resolved) {
+            register_record(ctx, *t, arrays);
+        }
+
+        // type_id hash is emitted as a function rather than by index
+        const auto type_id_hash =
+            t->type_id_hash_index == NO_ARRAY_INDEX ?
+                std::string("nullptr")
+                : fmt::format(
+                    "+[]() -> size_t {{ return {}; }}",
+                    arrays.type_id_hash_exprs[t->type_id_hash_index]);
+        t->type_id_hash_index = NO_ARRAY_INDEX;
+
+        // as are value ops
+        std::string ops = "nullptr";
+        if (t->value_ops_index != NO_ARRAY_INDEX) {
+            ops = fmt::format("&_{}_ops", name);
+            output +=
+                emit_value_ops(
+                    ctx,
+                    *t,
+                    fmt::format("_{}_ops", name),
+                    fmt::format("ARCHIMEDES_SECTION(\"{}\")", section));
+        }
+        t->value_ops_index = NO_ARRAY_INDEX;
 
-                f.invoker_index = invokers.size();
-                invokers.push_back(f.internal->invoker);
+        set<type_id> dep_set;
+        for_each_dependency(
+            *t,
+            [&](type_id dep) {
+                dep_set.emplace(type_id::from(dep->type_name));
+            });
+        dep_set.erase(id);
+
+        // serialized data has no relocations, cannot share a section with
+        // the arrays of pointers below. each entry has its own string table
+        // as it may be the only one kept by the linker.
+        string_table_writer table;
+        const auto data =
+            serialize_to_bytes(
+                ctx,
+                table,
+                [&](std::ostream &os) { serialize(os, *t); });
+        const auto strings_data = string_table_to_bytes(ctx, table);
+        output +=
+            fmt::format(R"(
+                    ARCHIMEDES_SECTION("{0}.data")
+                    static const uint8_t _{1}_data[] = {2};
+                    ARCHIMEDES_SECTION("{0}.data")
+                    static const uint8_t _{1}_strings[] = {3};
+                )",
+                section,
+                name,
+                emit_data(std::span { data }),
+                emit_data(std::span { strings_data }));
+
+        const auto deps =
+            emit_entry_array(
+                output,
+                fmt::format("_{}_deps", name),
+                fmt::format("{} *const", ENTRY_TYPE),
+                section,
+                vector<type_id>(dep_set.begin(), dep_set.end()),
+                [&](type_id dep) {
+                    return fmt::format(
+                        "&{}::{}", ENTRY_NAMESPACE, entry_name(dep));
+                });
+
+        const auto dyncasts =
+            emit_entry_array(
+                output,
+                fmt::format("_{}_dyncasts", name),
+                "archimedes::detail::dyncast_ptr",
+                section,
+                arrays.dyncasts,
+                [&](const auto &d) {
+                    return "+" + emit_dyncast(ctx, d);
+                });
+
+        const auto constexpr_values =
+            emit_entry_array(
+                output,
+                fmt::format("_{}_constexpr_values", name),
+                "archimedes::detail::value_thunk",
+                section,
+                arrays.constexpr_exprs,
+                [](const std::string *s) {
+                    return fmt::format(
+                        "+[]() -> archimedes::any {{ return {}; }}",
+                        emit_any(*s));
+                });
+
+        const auto invokers =
+            emit_entry_array(
+                output,
+                fmt::format("_{}_invokers", name),
+                "archimedes::detail::invoker_ptr",
+                section,
+                arrays.invokers,
+                [](const Invoker *i) -> std::string {
+                    return fmt::format("&{}", i->generated_name());
+                });
+
+        const auto template_param_values =
+            emit_entry_array(
+                output,
+                fmt::format("_{}_template_param_values", name),
+                "archimedes::detail::value_thunk",
+                section,
+                arrays.template_param_exprs,
+                [](const std::string *s) {
+                    return fmt::format(
+                        "+[]() -> archimedes::any {{ return {}; }}",
+                        emit_any(*s));
+                });
+
+        // weak so that only one definition survives when multiple modules
+        // reflect the same type
+        output +=
+            fmt::format(R"(
+                    ARCHIMEDES_SECTION("{0}") __attribute__((weak))
+                    extern const {1} {2}::{3} = {{
+                        .data = _{3}_data,
+                        .strings = _{3}_strings,
+                        .deps = {4},
+                        .dyncasts = {5},
+                        .constexpr_values = {6},
+                        .invokers = {7},
+                        .template_param_values = {8},
+                        .type_id_hash = {9},
+                        .ops = {10}
+                    }};
+                )",
+                section,
+                ENTRY_TYPE,
+                ENTRY_NAMESPACE,
+                name,
+                deps,
+                dyncasts,
+                constexpr_values,
+                invokers,
+                template_param_values,
+                type_id_hash,
+                ops);
+    }
+
+    // roots are types explicitly marked for reflection along with all types
+    // referenced by free functions and typedefs
+    set<type_id> roots;
+    const auto add_root =
+        [&](type_id id) {
+            if (id != type_id::none()) {
+                roots.emplace(type_id::from(id->type_name));
             }
         };
 
-    // record types
     for (const auto &t : ctx.types) {
-        if ((t->kind != STRUCT && t->kind != UNION)
-            || !t->internal->is_resolved) {
-            continue;
+        if (t->internal->decl
+                && ctx.enabled_in_hierarchy(t->internal->decl)) {
+            add_root(t->id);
         }
+    }
 
-        // only emit type_id(...) exprs for struct/union types
-        if (can_emit_type(ctx, t->internal->type)) {
-            t->type_id_hash_index = type_id_hash_exprs.size();
-            type_id_hash_exprs.push_back(
-                fmt::format(
-                    "typeid({}).hash_code()",
-                    get_full_type_name(
-                        ctx, *t->internal->type, TNF_ARRAYS_TO_POINTERS)));
+    for (const auto &[_, fos] : ctx.functions) {
+        for (const auto &f : fos.functions) {
+            add_root(f.id);
         }
+    }
 
-        for (auto &p : t->record.template_parameters) {
-            if (p.is_typename) {
-                continue;
-            }
+    if (ctx.included_metadata & METADATA_TYPEDEFS) {
+        for (const auto &td : ctx.typedefs) {
+            add_root(td.aliased_type.id);
+        }
+    }
 
-            // TODO: do we need to register?
-            ctx.register_emitted_type(*p.type.id->internal->type);
-            p.value_index = template_param_exprs.size();
-            template_param_exprs.push_back(&p.internal->value_expr);
+    // types kept through ARCHIMEDES_REFLECT_TYPE but reflected in some other
+    // module are referenced weakly, only possible on ELF targets
+    vector<std::string> root_exprs;
+    std::string extern_roots;
+    for (const auto &n : ctx.kept_type_names) {
+        const auto id = type_id::from(n);
+        if (entries.contains(id)) {
+            roots.emplace(id);
+            continue;
         }
 
-        for (auto &b : t->record.bases) {
-            if (!can_dyncast(*b.parent_id, *b.id)) {
-                b.dyncast_up_index = NO_ARRAY_INDEX;
-                b.dyncast_down_index = NO_ARRAY_INDEX;
-                continue;
-            }
+        extern_roots +=
+            fmt::format(
+                "namespace {} {{ extern const {} {} __attribute__((weak)); }}\n",
+                ENTRY_NAMESPACE,
+                ENTRY_TYPE,
+                entry_name(id));
+        root_exprs.push_back(
+            fmt::format(
+                "\n#if defined(__ELF__)\n&{}::{},\n#endif\n",
+                ENTRY_NAMESPACE,
+                entry_name(id)));
+    }
+
+    if (!extern_roots.empty()) {
+        output += "\n#if defined(__ELF__)\n" + extern_roots + "#endif\n";
+    }
+
+    for (const auto &id : roots) {
+        root_exprs.push_back(
+            fmt::format("&{}::{},", ENTRY_NAMESPACE, entry_name(id)));
+    }
+
+    // always emit at least one (null) root, empty arrays are not allowed
+    root_exprs.push_back("nullptr");
 
-            b.dyncast_up_index = dyncasts.size();
-            dyncasts.push_back(
-                std::make_tuple(
-                    &*b.parent_id,
-                    &*b.id));
-            b.dyncast_down_index = dyncasts.size();
-            dyncasts.push_back(
-                std::make_tuple(
-                    &*b.id,
-                    &*b.parent_id));
+    output +=
+        fmt::format(R"(
+                static const {0} *const _module_type_roots[] = {{ {1} }};
+                static const auto _module_entries_loader =
+                    ({2}::instance().load_module_entries(
+                        {3},
+                        _module_type_roots), 0);
+            )",
+            ENTRY_TYPE,
+            fmt::join(root_exprs, ""),
+            NAMEOF_TYPE(archimedes::detail::registry),
+            emit_string(module_name(ctx)));
+
+    return output;
+}
+
+std::string archimedes::emit(Context &ctx) {
+    std::string output;
+
+    // TODO: optional RTTI
+    // preamble
+    output +=
+        fmt::format(R"(
+                #include "{}"
+                #include <typeinfo>
+                // ignored diagnostics in generated code
+                #pragma clang diagnostic ignored "-Wmain"
+                #pragma clang diagnostic ignored "-Wimplicitly-unsigned-literal"
+            )",
+            fs::relative(
+                ctx.header_path,
+                ctx.output_path.parent_path()).string());
+
+    // emit invokers
+    {
+        StatsScope scope(ctx.stats, PHASE_INVOKERS);
+        for (const auto &i : ctx.invokers) {
+            output += emit_invoker(ctx, *i);
         }
+    }
+
+    // traverse context data and assign indices
+    // in "gc-sections" mode types are emitted separately, see
+    // emit_type_entries
+    module_arrays arrays;
 
-        for (auto &[_, f] : t->record.static_fields) {
-            if (!f.is_constexpr
-                    || f.internal->constexpr_expr.empty()) {
-                f.constexpr_value_index = NO_ARRAY_INDEX;
+    // record types
+    if (!ctx.gc_sections) {
+        for (const auto &t : ctx.types) {
+            if ((t->kind != STRUCT && t->kind != UNION)
+                || !t->internal->is_resolved) {
                 continue;
             }
 
-            ctx.register_emitted_type(*t->internal->type);
-            f.constexpr_value_index = constexpr_exprs.size();
-            constexpr_exprs.push_back(&f.internal->constexpr_expr);
-        }
-
-        for (auto &[_, fos] : t->record.functions) {
-            register_invokers(fos);
+            register_record(ctx, *t, arrays);
         }
     }
 
     // free functions
     for (auto &[_, fos] : ctx.functions) {
-        register_invokers(fos);
+        register_invokers(fos, arrays);
     }
 
     constexpr auto
@@ -188,27 +823,17 @@ std::string archimedes::emit(Context &ctx) {
         CONSTEXPR_VALUES_NAME = "_module_constexpr_values",
         INVOKERS_NAME = "_module_invokers",
         TEMPLATE_PARAM_VALUES_NAME = "_module_template_param_values",
-        TYPE_ID_HASHES_NAME = "_type_id_hashes";
+        TYPE_ID_HASHES_NAME = "_type_id_hashes",
+        VALUE_OPS_NAME = "_module_value_ops";
 
     // emit dyncast array
     output +=
         emit_module_vector(
             DYNCASTS_NAME,
             "std::function<void*(void*)>",
-            dyncasts,
+            arrays.dyncasts,
             [&ctx](const auto &t) -> std::string {
-                const auto &[from, to] = t;
-                ctx.register_emitted_type(*from->internal->type);
-                ctx.register_emitted_type(*to->internal->type);
-                return
-                    fmt::format(R"(
-                            ([](void *p) -> void* {{
-                                return dynamic_cast<{}*>(
-                                    reinterpret_cast<{}*>(p));
-                            }})
-                        )",
-                        emit_type(ctx, *to->internal->type),
-                        emit_type(ctx, *from->internal->type));
+                return "(" + emit_dyncast(ctx, t) + ")";
             });
 
     // emit constexpr value array
@@ -216,7 +841,7 @@ std::string archimedes::emit(Context &ctx) {
         emit_module_vector(
             CONSTEXPR_VALUES_NAME,
             NAMEOF_TYPE(archimedes::any),
-            constexpr_exprs,
+            arrays.constexpr_exprs,
             [](const std::string *s) -> std::string {
                 return emit_any(*s);
             });
@@ -226,7 +851,7 @@ std::string archimedes::emit(Context &ctx) {
         emit_module_vector(
             INVOKERS_NAME,
             "archimedes::detail::invoker_ptr",
-            invokers,
+            arrays.invokers,
             [](const Invoker *i) -> std::string {
                 return fmt::format("&{}", i->generated_name());
             });
@@ -236,7 +861,7 @@ std::string archimedes::emit(Context &ctx) {
         emit_module_vector(
             TEMPLATE_PARAM_VALUES_NAME,
             NAMEOF_TYPE(archimedes::any),
-            template_param_exprs,
+            arrays.template_param_exprs,
             [](const std::string *s) -> std::string {
                 return emit_any(*s);
             });
@@ -247,18 +872,39 @@ std::string archimedes::emit(Context &ctx) {
         emit_module_vector(
             TYPE_ID_HASHES_NAME,
             "size_t",
-            type_id_hash_exprs,
+            arrays.type_id_hash_exprs,
             [](const std::string &s) { return s; });
 
+    // emit value ops and array of pointers to them
+    vector<std::string> value_ops_names;
+    for (const auto *t : arrays.value_ops) {
+        value_ops_names.push_back(
+            fmt::format("{}_{}", VALUE_OPS_NAME, value_ops_names.size()));
+        output += emit_value_ops(ctx, *t, value_ops_names.back());
+    }
+
+    output +=
+        emit_module_vector(
+            VALUE_OPS_NAME,
+            "const archimedes::value_ops*",
+            value_ops_names,
+            [](const std::string &s) { return "&" + s; });
+
     constexpr auto
+        STRINGS_NAME = "_module_strings",
         FUNCTIONS_NAME = "_module_functions",
         TYPES_NAME = "_module_types",
         TYPEDEFS_NAME = "_module_typedefs",
         NAMESPACE_ALIASES_NAME = "_module_aliases",
         NAMESPACE_USINGS_NAME = "_module_usings";
 
+    // all blobs of this module share one string table
+    string_table_writer strings;
+
     output +=
         emit_serialized(
+            ctx,
+            strings,
             FUNCTIONS_NAME,
             [&](std::ostream &os) {
                 serialize(os, ctx.functions);
@@ -266,20 +912,34 @@ std::string archimedes::emit(Context &ctx) {
 
     output +=
         emit_serialized(
+            ctx,
+            strings,
             TYPES_NAME,
             [&](std::ostream &os) {
-                serialize(os, ctx.types);
+                if (ctx.gc_sections) {
+                    serialize(os, decltype(ctx.types)());
+                } else {
+                    serialize(os, ctx.types);
+                }
             });
 
     output +=
         emit_serialized(
+            ctx,
+            strings,
             TYPEDEFS_NAME,
             [&](std::ostream &os) {
-                serialize(os, ctx.typedefs);
+                if (ctx.included_metadata & METADATA_TYPEDEFS) {
+                    serialize(os, ctx.typedefs);
+                } else {
+                    serialize(os, decltype(ctx.typedefs)());
+                }
             });
 
     output +=
         emit_serialized(
+            ctx,
+            strings,
             NAMESPACE_ALIASES_NAME,
             [&](std::ostream &os) {
                 serialize(os, ctx.namespace_aliases);
@@ -287,28 +947,41 @@ std::string archimedes::emit(Context &ctx) {
 
     output +=
         emit_serialized(
+            ctx,
+            strings,
             NAMESPACE_USINGS_NAME,
             [&](std::ostream &os) {
                 serialize(os, ctx.namespace_usings);
             });
 
+    const auto strings_data = string_table_to_bytes(ctx, strings);
+    output += emit_span(STRINGS_NAME, std::span { strings_data });
+
     // emit loader
     output += fmt::format(R"(
         static const auto _module_loader =
-            ({}::instance().load_module({}, {}, {}, {}, {}, {}, {}, {}, {}, {}), 0);
+            ({}::instance().load_module(
+                {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}), 0);
         )",
         NAMEOF_TYPE(archimedes::detail::registry),
+        emit_string(module_name(ctx)),
         DYNCASTS_NAME,
         CONSTEXPR_VALUES_NAME,
         INVOKERS_NAME,
         TEMPLATE_PARAM_VALUES_NAME,
         TYPE_ID_HASHES_NAME,
+        VALUE_OPS_NAME,
+        STRINGS_NAME,
         FUNCTIONS_NAME,
         TYPES_NAME,
         TYPEDEFS_NAME,
         NAMESPACE_ALIASES_NAME,
         NAMESPACE_USINGS_NAME);
 
+    if (ctx.gc_sections) {
+        output += emit_type_entries(ctx);
+    }
+
     // add all emitted headers headers as #include-s at top of file
     std::string headers;
     // TODO: use emitted_headers
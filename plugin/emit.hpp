@@ -61,6 +61,25 @@ inline std::string emit_data(std::span<const uint8_t> buffer) {
     return out;
 }
 
+// emit string literal
+inline std::string emit_string(std::string_view str) {
+    std::string out = "\"";
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (std::isprint(static_cast<unsigned char>(c))) {
+            out += c;
+        } else {
+            out += fmt::format("\\x{:02x}\"\"", static_cast<uint8_t>(c));
+        }
+    }
+    return out + "\"";
+}
+
 // emit context as c++
 std::string emit(Context&);
+
+// emit header specializing archimedes::static_reflect for context types
+std::string emit_static_header(Context&);
 }
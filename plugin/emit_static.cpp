@@ -0,0 +1,229 @@
+#include "emit.hpp"
+#include "plugin.hpp"
+
+#include <clang/AST/RecordLayout.h>
+
+using namespace archimedes;
+using namespace archimedes::detail;
+
+// emitted specializations live in namespace archimedes, qualify names from the
+// global namespace so they cannot resolve to something in there instead
+static std::string global_name(std::string name) {
+    return name.starts_with("::") ? name : "::" + name;
+}
+
+// true if decl can be named from the emitted header, which only includes the
+// headers found for the main file (and the main file itself if it is a header)
+static bool is_includable(
+    const Context &ctx,
+    const clang::Decl &decl,
+    const fs::path &main_path) {
+    if (ctx.is_in_found_header(decl)) {
+        return true;
+    }
+
+    const auto path_opt = ctx.decl_file_path(decl);
+    return path_opt
+        && is_likely_header_path(main_path)
+        && fs::absolute(*path_opt) == main_path;
+}
+
+// true if member function can be referred to by &T::name
+static bool can_emit_function_ptr(const clang::CXXMethodDecl &md) {
+    if (md.isImplicit()
+            || md.isDeleted()
+            || md.getAccess() != clang::AS_public
+            || clang::isa<clang::CXXConstructorDecl>(md)
+            || clang::isa<clang::CXXDestructorDecl>(md)
+            || clang::isa<clang::CXXConversionDecl>(md)
+            || (!md.getDeclName().isIdentifier()
+                && md.getOverloadedOperator() == clang::OO_None)) {
+        return false;
+    }
+
+    // overloads (including templates) would need a cast to the exact type
+    const auto lookup = md.getParent()->lookup(md.getDeclName());
+    return std::distance(lookup.begin(), lookup.end()) == 1;
+}
+
+static std::string emit_static_record(
+    const Context &ctx,
+    const type_info &t,
+    const clang::CXXRecordDecl &rd) {
+    const auto name = global_name(get_full_type_name(ctx, *t.internal->type));
+    const auto &layout = ctx.ast_ctx->getASTRecordLayout(&rd);
+
+    vector<std::string> fields;
+    for (const auto *fd : rd.fields()) {
+        if (fd->isBitField()
+                || fd->isAnonymousStructOrUnion()
+                || fd->getName().empty()
+                || fd->getAccess() != clang::AS_public
+                || fd->getType()->isReferenceType()) {
+            continue;
+        }
+
+        fields.push_back(
+            fmt::format(
+                "archimedes::static_field({}, {}, &type::{})",
+                emit_string(fd->getName().str()),
+                ctx.ast_ctx->toCharUnitsFromBits(
+                    layout.getFieldOffset(fd->getFieldIndex()))
+                        .getQuantity(),
+                fd->getName().str()));
+    }
+
+    vector<std::string> bases;
+    for (const auto &b : rd.bases()) {
+        const auto *base_rd = b.getType()->getAsCXXRecordDecl();
+        if (!base_rd
+                || b.getAccessSpecifier() != clang::AS_public
+                || !can_emit_type(ctx, b.getType().getTypePtr())) {
+            continue;
+        }
+
+        bases.push_back(
+            fmt::format(
+                "archimedes::static_base<{}>({}, {})",
+                global_name(get_full_type_name(ctx, b.getType())),
+                b.isVirtual(),
+                b.isVirtual() ?
+                    0
+                    : layout.getBaseClassOffset(base_rd).getQuantity()));
+    }
+
+    vector<std::string> functions;
+    for (const auto *md : rd.methods()) {
+        if (!can_emit_function_ptr(*md)) {
+            continue;
+        }
+
+        const auto fn_name = md->getDeclName().getAsString();
+        functions.push_back(
+            fmt::format(
+                "archimedes::static_function({}, &type::{})",
+                emit_string(fn_name),
+                fn_name));
+    }
+
+    return fmt::format(R"(
+        template <>
+        struct archimedes::static_reflect<{0}> {{
+            using type = {0};
+            static constexpr std::string_view name = {1};
+            static constexpr auto id = archimedes::type_id::from({1});
+            static constexpr auto fields = std::make_tuple({2});
+            static constexpr auto bases = std::make_tuple({3});
+            static constexpr auto functions = std::make_tuple({4});
+        }};
+        )",
+        name,
+        emit_string(t.type_name),
+        fmt::join(fields, ",\n"),
+        fmt::join(bases, ",\n"),
+        fmt::join(functions, ",\n"));
+}
+
+static std::string emit_static_enum(
+    const Context &ctx,
+    const type_info &t,
+    const clang::EnumDecl &ed) {
+    const auto name = global_name(get_full_type_name(ctx, *t.internal->type));
+
+    vector<std::string> enumerators;
+    for (const auto *e : ed.enumerators()) {
+        enumerators.push_back(
+            fmt::format(
+                "{{ {}, type::{} }}",
+                emit_string(e->getNameAsString()),
+                e->getNameAsString()));
+    }
+
+    return fmt::format(R"(
+        template <>
+        struct archimedes::static_reflect<{0}> {{
+            using type = {0};
+            static constexpr std::string_view name = {1};
+            static constexpr auto id = archimedes::type_id::from({1});
+            static constexpr std::array<
+                archimedes::static_enumerator<type>, {2}> enumerators = {{{{
+                {3}
+            }}}};
+        }};
+        )",
+        name,
+        emit_string(t.type_name),
+        enumerators.size(),
+        fmt::join(enumerators, ",\n"));
+}
+
+std::string archimedes::emit_static_header(Context &ctx) {
+    const auto &sm = ctx.ast_ctx->getSourceManager();
+    const auto main_path =
+        fs::absolute(
+            fs::path(
+                std::string_view(
+                    sm.getFileEntryForID(sm.getMainFileID())
+                        ->tryGetRealPathName())));
+    const auto dir = fs::absolute(*ctx.static_header_path).parent_path();
+
+    std::string output =
+        fmt::format(R"(
+            // generated by archimedes, do not edit
+            #pragma once
+            #include "{}"
+        )",
+        fs::relative(
+            fs::absolute(ctx.header_path).parent_path()
+                / "archimedes"
+                / "static_reflect.hpp",
+            dir).string());
+
+    for (const auto &h : ctx.found_headers) {
+        output += fmt::format("#include \"{}\"\n", fs::relative(h, dir).string());
+    }
+
+    if (is_likely_header_path(main_path)) {
+        output +=
+            fmt::format(
+                "#include \"{}\"\n", fs::relative(main_path, dir).string());
+    }
+
+    // types can appear multiple times, emit each once
+    set<std::string_view> emitted;
+    for (const auto *t : ctx.types) {
+        if (!t->internal->decl
+                || !t->internal->is_resolved
+                || emitted.contains(t->type_name)
+                || !can_emit_type(ctx, t->internal->type)
+                || !is_includable(ctx, *t->internal->decl, main_path)) {
+            continue;
+        }
+
+        if (t->kind == STRUCT || t->kind == UNION) {
+            const auto *rd =
+                clang::dyn_cast<clang::CXXRecordDecl>(t->internal->decl);
+            if (!rd
+                    || !(rd = rd->getDefinition())
+                    || rd->isDependentContext()) {
+                continue;
+            }
+
+            output += emit_static_record(ctx, *t, *rd);
+        } else if (t->kind == ENUM) {
+            const auto *ed =
+                clang::dyn_cast<clang::EnumDecl>(t->internal->decl);
+            if (!ed || !(ed = ed->getDefinition())) {
+                continue;
+            }
+
+            output += emit_static_enum(ctx, *t, *ed);
+        } else {
+            continue;
+        }
+
+        emitted.emplace(t->type_name);
+    }
+
+    return output;
+}
@@ -176,10 +176,10 @@ static type_kind type_to_kind(const Context &ctx, const clang::Type &type) {
 }
 
 // retrieve all annotations (clang::annotate) for a declaration
-static vector<std::string> get_annotations(
+static vector<std::string_view> get_annotations(
     const Context &ctx,
     const clang::Decl &decl) {
-    vector<std::string> annos;
+    vector<std::string_view> annos;
 
     for (const auto *attr : decl.getAttrs()) {
         if (attr->getKind() != clang::attr::Annotate) {
@@ -196,7 +196,8 @@ static vector<std::string> get_annotations(
             "failure to parse annotation {}",
             s);
 
-        annos.push_back(s.substr(q_left + 1, q_right - q_left - 1));
+        annos.push_back(
+            ctx.intern(s.substr(q_left + 1, q_right - q_left - 1)));
     }
 
     return annos;
@@ -290,12 +291,13 @@ static function_type_info make_implicit_function_type_info(
         default: ASSERT(false);
     }
 
-    info.name = name;
+    info.name = ctx.intern(name);
     info.qualified_name =
-        fmt::format(
-            "{}::{}",
-            parent.record.qualified_name,
-            name);
+        ctx.intern(
+            fmt::format(
+                "{}::{}",
+                parent.record.qualified_name,
+                name));
 
     info.definition_path = parent.definition_path;
     info.is_member = true;
@@ -373,9 +375,10 @@ static function_type_info make_function_type_info(
             ctx,
             *decl->getType(),
             decl).id;
-    info.qualified_name = decl->getQualifiedNameAsString();
-    info.name = decl->getNameAsString();
-    info.definition_path = location_to_string(ctx, decl->getLocation());
+    info.qualified_name = ctx.intern(decl->getQualifiedNameAsString());
+    info.name = ctx.intern(decl->getNameAsString());
+    info.definition_path =
+        ctx.intern(location_to_string(ctx, decl->getLocation()));
 
     if (const auto *md =
             clang::dyn_cast_or_null<clang::CXXMethodDecl>(decl)) {
@@ -425,7 +428,7 @@ static function_type_info make_function_type_info(
                 : name;
         info.parameters.emplace_back(
             function_parameter_info {
-                .name = name,
+                .name = ctx.intern(name),
                 .index = i,
                 .is_defaulted = p->hasDefaultArg()
             });
@@ -673,7 +676,7 @@ static void populate_record(
         for (size_t i = 0; i < args.size(); i++) {
             const auto &ta = args[i];
             llvm::APSInt int_value;
-            tpi.name = params.getParam(i)->getNameAsString();
+            tpi.name = ctx.intern(params.getParam(i)->getNameAsString());
             switch (ta.getKind()) {
                 case clang::TemplateArgument::ArgKind::Type:
                     tpi.type =
@@ -725,7 +728,7 @@ static void populate_record(
         }
     }
 
-    info.record.qualified_name = get_full_type_name(ctx, type);
+    info.record.qualified_name = ctx.intern(get_full_type_name(ctx, type));
 
     const auto &layout = ctx.ast_ctx->getASTRecordLayout(rd);
     info.record.size = layout.getSize().getQuantity();
@@ -775,6 +778,15 @@ static void populate_record(
     // generate implicit function decls
     const auto add_implicit =
         [&](ImplicitFunction if_kind) {
+            // default ctor, copy ctor, and dtor are always required by the
+            // runtime (see any::make_for_id)
+            if (!(ctx.included_metadata & METADATA_IMPLICIT_FUNCTIONS)
+                && (if_kind == ImplicitFunction::MOVE_CTOR
+                    || if_kind == ImplicitFunction::COPY_ASSIGN
+                    || if_kind == ImplicitFunction::MOVE_ASSIGN)) {
+                return;
+            }
+
             // TODO: add implicits??
             const auto type =
                 make_implicit_function_type(
@@ -928,7 +940,7 @@ static void populate_record(
                 ctx,
                 field->getType(),
                 nullptr);
-        fti.name = field->getNameAsString();
+        fti.name = ctx.intern(field->getNameAsString());
         fti.access = from_clang_access_specifier(field->getAccess());
         fti.is_mutable = field->isMutable();
         fti.is_bit_field = field->isBitField();
@@ -938,6 +950,9 @@ static void populate_record(
             field->isBitField() ?
                 layout.getFieldOffset(field->getFieldIndex())
                 : 0;
+        fti.is_signed_bit_field =
+            field->isBitField()
+                && field->getType()->isSignedIntegerOrEnumerationType();
         fti.annotations = get_annotations(ctx, *field);
         fti.size =
             ctx.ast_ctx->getTypeSizeInChars(field->getType())
@@ -968,7 +983,7 @@ static void populate_record(
                 ctx,
                 vd->getType(),
                 vd);
-        sfti.name = vd->getNameAsString();
+        sfti.name = ctx.intern(vd->getNameAsString());
         sfti.access = from_clang_access_specifier(vd->getAccess());
         sfti.is_constexpr = vd->isConstexpr();
         sfti.annotations = get_annotations(ctx, *vd);
@@ -1014,7 +1029,7 @@ static void populate_record(
     for (const auto *decl : rd->decls()) {
         if (const auto *td = clang::dyn_cast<clang::TypedefNameDecl>(decl)) {
             td = td->getCanonicalDecl();
-            const auto name = td->getQualifiedNameAsString();
+            const auto name = ctx.intern(td->getQualifiedNameAsString());
             info.record.typedefs.emplace(
                 name,
                 typedef_info {
@@ -1103,19 +1118,32 @@ static void populate_enum(
     info.enum_.base_type =
         get_or_make_qualified_info(ctx, ed->getIntegerType(), nullptr);
 
+    vector<enum_tables::entry> entries;
     for (const auto &e : ed->enumerators()) {
-        const auto name = e->getNameAsString();
+        const auto name = ctx.intern(e->getNameAsString());
         const decltype(info.enum_.name_to_value)::mapped_type value =
             e->getInitVal().getLimitedValue(
                 std::numeric_limits<std::uintmax_t>::max());
         info.enum_.name_to_value[name] = value;
+        entries.push_back({ name, value });
 
         auto it = info.enum_.value_to_name.find(value);
         (it == info.enum_.value_to_name.end() ?
             info.enum_.value_to_name.emplace(
-                value, vector<std::string>()).first
+                value, vector<std::string_view>()).first
             : it)->second.push_back(name);
     }
+
+    // init values are zero extended from the width of the integer type
+    const auto integer_type = ed->getIntegerType();
+    const auto width = ctx.ast_ctx->getIntWidth(integer_type);
+    info.enum_.tables =
+        enum_tables::build(
+            entries,
+            width >= std::numeric_limits<std::uintmax_t>::digits ?
+                std::numeric_limits<std::uintmax_t>::max()
+                : (std::uintmax_t(1) << width) - 1,
+            integer_type->isSignedIntegerOrEnumerationType());
 }
 
 qualified_type_info get_or_make_qualified_info(
@@ -1161,6 +1189,10 @@ void try_populate(
     type_info &info,
     const clang::Type &type,
     const clang::Decl *decl) {
+    StatsScope scope(
+        ctx.stats,
+        PHASE_POPULATE,
+        llvm::timeTraceProfilerEnabled() ? info.type_name : "");
     info.kind = type_to_kind(ctx, type);
 
     if (info.kind == UNKNOWN) {
@@ -1224,7 +1256,8 @@ void try_populate(
     // from there
     if (decl && have_definition
         && (info.kind == ENUM || info.kind == STRUCT || info.kind == UNION)) {
-        info.definition_path = location_to_string(ctx, decl->getLocation());
+        info.definition_path =
+            ctx.intern(location_to_string(ctx, decl->getLocation()));
         info.annotations = get_annotations(ctx, *decl);
     }
 
@@ -1285,6 +1318,38 @@ type_info &make_unknown(
     return info;
 }
 
+// append stats for the current TU to ctx.stats_path as one JSON line
+static void write_stats(Context &ctx, clang::ASTContext &ast_ctx) {
+    auto &stats = ctx.stats;
+    stats.types = ctx.types.size();
+    stats.invokers = ctx.invokers.size();
+    stats.headers = ctx.found_headers.size();
+
+    stats.functions = 0;
+    for (const auto &[_, fos] : ctx.functions) {
+        stats.functions += fos.functions.size();
+    }
+
+    for (const auto *t : ctx.types) {
+        for (const auto &[_, fos] : t->record.functions) {
+            stats.functions += fos.functions.size();
+        }
+    }
+
+    const auto &sm = ast_ctx.getSourceManager();
+    const auto *main_file = sm.getFileEntryForID(sm.getMainFileID());
+    const auto tu =
+        main_file ? std::string(main_file->tryGetRealPathName()) : "";
+
+    std::ofstream out(*ctx.stats_path, std::ios::app);
+    if (!out) {
+        LOG("could not open stats file {}", ctx.stats_path->string());
+        return;
+    }
+
+    out << stats.to_json(tu) << "\n";
+}
+
 // ASTConsumer for clang frontend plugin
 struct ArchimedesASTConsumer
     : public clang::ASTConsumer {
@@ -1365,7 +1430,7 @@ struct ArchimedesASTConsumer
                 td = td->getCanonicalDecl();
                 ctx.typedefs.emplace_back(
                     typedef_info {
-                        .name = td->getQualifiedNameAsString(),
+                        .name = ctx.intern(td->getQualifiedNameAsString()),
                         .aliased_type =
                             get_or_make_qualified_info(
                                 ctx,
@@ -1379,9 +1444,11 @@ struct ArchimedesASTConsumer
                 ctx.namespace_aliases.emplace_back(
                     namespace_alias_info {
                         .name =
-                            nd->getQualifiedNameAsString(),
+                            ctx.intern(nd->getQualifiedNameAsString()),
                         .aliased =
-                            nd->getNamespace()->getQualifiedNameAsString()
+                            ctx.intern(
+                                nd->getNamespace()
+                                    ->getQualifiedNameAsString())
                     });
             } else if (
                 const auto *ud =
@@ -1391,12 +1458,14 @@ struct ArchimedesASTConsumer
                 ctx.namespace_usings.emplace_back(
                     namespace_using_info {
                         .containing =
-                            clang::dyn_cast<clang::NamespaceDecl>(
-                                ud->getDeclContext())
-                                    ->getQualifiedNameAsString(),
+                            ctx.intern(
+                                clang::dyn_cast<clang::NamespaceDecl>(
+                                    ud->getDeclContext())
+                                        ->getQualifiedNameAsString()),
                         .used =
-                            ud->getNominatedNamespace()
-                                ->getQualifiedNameAsString()
+                            ctx.intern(
+                                ud->getNominatedNamespace()
+                                    ->getQualifiedNameAsString())
                     });
             } else if (
                 const auto *td =
@@ -1519,6 +1588,16 @@ struct ArchimedesASTConsumer
             return;
         }
 
+        this->ArchimedesHandleTranslationUnit(ast_ctx);
+
+        if (ctx.stats_path) {
+            write_stats(ctx, ast_ctx);
+        }
+    }
+
+    void ArchimedesHandleTranslationUnit(clang::ASTContext &ast_ctx) {
+        auto &ctx = Context::instance();
+
         PLUGIN_LOG("start for TU");
 
         // nothign to reflect if there are no decls
@@ -1585,14 +1664,14 @@ struct ArchimedesASTConsumer
                        *clang::dyn_cast<clang::ClassTemplateSpecializationDecl>(
                            qt->getAsStructureType()->getDecl())
                             ->getTemplateArgs()[0].getAsType();
-                   const auto rx =
-                        escape_for_regex(
-                            get_full_type_name(ctx, arg_type));
+                   const auto kept_name = get_full_type_name(ctx, arg_type);
+                   const auto rx = escape_for_regex(kept_name);
                   PLUGIN_LOG(
                        "got explicit enable via ARCHIMEDES_REFLECT_TYPE {}",
                        rx);
-                   ctx.explicit_enabled_types.push_back(
+                   ctx.add_explicit_enabled_type(
                        std::regex("^" + rx + "$"));
+                   ctx.kept_type_names.push_back(kept_name);
                 }
             }
         }
@@ -1601,7 +1680,10 @@ struct ArchimedesASTConsumer
             return;
         }
 
-        visitor.TraverseDecl(tu_decl);
+        {
+            StatsScope scope(ctx.stats, PHASE_TRAVERSE);
+            visitor.TraverseDecl(tu_decl);
+        }
 
         // exit early if nothing will be emitted
         if (ctx.functions.empty()
@@ -1613,7 +1695,23 @@ struct ArchimedesASTConsumer
             return;
         }
 
-        const auto emitted = emit(ctx);
+        if (ctx.static_header_path) {
+            StatsScope scope(ctx.stats, PHASE_EMIT);
+            std::ofstream out(*ctx.static_header_path);
+            out << emit_static_header(ctx);
+        }
+
+        // only the static header was requested
+        if (ctx.output_path.empty()) {
+            return;
+        }
+
+        const auto emitted =
+            [&]() {
+                StatsScope scope(ctx.stats, PHASE_EMIT);
+                return emit(ctx);
+            }();
+        ctx.stats.emitted_bytes = emitted.size();
 
         if (ctx.emit_source) {
             // write directly to output path
@@ -1733,13 +1831,20 @@ struct ArchimedesASTConsumer
             llvm::raw_string_ostream os(errs);
 
             // TODO: more robust error handling
-            ASSERT(
-                compile(
-                    args,
-                    ctx.output_path,
-                    emitted,
-                    os),
-                "ARCHIMEDES FAILED TO COMPILE:\n{}", errs);
+            {
+                StatsScope scope(ctx.stats, PHASE_COMPILE);
+                ASSERT(
+                    compile(
+                        args,
+                        ctx.output_path,
+                        emitted,
+                        os),
+                    "ARCHIMEDES FAILED TO COMPILE:\n{}", errs);
+            }
+
+            std::error_code ec;
+            const auto size = fs::file_size(ctx.output_path, ec);
+            ctx.stats.object_bytes = ec ? 0 : size;
         }
     }
 };
@@ -1778,7 +1883,7 @@ struct ArchimedesASTAction
             }
         }
 
-        if (ctx.output_path.empty()) {
+        if (ctx.output_path.empty() && !ctx.static_header_path) {
             const auto no_output_path_id =
                 diagnostics_engine.getCustomDiagID(
                     clang::DiagnosticsEngine::Error,
@@ -1848,7 +1953,7 @@ public:
             }
             const auto rx = quoted.substr(1, quoted.length() - 2);
             PLUGIN_LOG("adding explicit enable for {}", rx);
-            ctx.explicit_enabled_types.emplace_back(
+            ctx.add_explicit_enabled_type(
                 std::regex("^" + rx + "$"));
         } else {
             const auto unrecognized_pragma_id =
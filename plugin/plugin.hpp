@@ -13,11 +13,16 @@
 #include <clang/Sema/Sema.h>
 #include <clang/Basic/FileEntry.h>
 #include <clang/Frontend/CompilerInstance.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/Support/Allocator.h>
+#include <llvm/Support/StringSaver.h>
 
 #include "ext/ast.hpp"
 
 #include <archimedes.hpp>
 
+#include "arena.hpp"
+#include "stats.hpp"
 #include "invoker.hpp"
 #include "util.hpp"
 
@@ -446,6 +451,10 @@ struct Context {
     // regexes of explicitly included types
     vector<std::regex> explicit_enabled_types;
 
+    // names of types kept via ARCHIMEDES_REFLECT_TYPE, roots for
+    // "gc-sections" mode
+    vector<std::string> kept_type_names;
+
     // output path (should be .cpp if emit_source otherwise .o)
     fs::path output_path;
 
@@ -470,8 +479,12 @@ struct Context {
     // compiler instance
     clang::CompilerInstance *compiler;
 
+    // storage for types and objects from alloc(), lifetimes are tied to
+    // context. must be declared before anything pointing into it.
+    Arena arena;
+
     // list of registered types
-    vector<std::unique_ptr<type_info>> types;
+    vector<type_info*> types;
 
     // invokers to be generated
     vector<Invoker*> invokers;
@@ -512,19 +525,28 @@ struct Context {
     // marked with ARCHIMEDES_REFLECT will be reflected
     bool explicit_enable = false;
 
-    // TODO: allocate in large block of memory
-    // list of allocated objects (lifetimes are tied to context)
-    struct alloc_container { virtual ~alloc_container() = default; };
-    vector<std::unique_ptr<alloc_container>> allocations;
+    // optional metadata to emit, see "level-..." arguments
+    metadata included_metadata = METADATA_LEVEL_FULL;
+
+    // if present, per-TU timings/counters are appended to this file as JSON
+    // lines, see Stats
+    std::optional<fs::path> stats_path;
+    mutable Stats stats;
+
+    // if present, a header specializing archimedes::static_reflect<T> for
+    // all reflected types which can be named from a header is written here.
+    // if there is no output path, only this header is emitted.
+    std::optional<fs::path> static_header_path;
+
+    // if true, emit each type into its own section referencing the types it
+    // depends on such that the linker can discard reflection data for types
+    // which are not reachable from explicitly reflected types
+    bool gc_sections = false;
 
     // allocate a T with lifetime attached to this context
     template <typename T>
     T &alloc() {
-        struct alloc_container_t : alloc_container { T t; };
-        auto &t =
-            dynamic_cast<alloc_container_t&>(
-                *this->allocations.emplace_back(
-                    std::make_unique<alloc_container_t>())).t;
+        auto &t = this->arena.make<T>();
         PLUGIN_LOG(
             "allocated type {} at ptr {}",
             type_name<T>(),
@@ -532,6 +554,41 @@ struct Context {
         return t;
     }
 
+    // storage for interned strings, every string_view in emitted type info
+    // points into here so equal strings share one entry in the string table
+    mutable llvm::BumpPtrAllocator string_allocator;
+    mutable llvm::UniqueStringSaver string_saver =
+        llvm::UniqueStringSaver(string_allocator);
+
+    // intern string, returned view lives as long as this context
+    std::string_view intern(std::string_view s) const {
+        const auto r =
+            this->string_saver.save(llvm::StringRef(s.data(), s.size()));
+        return std::string_view(r.data(), r.size());
+    }
+
+    // memoized filter decisions, see should_ignore_decl_by_path,
+    // should_ignore_decl_by_namespace, is_explicitly_enabled
+    // nullopt for namespaces means the decision depends on the decl's name and
+    // cannot be cached per context
+    mutable llvm::DenseMap<clang::FileID, bool> path_ignore_cache;
+    mutable llvm::DenseMap<const clang::DeclContext*, std::optional<bool>>
+        namespace_ignore_cache;
+    mutable llvm::DenseMap<const clang::Decl*, bool> explicit_enable_cache;
+
+    // must be called whenever filters (namespaces, regexes) change
+    void invalidate_filter_caches() {
+        this->path_ignore_cache.clear();
+        this->namespace_ignore_cache.clear();
+        this->explicit_enable_cache.clear();
+    }
+
+    // add regex to explicit_enabled_types
+    void add_explicit_enabled_type(std::regex &&rx) {
+        this->explicit_enabled_types.emplace_back(std::move(rx));
+        this->explicit_enable_cache.clear();
+    }
+
     // process argument, either from command line OR from ARCHIMEDES_ARG
     // return non-nullopt on error
     // expects arguments in string format "<name>-<value>"
@@ -542,6 +599,9 @@ struct Context {
 
         PLUGIN_LOG("got argument {}", arg);
 
+        // any argument can change filters
+        this->invalidate_filter_caches();
+
         const auto try_make_regex =
             [](std::string_view str) {
                 try {
@@ -566,6 +626,13 @@ struct Context {
         } else if (arg.starts_with("out-")) {
             this->output_path =
                 arg.substr(std::strlen("out-"), std::string::npos);
+        } else if (arg.starts_with("emit-static-header-")) {
+            this->static_header_path =
+                arg.substr(
+                    std::strlen("emit-static-header-"), std::string::npos);
+        } else if (arg.starts_with("stats-")) {
+            this->stats_path =
+                arg.substr(std::strlen("stats-"), std::string::npos);
         } else if (arg.starts_with("header-")) {
             this->header_path =
                 arg.substr(std::strlen("header-"), std::string::npos);
@@ -639,6 +706,14 @@ struct Context {
             this->emit_verbose = true;
         } else if (arg == "emit-source") {
             this->emit_source = true;
+        } else if (arg == "level-minimal") {
+            this->included_metadata = METADATA_LEVEL_MINIMAL;
+        } else if (arg == "level-runtime") {
+            this->included_metadata = METADATA_LEVEL_RUNTIME;
+        } else if (arg == "level-full") {
+            this->included_metadata = METADATA_LEVEL_FULL;
+        } else if (arg == "gc-sections") {
+            this->gc_sections = true;
         } else if (arg == "explicit-enable") {
             this->explicit_enable = true;
 
@@ -759,7 +834,8 @@ struct Context {
     }
 
     // TODO: merge with above function
-    bool should_ignore_by_path(std::string_view path) const {
+    bool should_ignore_by_path(std::string_view path_view) const {
+        const auto path = std::string(path_view);
         bool
             has_included = !this->included_path_regexes.empty(),
             in_included =
@@ -767,7 +843,7 @@ struct Context {
                     this->included_path_regexes.begin(),
                     this->included_path_regexes.end(),
                     [&path](const auto &rx) {
-                        return std::regex_match(std::string(path), rx);
+                        return std::regex_match(path, rx);
                     }),
             has_excluded = !this->excluded_path_regexes.empty(),
             in_excluded =
@@ -775,7 +851,7 @@ struct Context {
                     this->excluded_path_regexes.begin(),
                     this->excluded_path_regexes.end(),
                     [&path](const auto &rx) {
-                        return std::regex_match(std::string(path), rx);
+                        return std::regex_match(path, rx);
                     });
 
         // ignore if included OR excluded and not explicitly included
@@ -783,6 +859,73 @@ struct Context {
             || (has_excluded && in_excluded && !in_included);
     }
 
+    // should_ignore_by_path for the file containing decl, cached per FileID
+    bool should_ignore_decl_by_path(
+        const clang::Decl &decl,
+        const fs::path &path) const {
+        const auto &sm = decl.getASTContext().getSourceManager();
+        const auto file_id = sm.getFileID(sm.getFileLoc(decl.getLocation()));
+        if (file_id.isInvalid()) {
+            return this->should_ignore_by_path(path.string());
+        }
+
+        const auto it = this->path_ignore_cache.find(file_id);
+        if (it != this->path_ignore_cache.end()) {
+            return it->second;
+        }
+
+        const auto res = this->should_ignore_by_path(path.string());
+        this->path_ignore_cache[file_id] = res;
+        return res;
+    }
+
+    // should_ignore_by_namespace for decl, cached per enclosing namespace
+    // where possible
+    bool should_ignore_decl_by_namespace(const clang::NamedDecl &nd) const {
+        const auto *ns =
+            clang::dyn_cast<clang::NamespaceDecl>(
+                nd.getDeclContext()->getEnclosingNamespaceContext());
+        if (!ns || ns->isAnonymousNamespace()) {
+            return this->should_ignore_by_namespace(
+                nd.getQualifiedNameAsString());
+        }
+
+        const auto it = this->namespace_ignore_cache.find(ns);
+        if (it != this->namespace_ignore_cache.end() && it->second) {
+            return *it->second;
+        }
+
+        const auto name = nd.getQualifiedNameAsString();
+        const auto res = this->should_ignore_by_namespace(name);
+        if (it != this->namespace_ignore_cache.end()) {
+            return res;
+        }
+
+        // the decision only depends on the namespace if every included/
+        // excluded namespace is either a prefix of "<ns>::" or cannot match
+        // anything inside of it at all
+        const auto prefix = ns->getQualifiedNameAsString() + "::";
+        const auto depends_on_name =
+            [&](const std::string &n) {
+                return n.length() > prefix.length() && n.starts_with(prefix);
+            };
+
+        const bool cacheable =
+            name.starts_with(prefix)
+                && std::none_of(
+                    this->included_namespaces.begin(),
+                    this->included_namespaces.end(),
+                    depends_on_name)
+                && std::none_of(
+                    this->excluded_namespaces.begin(),
+                    this->excluded_namespaces.end(),
+                    depends_on_name);
+
+        this->namespace_ignore_cache[ns] =
+            cacheable ? std::make_optional(res) : std::nullopt;
+        return res;
+    }
+
     // returns true if this declaration or any of its contexts are annotated
     // with "a"
     bool annotation_in_hierarchy(
@@ -815,6 +958,17 @@ struct Context {
     // checks if a decl (and NOT its hierarchy) has been explicitly enabled for
     // reflection
     bool is_explicitly_enabled(const clang::Decl *decl) const {
+        const auto it = this->explicit_enable_cache.find(decl);
+        if (it != this->explicit_enable_cache.end()) {
+            return it->second;
+        }
+
+        const auto res = this->is_explicitly_enabled_uncached(decl);
+        this->explicit_enable_cache[decl] = res;
+        return res;
+    }
+
+    bool is_explicitly_enabled_uncached(const clang::Decl *decl) const {
         const auto *def = try_get_decl_definition(*decl);
         const auto name = decl_name(*this, decl);
         const auto def_name =
@@ -964,7 +1118,7 @@ struct Context {
         }
 
         // explicit enable must check decls in all files, check path after
-        if (should_ignore_by_path((*path_opt).string())) {
+        if (this->should_ignore_decl_by_path(*decl_or_def, *path_opt)) {
             PLUGIN_LOG(
                 "{} ignored by path ({})",
                 decl_name(*this, decl_or_def),
@@ -982,7 +1136,7 @@ struct Context {
         /* } */
 
         // if excluded OR there are included namespaces and it is not included
-        if (this->should_ignore_by_namespace(nd->getQualifiedNameAsString())) {
+        if (this->should_ignore_decl_by_namespace(*nd)) {
             PLUGIN_LOG(
                 "{} ignored by namespace",
                 decl_name(*this, decl_or_def));
@@ -1032,7 +1186,7 @@ struct Context {
             // use canonical types as we can compare by pointer
             if (&canonical_type(type) ==
                     &canonical_type(*t->internal->type)) {
-                return t.get();
+                return t;
             }
         }
         return std::nullopt;
@@ -1049,15 +1203,16 @@ struct Context {
     // create new type info for type
     type_info &new_info(const clang::Type &type, const clang::Decl *decl) {
         type_info &info =
-            *this->types.emplace_back(std::make_unique<type_info>());
+            *this->types.emplace_back(&this->alloc<type_info>());
         info.id = type_id::from(this->types.size() - 1);
-        info.type_name = get_full_type_name(*this, type);
+        info.type_name = this->intern(get_full_type_name(*this, type));
         info.mangled_type_name =
-            f_ostream_to_string(
-                [&](auto &os) {
-                    this->mangle_ctx->mangleCXXRTTIName(
-                        clang::QualType(&type, 0), os);
-                });
+            this->intern(
+                f_ostream_to_string(
+                    [&](auto &os) {
+                        this->mangle_ctx->mangleCXXRTTIName(
+                            clang::QualType(&type, 0), os);
+                    }));
         info.internal = &this->alloc<archimedes::detail::internal>();
         info.internal->type = &type;
         info.internal->decl = decl;
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#define FMT_HEADER_ONLY
+#include <fmt/core.h>
+
+#include <llvm/Support/TimeProfiler.h>
+
+namespace archimedes {
+// plugin phases which are timed, see Stats
+enum StatsPhase {
+    PHASE_TRAVERSE,
+    PHASE_POPULATE,
+    PHASE_INVOKERS,
+    PHASE_EMIT,
+    PHASE_SERIALIZE,
+    PHASE_COMPILE,
+    PHASE_COUNT
+};
+
+inline constexpr std::array<std::string_view, PHASE_COUNT> PHASE_NAMES = {
+    "traverse",
+    "populate",
+    "invokers",
+    "emit",
+    "serialize",
+    "compile"
+};
+
+// names used for -ftime-trace events
+inline constexpr std::array<std::string_view, PHASE_COUNT> PHASE_TRACE_NAMES = {
+    "archimedes traverse",
+    "archimedes populate",
+    "archimedes invokers",
+    "archimedes emit",
+    "archimedes serialize",
+    "archimedes compile"
+};
+
+// s as the contents of a JSON string
+inline std::string escape_json(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (const char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+// per-TU timings and counters, written as a JSON line with "stats-<path>"
+// NOTE: times are inclusive, fx. "traverse" includes "populate" and "emit"
+// includes "invokers" and "serialize"
+struct Stats {
+    std::array<std::chrono::nanoseconds, PHASE_COUNT> times = {};
+
+    // number of active scopes per phase, only outermost scopes are timed so
+    // that recursive phases (populate) are not counted twice
+    std::array<size_t, PHASE_COUNT> depth = {};
+
+    size_t
+        types = 0,
+        functions = 0,
+        invokers = 0,
+        headers = 0,
+        emitted_bytes = 0,
+        serialized_bytes = 0,
+        object_bytes = 0;
+
+    std::string to_json(std::string_view tu) const {
+        std::string phases;
+        for (size_t i = 0; i < PHASE_COUNT; i++) {
+            phases +=
+                fmt::format(
+                    "{}\"{}_ms\": {:.3f}",
+                    i == 0 ? "" : ", ",
+                    PHASE_NAMES[i],
+                    std::chrono::duration<double, std::milli>(
+                        this->times[i]).count());
+        }
+
+        return fmt::format(
+            "{{\"tu\": \"{}\", {}, \"types\": {}, \"functions\": {}, "
+            "\"invokers\": {}, \"headers\": {}, \"emitted_bytes\": {}, "
+            "\"serialized_bytes\": {}, \"object_bytes\": {}}}",
+            escape_json(tu),
+            phases,
+            this->types,
+            this->functions,
+            this->invokers,
+            this->headers,
+            this->emitted_bytes,
+            this->serialized_bytes,
+            this->object_bytes);
+    }
+};
+
+// times a phase for its lifetime, also shows up in -ftime-trace output
+struct StatsScope {
+    StatsScope(Stats &stats, StatsPhase phase, std::string_view detail = "")
+        : stats(stats),
+          phase(phase),
+          trace(
+              llvm::StringRef(
+                  PHASE_TRACE_NAMES[phase].data(),
+                  PHASE_TRACE_NAMES[phase].size()),
+              llvm::StringRef(detail.data(), detail.size())),
+          outermost(stats.depth[phase]++ == 0),
+          start(std::chrono::steady_clock::now()) {}
+
+    ~StatsScope() {
+        this->stats.depth[this->phase]--;
+        if (this->outermost) {
+            this->stats.times[this->phase] +=
+                std::chrono::steady_clock::now() - this->start;
+        }
+    }
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope &operator=(const StatsScope&) = delete;
+
+private:
+    Stats &stats;
+    StatsPhase phase;
+    llvm::TimeTraceScope trace;
+    bool outermost;
+    std::chrono::steady_clock::time_point start;
+};
+}
@@ -0,0 +1,97 @@
+#include "test.hpp"
+#include "any_vector.test.hpp"
+
+using namespace any_vector_ns;
+
+static std::string names(archimedes::any_vector &v) {
+    std::string s;
+    for (const auto &n : v.as<Named>()) {
+        s += n.name;
+    }
+    return s;
+}
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    {
+        archimedes::any_vector v { *archimedes::reflect<Named>() };
+        ASSERT(v.is<Named>());
+        ASSERT(v.empty());
+
+        for (const auto *s : { "a", "b", "c", "d", "e" }) {
+            v.emplace_back<Named>(s);
+        }
+        ASSERT(v.size() == 5);
+        ASSERT(num_alive == 5);
+        ASSERT(names(v) == "abcde");
+
+        // untyped default construct/copy
+        ASSERT(static_cast<Named*>(v.emplace_back())->name == "default");
+        v.push_back(v[0]);
+        ASSERT(names(v) == "abcdedefaulta");
+        ASSERT(num_alive == 7);
+
+        v.erase(1, 3);
+        ASSERT(names(v) == "adedefaulta");
+        ASSERT(num_alive == 5);
+
+        v.swap_erase(0);
+        ASSERT(names(v) == "adedefault");
+
+        v.pop_back();
+        ASSERT(names(v) == "ade");
+        ASSERT(num_alive == 3);
+
+        auto copy = v;
+        ASSERT(names(copy) == "ade");
+        ASSERT(num_alive == 6);
+
+        auto moved = std::move(copy);
+        ASSERT(copy.empty());
+        ASSERT(names(moved) == "ade");
+        ASSERT(num_alive == 6);
+
+        moved.resize(5);
+        ASSERT(names(moved) == "adedefaultdefault");
+        moved.resize(1);
+        moved.shrink_to_fit();
+        ASSERT(moved.capacity() == 1);
+        ASSERT(num_alive == 4);
+
+        v.clear();
+        ASSERT(num_alive == 1);
+    }
+    ASSERT(num_alive == 0);
+
+    // trivially copyable elements are relocated with memcpy
+    {
+        const auto vec3 = *archimedes::reflect<Vec3>();
+        ASSERT(vec3.ops()->is_trivial);
+
+        archimedes::any_vector v { vec3 };
+        ASSERT(v.stride() == sizeof(Vec3));
+        for (int i = 0; i < 100; i++) {
+            v.emplace_back<Vec3>(Vec3 { float(i), 0.0f, 0.0f });
+        }
+
+        v.erase(0, 50);
+        ASSERT(v.size() == 50);
+        ASSERT(v.as<Vec3>()[0].x == 50.0f);
+        ASSERT(static_cast<const Vec3*>(v.at(49))->x == 99.0f);
+        ASSERT(!v.at(50));
+    }
+
+    // numeric types have no ops, but are trivial and zero initialized
+    {
+        archimedes::any_vector v { *archimedes::reflect<float>() };
+        v.resize(3);
+        v.as<float>()[1] = 2.0f;
+        v.push_back(v[1]);
+        ASSERT(v.size() == 4);
+        ASSERT(v.as<float>()[0] == 0.0f);
+        ASSERT(v.as<float>()[3] == 2.0f);
+    }
+
+    return 0;
+}
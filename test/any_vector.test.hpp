@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+namespace any_vector_ns {
+inline int num_alive = 0;
+
+struct Named {
+    Named() { num_alive++; }
+    explicit Named(std::string name) : name(std::move(name)) { num_alive++; }
+    Named(const Named &other) : name(other.name) { num_alive++; }
+    Named(Named &&other) : name(std::move(other.name)) { num_alive++; }
+    Named &operator=(const Named&) = default;
+    Named &operator=(Named&&) = default;
+    ~Named() { num_alive--; }
+
+    std::string name = "default";
+};
+
+struct Vec3 {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+} // namespace any_vector_ns
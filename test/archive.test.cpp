@@ -0,0 +1,101 @@
+#include "test.hpp"
+#include "archive.test.hpp"
+
+#include <cstdio>
+#include <vector>
+
+using namespace archive_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    ASSERT(archimedes::layout_hash(archimedes::type_id::from<Asset>()));
+    ASSERT(
+        archimedes::layout_hash(archimedes::type_id::from<Asset>())
+            != archimedes::layout_hash(archimedes::type_id::from<Keyframe>()));
+    ASSERT(
+        archimedes::layout_hash(archimedes::type_id::from<Keyframe>())
+            != archimedes::layout_hash(
+                archimedes::type_id::from<Reordered>()));
+
+    std::vector<Asset> assets;
+    for (uint32_t i = 0; i < 100; i++) {
+        auto &a = assets.emplace_back();
+        a.id = i;
+        a.keys[1] = { float(i), 1.0f };
+        a.kind = i % 8;
+        a.flags = i % 32;
+    }
+
+    const std::vector<Keyframe> keys = { { 1.0f, 2.0f } };
+
+    archimedes::archive_writer writer;
+    ASSERT(!writer.add<Asset>("assets", assets));
+    ASSERT(!writer.add<Keyframe>("keys", keys));
+    ASSERT(
+        writer.add<Keyframe>("keys", keys)
+            == archimedes::archive_error::DUPLICATE_SECTION);
+
+    // types which cannot be used in place
+    const NotTrivial not_trivial;
+    const HasPointer has_pointer;
+    ASSERT(
+        writer.add<NotTrivial>("x", std::span(&not_trivial, 1))
+            == archimedes::archive_error::UNSUPPORTED_TYPE);
+    ASSERT(
+        writer.add<HasPointer>("x", std::span(&has_pointer, 1))
+            == archimedes::archive_error::UNSUPPORTED_TYPE);
+
+    const std::string path = "archive.test.arc";
+    ASSERT(!writer.write(path));
+
+    {
+        auto opened = archimedes::archive::open(path);
+        ASSERT(opened);
+
+        auto archive = std::move(*opened);
+        ASSERT(archive.sections().size() == 2);
+
+        const auto as = archive.get<Asset>("assets");
+        ASSERT(as);
+        ASSERT(as->size() == 100);
+        ASSERT((*as)[42].id == 42);
+        ASSERT((*as)[42].keys[1].time == 42.0f);
+        ASSERT((*as)[42].kind == 42 % 8);
+        ASSERT((*as)[42].flags == 42 % 32);
+
+        ASSERT(archive.get<Keyframe>("keys")->front().value == 2.0f);
+        ASSERT(
+            archive.get<Reordered>("keys").unwrap_error()
+                == archimedes::archive_error::WRONG_TYPE);
+        ASSERT(
+            archive.get<Keyframe>("assets").unwrap_error()
+                == archimedes::archive_error::WRONG_TYPE);
+        ASSERT(
+            archive.get<Keyframe>("missing").unwrap_error()
+                == archimedes::archive_error::NOT_FOUND);
+    }
+
+    std::remove(path.c_str());
+
+    // in memory, with a corrupted layout hash
+    alignas(64) static uint8_t buf[1 << 14];
+    const auto n = writer.write(buf);
+    ASSERT(n);
+    ASSERT(*n == writer.size());
+    ASSERT(archimedes::archive::view(std::span<const uint8_t>(buf, *n)));
+
+    // header is u32 magic, u32 version, u64 size, u64 section count, then
+    // sections start with u64 type id, u64 layout hash
+    buf[32] ^= 0xFF;
+    ASSERT(
+        archimedes::archive::view(
+            std::span<const uint8_t>(buf, *n)).unwrap_error()
+            == archimedes::archive_error::LAYOUT_MISMATCH);
+    ASSERT(
+        archimedes::archive::view(
+            std::span<const uint8_t>(buf, *n - 1)).unwrap_error()
+            == archimedes::archive_error::BAD_ARCHIVE);
+
+    return 0;
+}
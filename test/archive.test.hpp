@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace archive_ns {
+struct Keyframe {
+    float time = 0.0f, value = 0.0f;
+};
+
+// same size and field types as Keyframe, different layout
+struct Reordered {
+    float value = 0.0f, time = 0.0f;
+};
+
+struct Asset {
+    uint32_t id = 0;
+    Keyframe keys[2];
+    uint8_t kind : 3 = 0, flags : 5 = 0;
+};
+
+struct NotTrivial {
+    std::string name;
+};
+
+struct HasPointer {
+    int *p = nullptr;
+};
+} // namespace archive_ns
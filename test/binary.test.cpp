@@ -0,0 +1,134 @@
+#include "test.hpp"
+#include "binary.test.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+using namespace binary_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    archimedes::binary_serializer bs;
+
+    // trivially copyable fields are coalesced into one run
+    const auto cplan = bs.plan(archimedes::type_id::from<Color>());
+    ASSERT(cplan);
+    ASSERT((*cplan)->is_fixed_size);
+    ASSERT((*cplan)->ops.size() == 1);
+    ASSERT((*cplan)->fixed_size == sizeof(Color));
+
+    uint8_t buf[256];
+    Color c = { 1, 2, 3, 4 }, d;
+    ASSERT(*bs.write(c, buf) == sizeof(Color));
+    ASSERT(*bs.read(d, std::span<const uint8_t>(buf, sizeof(Color)))
+        == sizeof(Color));
+    ASSERT(d.r == 1 && d.g == 2 && d.b == 3 && d.a == 4);
+    ASSERT(
+        bs.write(c, std::span<uint8_t>(buf, 2)).unwrap_error()
+            == archimedes::binary_error::BUFFER_TOO_SMALL);
+    ASSERT(
+        bs.read(d, std::span<const uint8_t>(buf, 2)).unwrap_error()
+            == archimedes::binary_error::TRUNCATED);
+
+    // adjacent fields of nested records and arrays are coalesced, runs are
+    // split at padding
+    const auto vplan = bs.plan(archimedes::type_id::from<Vertex>());
+    ASSERT(vplan);
+    ASSERT((*vplan)->is_fixed_size);
+    ASSERT((*vplan)->ops.size() == 2);
+    ASSERT(
+        (*vplan)->ops[0].size == offsetof(Vertex, material) + sizeof(uint16_t));
+    ASSERT(
+        (*vplan)->fixed_size == (*vplan)->ops[0].size + sizeof(uint64_t));
+
+    // runs: index, vertices[0] up to material, vertices[0].id through
+    // vertices[1].material, vertices[1].id, then path, the byte holding lod
+    // and scale
+    const auto mplan = bs.plan(archimedes::type_id::from<Mesh>());
+    ASSERT(mplan);
+    ASSERT(!(*mplan)->is_fixed_size);
+    ASSERT((*mplan)->ops.size() == 7);
+    ASSERT(
+        (*mplan)->ops[2].offset
+            == offsetof(Mesh, vertices) + offsetof(Vertex, id));
+    ASSERT(
+        (*mplan)->ops[2].size == sizeof(uint64_t) + (*vplan)->ops[0].size);
+    ASSERT((*mplan)->ops[4].codec);
+    ASSERT(
+        (*mplan)->fixed_size
+            == sizeof(uint32_t) + (2 * (*vplan)->fixed_size)
+                + sizeof(uint8_t) + sizeof(float));
+
+    Mesh m;
+    m.index = 42;
+    m.vertices[0].position[2] = 3.0f;
+    m.vertices[0].color = { 5, 6, 7, 8 };
+    m.vertices[1].normal[1] = -1.0f;
+    m.vertices[1].material = 300;
+    m.vertices[1].id = 0x0123456789ABCDEF;
+    m.path = "assets/meshes/terrain/chunk_0123/lod0.mesh";
+    m.lod = 9;
+    m.scale = 0.25f;
+
+    const auto size = bs.size_of(m);
+    ASSERT(size);
+    ASSERT(*size == (*mplan)->fixed_size + sizeof(uint64_t) + m.path.size());
+
+    const auto n = bs.write(m, buf);
+    ASSERT(n);
+    ASSERT(*n == *size);
+
+    Mesh o;
+    ASSERT(*bs.read(o, std::span<const uint8_t>(buf, *n)) == *n);
+    ASSERT(o.index == 42);
+    ASSERT(o.vertices[0].position[2] == 3.0f);
+    ASSERT(o.vertices[0].color.b == 7);
+    ASSERT(o.vertices[1].normal[1] == -1.0f);
+    ASSERT(o.vertices[1].material == 300);
+    ASSERT(o.vertices[1].id == 0x0123456789ABCDEF);
+    ASSERT(o.path == m.path);
+    ASSERT(o.lod == 9);
+    ASSERT(o.scale == 0.25f);
+
+    ASSERT(
+        bs.write(m, std::span<uint8_t>(buf, *n - 1)).unwrap_error()
+            == archimedes::binary_error::BUFFER_TOO_SMALL);
+    ASSERT(
+        bs.read(o, std::span<const uint8_t>(buf, *n - 1)).unwrap_error()
+            == archimedes::binary_error::TRUNCATED);
+
+    // pointers cannot be serialized
+    ASSERT(
+        bs.plan(archimedes::type_id::from<Pointer>()).unwrap_error()
+            == archimedes::binary_error::UNSUPPORTED_TYPE);
+
+    // custom codec
+    bs.set_codec<std::vector<int>>(
+        archimedes::binary_codec {
+            .write =
+                [](archimedes::binary_writer &w, const void *p) {
+                    const auto &v = *static_cast<const std::vector<int>*>(p);
+                    w.write(static_cast<uint32_t>(v.size()));
+                    w.write(v.data(), v.size() * sizeof(int));
+                },
+            .read =
+                [](archimedes::binary_reader &r, void *p) {
+                    auto &v = *static_cast<std::vector<int>*>(p);
+                    uint32_t n = 0;
+                    r.read(n);
+                    v.resize(r.ok ? n : 0);
+                    r.read(v.data(), v.size() * sizeof(int));
+                }
+        });
+
+    Histogram h = { 3, { 1, 2, 3, 4 } }, i;
+    const auto hn = bs.write(h, buf);
+    ASSERT(hn);
+    ASSERT(*hn == sizeof(int) + sizeof(uint32_t) + (4 * sizeof(int)));
+    ASSERT(*bs.read(i, std::span<const uint8_t>(buf, *hn)) == *hn);
+    ASSERT(i.bins == 3);
+    ASSERT(i.counts == h.counts);
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace binary_ns {
+// adjacent fields, one run
+struct Color {
+    uint8_t r = 0, g = 0, b = 0, a = 0;
+};
+
+// position through material are one run, the padding after material
+// splits it from id
+struct Vertex {
+    float position[3] = { 0.0f, 0.0f, 0.0f };
+    float normal[3] = { 0.0f, 0.0f, 0.0f };
+    Color color;
+    uint16_t material = 0;
+    uint64_t id = 0;
+};
+
+// id of one vertex and the start of the next touch and are merged. the string
+// and the padding around the bit field split runs
+struct Mesh {
+    uint32_t index = 0;
+    Vertex vertices[2];
+    std::string path;
+    uint16_t lod : 4 = 0;
+    float scale = 1.0f;
+};
+
+struct Pointer {
+    int *p = nullptr;
+};
+
+// std::vector needs a codec
+struct Histogram {
+    int bins = 0;
+    std::vector<int> counts;
+};
+} // namespace binary_ns
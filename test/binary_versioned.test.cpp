@@ -0,0 +1,174 @@
+#include "test.hpp"
+#include "binary_versioned.test.hpp"
+
+#include <cstring>
+
+using namespace binary_versioned_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    archimedes::binary_serializer bs;
+    uint8_t buf[1024];
+
+    // identical layouts
+    {
+        const auto id = archimedes::type_id::from<Timestamp>();
+        ASSERT((*bs.schema(id))->is_plain);
+
+        const auto n = bs.write_schema(id, buf);
+        ASSERT(n);
+
+        const Timestamp v = { 1700000000, 500, -60 };
+        const auto m =
+            bs.write_versioned(id, &v, std::span(buf + *n, sizeof(buf) - *n));
+        ASSERT(m);
+        ASSERT(*m == sizeof(Timestamp));
+
+        const auto mapping =
+            bs.read_schema(id, std::span<const uint8_t>(buf, *n + *m));
+        ASSERT(mapping);
+        ASSERT((*mapping)->is_identical);
+        ASSERT((*mapping)->schema_size == *n);
+
+        Timestamp w;
+        ASSERT(
+            *bs.read_versioned(
+                **mapping, &w, std::span<const uint8_t>(buf + *n, *m))
+                == *m);
+        ASSERT(w.seconds == 1700000000 && w.nanos == 500 && w.zone == -60);
+
+        // cached by fingerprint
+        ASSERT(*bs.read_schema(id, std::span<const uint8_t>(buf, *n))
+            == *mapping);
+
+        // corrupted/truncated schemas
+        ASSERT(
+            bs.read_schema(id, std::span<const uint8_t>(buf, 8)).unwrap_error()
+                == archimedes::binary_error::TRUNCATED);
+        ASSERT(
+            bs.read_schema(
+                archimedes::type_id::from<v1::Profile>(),
+                std::span<const uint8_t>(buf, *n)).unwrap_error()
+                == archimedes::binary_error::SCHEMA_MISMATCH);
+        buf[*n - 1] ^= 0xFF;
+        ASSERT(
+            bs.read_schema(id, std::span<const uint8_t>(buf, *n)).unwrap_error()
+                == archimedes::binary_error::BAD_SCHEMA);
+    }
+
+    // fields added, removed, reordered and resized
+    {
+        const auto
+            old_id = archimedes::type_id::from<v1::Profile>(),
+            new_id = archimedes::type_id::from<v2::Profile>();
+        ASSERT(!(*bs.schema(old_id))->is_plain);
+
+        const auto n = bs.write_schema(old_id, buf);
+        ASSERT(n);
+
+        // rewrite header as if v1::Profile were an older build of v2::Profile:
+        // u32 magic, u64 type id, u64 fingerprint, u32 field count, fields
+        const uint64_t id = new_id.value();
+        const uint64_t fingerprint =
+            archimedes::binary_schema::hash(
+                new_id, std::span<const uint8_t>(buf + 24, *n - 24));
+        std::memcpy(buf + 4, &id, sizeof(id));
+        std::memcpy(buf + 12, &fingerprint, sizeof(fingerprint));
+
+        v1::Profile e;
+        e.id = 7;
+        e.rating = 3.5f;
+        e.email = "first.last@mail.example.com";
+        e.rank = -3;
+        e.tier = 5;
+        e.legacy = 1.0;
+
+        size_t size = *n;
+        for (int i = 0; i < 2; i++) {
+            e.id += i;
+            const auto m =
+                bs.write_versioned(
+                    old_id, &e, std::span(buf + size, sizeof(buf) - size));
+            ASSERT(m);
+            size += *m;
+        }
+
+        const auto mapping =
+            bs.read_schema(new_id, std::span<const uint8_t>(buf, size));
+        ASSERT(mapping);
+        ASSERT(!(*mapping)->is_identical);
+        ASSERT((*mapping)->has_missing);
+
+        size_t pos = (*mapping)->schema_size;
+        for (int i = 0; i < 2; i++) {
+            v2::Profile f;
+            f.balance = 0.0;
+
+            const auto m =
+                bs.read_versioned(
+                    **mapping,
+                    &f,
+                    std::span<const uint8_t>(buf + pos, size - pos));
+            ASSERT(m);
+            pos += *m;
+
+            ASSERT(f.balance == 9.5);
+            ASSERT(f.email == e.email);
+            ASSERT(f.id == 7 + i);
+            ASSERT(f.rank == -3);
+            ASSERT(f.rating == 3.5f);
+        }
+        ASSERT(pos == size);
+    }
+
+    // fields of a nested record reordered
+    {
+        const auto
+            old_id = archimedes::type_id::from<v1::Unit>(),
+            new_id = archimedes::type_id::from<v2::Unit>();
+        ASSERT(
+            (*bs.schema(old_id))->fields[0].layout
+                != (*bs.schema(new_id))->fields[0].layout);
+
+        const auto n = bs.write_schema(old_id, buf);
+        ASSERT(n);
+
+        // as above, with v1::Stats as an older build of v2::Stats. "stats" is
+        // the first field: u16 name length, name, u64 type id
+        const uint64_t
+            id = new_id.value(),
+            stats_id = archimedes::type_id::from<v2::Stats>().value();
+        std::memcpy(buf + 4, &id, sizeof(id));
+        std::memcpy(buf + 24 + 2 + 5, &stats_id, sizeof(stats_id));
+        const uint64_t fingerprint =
+            archimedes::binary_schema::hash(
+                new_id, std::span<const uint8_t>(buf + 24, *n - 24));
+        std::memcpy(buf + 12, &fingerprint, sizeof(fingerprint));
+
+        v1::Unit u;
+        u.stats = { 1, 2 };
+        u.id = 3;
+
+        const auto m =
+            bs.write_versioned(
+                old_id, &u, std::span(buf + *n, sizeof(buf) - *n));
+        ASSERT(m);
+
+        const auto mapping =
+            bs.read_schema(new_id, std::span<const uint8_t>(buf, *n + *m));
+        ASSERT(mapping);
+        ASSERT((*mapping)->has_missing);
+
+        // stats would be read with hp and mp swapped, keeps its defaults
+        v2::Unit w;
+        ASSERT(
+            *bs.read_versioned(
+                **mapping, &w, std::span<const uint8_t>(buf + *n, *m))
+                == *m);
+        ASSERT(w.stats.hp == 0 && w.stats.mp == 0);
+        ASSERT(w.id == 3);
+    }
+
+    return 0;
+}
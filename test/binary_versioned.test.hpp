@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace binary_versioned_ns {
+// two builds of the same record
+namespace v1 {
+struct Profile {
+    int id = 0;
+    float rating = 0.0f;
+    std::string email;
+    int8_t rank : 4 = 0;
+    uint8_t tier : 3 = 0;
+    double legacy = 0.0;
+};
+
+struct Stats {
+    int hp = 0, mp = 0;
+};
+
+struct Unit {
+    Stats stats;
+    int id = 0;
+};
+} // namespace v1
+
+namespace v2 {
+struct Profile {
+    double balance = 9.5;
+    std::string email;
+    int id = 0;
+    int8_t rank : 6 = 0;
+    float rating = 0.0f;
+};
+
+// fields of nested record reordered
+struct Stats {
+    int mp = 0, hp = 0;
+};
+
+struct Unit {
+    Stats stats;
+    int id = 0;
+};
+} // namespace v2
+
+struct Timestamp {
+    int64_t seconds = 0;
+    int32_t nanos = 0, zone = 0;
+};
+} // namespace binary_versioned_ns
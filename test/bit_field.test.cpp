@@ -0,0 +1,113 @@
+#include "test.hpp"
+#include "bit_field.test.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace bit_field_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    const auto type = archimedes::reflect<Wide>()->as_record();
+    const auto
+        x = *type.field("x"),
+        y = *type.field("y"),
+        small = *type.field("small"),
+        mode = *type.field("mode"),
+        rest = *type.field("rest");
+
+    // wider than 32 bits, signed, enums
+    Wide w;
+    w.tag = 0xAB;
+    w.x = (uint64_t(1) << 62) | 5;
+    w.y = -(int64_t(1) << 59);
+    w.small = -16;
+    w.mode = Mode::OFF;
+    w.rest = 511;
+
+    ASSERT(*x.value<uint64_t>(w) == w.x);
+    ASSERT(*y.value<int64_t>(w) == w.y);
+    ASSERT(*small.value<int32_t>(w) == -16);
+    ASSERT(*mode.value<Mode>(w) == Mode::OFF);
+    ASSERT(*rest.value<uint16_t>(w) == 511);
+
+    // set touches only the field
+    Wide v;
+    v.tag = 0xCD;
+    x.set(v, uint64_t(w.x));
+    y.set(v, int64_t(w.y));
+    small.set(v, int32_t(15));
+    mode.set(v, Mode::OFF);
+    rest.set(v, uint16_t(1023));
+    ASSERT(v.x == w.x);
+    ASSERT(v.y == w.y);
+    ASSERT(v.small == 15);
+    ASSERT(v.mode == Mode::OFF);
+    ASSERT(v.rest == 511);
+    ASSERT(v.tag == 0xCD);
+
+    // signedness comes from the plugin, also if the field's type is not
+    // reflected
+    ASSERT(mode.is_signed_bit_field() && !rest.is_signed_bit_field());
+    ASSERT(!archimedes::reflect<std::float_round_style>());
+    const auto round =
+        *archimedes::reflect<Rounding>()->as_record().field("round");
+    ASSERT(round.is_signed_bit_field());
+
+    Rounding r;
+    round.set(r, std::round_indeterminate);
+    ASSERT(r.round == std::round_indeterminate);
+    ASSERT(r.tag == 0);
+    ASSERT(
+        *round.value<std::float_round_style>(r) == std::round_indeterminate);
+
+    // accessors
+    const auto a = *small.bit_accessor();
+    ASSERT(a.is_valid());
+    ASSERT(a.bit_size == 5);
+    ASSERT(a.word_offset + a.word_size <= sizeof(Wide));
+    ASSERT(!type.field("tag")->bit_accessor());
+
+    // bulk
+    std::vector<Wide> ws(9);
+    for (size_t i = 0; i < ws.size(); i++) {
+        ws[i].small = static_cast<int>(i) - 4;
+    }
+
+    std::vector<int32_t> smalls(ws.size());
+    a.load_n(ws.data(), sizeof(Wide), ws.size(), smalls.data());
+    for (size_t i = 0; i < ws.size(); i++) {
+        ASSERT(smalls[i] == static_cast<int>(i) - 4);
+        smalls[i] = -smalls[i];
+    }
+
+    a.store_n(ws.data(), sizeof(Wide), ws.size(), smalls.data());
+    for (size_t i = 0; i < ws.size(); i++) {
+        ASSERT(ws[i].small == 4 - static_cast<int>(i));
+        ASSERT(ws[i].mode == Mode::ON);
+    }
+
+    // fields which fit no word go bytewise
+    constexpr auto straddles =
+        archimedes::bit_field_accessor::make(5, 62, false, 16);
+    static_assert(straddles.is_bytewise);
+    uint8_t bytes[16] = { 0 };
+    straddles.store(bytes, ~uint64_t(0));
+    ASSERT(bytes[0] == 0xE0);
+    ASSERT(bytes[8] == 0x07);
+    ASSERT(straddles.load(bytes) == (uint64_t(1) << 62) - 1);
+
+    // loads may read a wider word, stores write only the bytes of the field
+    constexpr auto narrow =
+        archimedes::bit_field_accessor::make(4, 16, false, 8);
+    static_assert(narrow.word_size == 4);
+    static_assert(narrow.store_size == 3);
+    std::memset(bytes, 0x5A, sizeof(bytes));
+    narrow.store(bytes, 0x1234);
+    ASSERT(bytes[0] == 0x4A && bytes[1] == 0x23 && bytes[2] == 0x51);
+    ASSERT(bytes[3] == 0x5A);
+    ASSERT(narrow.load(bytes) == 0x1234);
+
+    return 0;
+}
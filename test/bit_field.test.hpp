@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace bit_field_ns {
+enum class Mode : int8_t { OFF = -2, ON = 1 };
+
+struct Wide {
+    uint8_t tag = 0;
+    uint64_t x : 63 = 0;
+    int64_t y : 61 = 0;
+    int32_t small : 5 = 0;
+    Mode mode : 3 = Mode::ON;
+    uint16_t rest : 9 = 0;
+};
+
+// std is not reflected, round_indeterminate is -1
+struct Rounding {
+    uint8_t tag = 0;
+    std::float_round_style round : 3 = std::round_toward_zero;
+};
+} // namespace bit_field_ns
@@ -0,0 +1,96 @@
+#include "test.hpp"
+#include "compare.test.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+
+using namespace compare_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    archimedes::object_comparer oc;
+
+    // unions are one run over all of their bytes
+    const auto vplan = oc.plan(archimedes::type_id::from<Value>());
+    ASSERT(vplan);
+    ASSERT((*vplan)->ops.size() == 1);
+    ASSERT((*vplan)->ops[0].size == sizeof(Value));
+    ASSERT((*vplan)->fields.size() == 1);
+
+    // fields in order of offset, runs are split at padding only
+    const auto splan = oc.plan(archimedes::type_id::from<Sample>());
+    ASSERT(splan);
+    ASSERT((*splan)->is_fully_hashed);
+    ASSERT((*splan)->fields.size() == 6);
+    ASSERT((*splan)->fields[0].name == "kind");
+    ASSERT((*splan)->fields[5].name == "time");
+    ASSERT((*splan)->ops.size() == 4);
+    ASSERT((*splan)->ops[1].offset == offsetof(Sample, value));
+    ASSERT(
+        (*splan)->ops[1].size
+            == offsetof(Sample, flags) + sizeof(uint16_t)
+                - offsetof(Sample, value));
+
+    // padding is never compared or hashed
+    alignas(Sample) uint8_t abuf[sizeof(Sample)], bbuf[sizeof(Sample)];
+    std::memset(abuf, 0xAA, sizeof(abuf));
+    std::memset(bbuf, 0x55, sizeof(bbuf));
+    auto &a = *new (abuf) Sample, &b = *new (bbuf) Sample;
+    a.kind = b.kind = 's';
+    a.value.u = b.value.u = 0x12345678;
+    a.flags = b.flags = 0xF00D;
+    a.valid = b.valid = true;
+    a.time = b.time = 1.5;
+
+    ASSERT(*oc.equals(a, b));
+    ASSERT(*oc.hash(a) == *oc.hash(b));
+
+    uint64_t mask[1];
+    ASSERT(*oc.diff(a, b, mask) == 0);
+    ASSERT(mask[0] == 0);
+
+    // floats are compared bitwise
+    a.weights[0] = b.weights[0] = std::numeric_limits<float>::quiet_NaN();
+    ASSERT(*oc.equals(a, b));
+    ASSERT(*oc.hash(a) == *oc.hash(b));
+
+    a.weights[1] = 0.0f;
+    b.weights[1] = -0.0f;
+    ASSERT(!*oc.equals(a, b));
+    ASSERT(*oc.diff(a, b, mask) == 1);
+    ASSERT(mask[0] == (1 << 3));
+    b.weights[1] = 0.0f;
+
+    // union members are compared as the bytes of the union
+    b.value.f = 2.0f;
+    b.flags = 1;
+    b.time = -1.5;
+    ASSERT(!*oc.equals(a, b));
+    ASSERT(*oc.hash(a) != *oc.hash(b));
+    ASSERT(*oc.diff(a, b, mask) == 3);
+    ASSERT(mask[0] == ((1 << 1) | (1 << 2) | (1 << 5)));
+    ASSERT(
+        oc.diff(a, b, std::span<uint64_t>()).unwrap_error()
+            == archimedes::compare_error::BUFFER_TOO_SMALL);
+
+    // members which cannot be compared fall back to operator==
+    HasTagged c, d;
+    c.tagged.values = { 1, 2, 3 };
+    d.tagged.values = { 1, 2, 3 };
+    const auto hplan = oc.plan(archimedes::type_id::from<HasTagged>());
+    ASSERT(hplan);
+    ASSERT(!(*hplan)->is_fully_hashed);
+    ASSERT(*oc.equals(c, d));
+    ASSERT(*oc.hash(c) == *oc.hash(d));
+    d.tagged.values[2] = 4;
+    ASSERT(!*oc.equals(c, d));
+    ASSERT(*oc.diff(c, d, mask) == 1);
+    ASSERT(mask[0] == (1 << 1));
+
+    ASSERT(!oc.plan(archimedes::type_id::from<HasRef>()));
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace compare_ns {
+// compared as its bytes, whichever member is active
+union Value {
+    float f = 0.0f;
+    uint32_t u;
+};
+
+// padding after kind, flags and valid
+struct Sample {
+    char kind = 0;
+    Value value;
+    uint16_t flags = 0;
+    float weights[2] = { 0.0f, 0.0f };
+    bool valid = false;
+    double time = 0.0;
+};
+
+// std::vector is not reflected, compared through operator==
+struct Tagged {
+    int tag = 0;
+    std::vector<int> values;
+
+    bool operator==(const Tagged &rhs) const {
+        return this->tag == rhs.tag && this->values == rhs.values;
+    }
+};
+
+struct HasTagged {
+    int x = 0;
+    Tagged tagged;
+};
+
+struct HasRef {
+    int &r;
+};
+} // namespace compare_ns
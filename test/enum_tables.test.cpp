@@ -0,0 +1,75 @@
+#include "test.hpp"
+#include "enum_tables.test.hpp"
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    const auto dense = archimedes::reflect<Dense>();
+    ASSERT(dense);
+    ASSERT(dense->as_enum().is_dense());
+    ASSERT(!dense->as_enum().is_flags());
+    ASSERT(dense->as_enum().name_of(Dense::C) == "C");
+    ASSERT(!dense->as_enum().name_of(17));
+    ASSERT(dense->as_enum().value_of<Dense>("E") == Dense::E);
+    ASSERT(!dense->as_enum().value_of<Dense>("F"));
+
+    const auto s = archimedes::reflect<Signed>();
+    ASSERT(s);
+    ASSERT(s->as_enum().is_dense());
+    ASSERT(s->as_enum().name_of(NEG) == "NEG");
+    ASSERT(s->as_enum().name_of(-1) == "MINUS_ONE");
+    ASSERT(s->as_enum().value_of<int>("NEG") == -2);
+    ASSERT(s->as_enum().value_of<long long>("MINUS_ONE") == -1);
+
+    const auto sparse = archimedes::reflect<Sparse>();
+    ASSERT(sparse);
+    ASSERT(!sparse->as_enum().is_dense());
+    ASSERT(sparse->as_enum().name_of(Sparse::LARGE) == "LARGE");
+    ASSERT(sparse->as_enum().name_of(Sparse::HUGE) == "HUGE");
+    ASSERT(!sparse->as_enum().name_of(4));
+    ASSERT(sparse->as_enum().value_of<Sparse>("HUGE") == Sparse::HUGE);
+
+    const auto flags = archimedes::reflect<Flags>();
+    ASSERT(flags);
+    ASSERT(flags->as_enum().is_flags());
+
+    size_t n = 0;
+    const auto rest =
+        flags->as_enum().for_each_flag(
+            static_cast<Flags>(0x15),
+            [&](std::string_view name) {
+                ASSERT(name == "READ" || name == "EXEC");
+                n++;
+            });
+    ASSERT(n == 2);
+    ASSERT(rest == 0x10);
+
+    char buf[32];
+    ASSERT(
+        flags->as_enum().format_flags(
+            static_cast<Flags>(0x15), std::span { buf }) == "READ|EXEC|0x10");
+    ASSERT(flags->as_enum().format_flags(Flags::NONE, std::span { buf }) == "NONE");
+    ASSERT(
+        flags->as_enum().format_flags(Flags::ALL, std::span { buf }, ", ")
+            == "READ, WRITE, EXEC");
+
+    char small[4];
+    ASSERT(!flags->as_enum().format_flags(Flags::ALL, std::span { small }));
+
+    // first declared name wins
+    const auto aliased = archimedes::reflect<Aliased>();
+    ASSERT(aliased);
+    ASSERT(aliased->as_enum().name_of(ALSO_FIRST) == "FIRST");
+    ASSERT(aliased->as_enum().value_of<int>("ALSO_FIRST") == 1);
+
+    // names which cannot be perfectly hashed (duplicates) terminate and fall
+    // back to a linear search
+    using tables = archimedes::detail::enum_tables;
+    const tables::entry dup[] = { { "X", 1 }, { "X", 2 }, { "Y", 3 } };
+    const auto t = tables::build(dup, ~std::uintmax_t(0), false);
+    ASSERT(t.hash_slots.empty());
+    ASSERT(t.by_name("X") && t.by_name("X")->value == 1);
+    ASSERT(t.by_name("Y") && t.by_name("Y")->value == 3);
+    ASSERT(!t.by_name("Z"));
+    return 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+enum class Dense { A, B, C, D, E };
+
+enum Signed { NEG = -2, MINUS_ONE = -1, ZERO, ONE };
+
+enum class Sparse : uint64_t {
+    SMALL = 3,
+    LARGE = 1000000,
+    HUGE = 0xFFFFFFFFFFFFull
+};
+
+enum class Flags : uint8_t {
+    NONE = 0,
+    READ = 1 << 0,
+    WRITE = 1 << 1,
+    EXEC = 1 << 2,
+    ALL = READ | WRITE | EXEC
+};
+
+enum Aliased { FIRST = 1, ALSO_FIRST = 1, SECOND = 2 };
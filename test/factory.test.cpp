@@ -0,0 +1,74 @@
+#include "test.hpp"
+#include "factory.test.hpp"
+
+#include <memory_resource>
+
+using namespace factory_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    std::pmr::monotonic_buffer_resource resource;
+
+    {
+        archimedes::object_factory factory(&resource, 8);
+
+        auto e = factory.create<Entity>();
+        ASSERT(e);
+        ASSERT(num_alive == 1);
+        ASSERT((*e)->name == "entity");
+        ASSERT(reinterpret_cast<uintptr_t>(*e) % alignof(Entity) == 0);
+
+        auto by_name = factory.create("factory_ns::Entity");
+        ASSERT(by_name);
+        ASSERT(num_alive == 2);
+
+        // bulk create across slabs
+        void *es[20];
+        const auto id = archimedes::type_id::from<Entity>();
+        auto pool = factory.create_n(id, es);
+        ASSERT(pool);
+        ASSERT(num_alive == 22);
+        ASSERT((*pool)->size() == 22);
+        ASSERT((*pool)->stride() >= sizeof(Entity));
+
+        for (auto *p : es) {
+            ASSERT((*pool)->owns(p));
+            ASSERT(static_cast<Entity*>(p)->position[3] == 4.0f);
+        }
+
+        factory.destroy_n(id, std::span<void *const>(es, 10));
+        ASSERT(num_alive == 12);
+        ASSERT(!(*pool)->owns(es[0]));
+
+        // freed slots are reused
+        const auto capacity = (*pool)->capacity();
+        for (size_t i = 0; i < 10; i++) {
+            es[i] = (*pool)->create();
+        }
+        ASSERT((*pool)->capacity() == capacity);
+        ASSERT(num_alive == 22);
+
+        factory.destroy(id, *by_name);
+        ASSERT(num_alive == 21);
+
+        factory.clear();
+        ASSERT(num_alive == 0);
+        ASSERT((*pool)->size() == 0);
+
+        ASSERT(
+            factory.create<NoDefault>().unwrap_error()
+                == archimedes::factory_error::NO_DEFAULT_CTOR);
+        ASSERT(
+            factory.create("factory_ns::DoesNotExist").unwrap_error()
+                == archimedes::factory_error::COULD_NOT_REFLECT);
+
+        factory.create<Entity>();
+        ASSERT(num_alive == 1);
+    }
+
+    // pools destroy live objects
+    ASSERT(num_alive == 0);
+
+    return 0;
+}
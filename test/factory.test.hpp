@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+namespace factory_ns {
+inline int num_alive = 0;
+
+struct Entity {
+    Entity() { num_alive++; }
+    ~Entity() { num_alive--; }
+
+    std::string name = "entity";
+    alignas(32) float position[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+};
+
+struct NoDefault {
+    explicit NoDefault(int x) : x(x) {}
+    int x;
+};
+} // namespace factory_ns
@@ -0,0 +1,73 @@
+#include "test.hpp"
+#include "field_path.test.hpp"
+
+using namespace field_path_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    Skeleton s;
+    s.id = 3;
+    s.bones[2].transform.position.y = 4.0f;
+    s.bones[1].parent = -5;
+    s.weights[1][2] = 0.5f;
+
+    // nested fields and array indices fold into one offset
+    const auto y =
+        archimedes::compile_path<Skeleton>("bones[2].transform.position.y");
+    ASSERT(y);
+    ASSERT(y->steps.empty());
+    ASSERT(y->leaf == archimedes::type_id::from<float>());
+    ASSERT(&y->get<float>(&s) == &s.bones[2].transform.position.y);
+    y->get<float>(&s) = 8.0f;
+    ASSERT(s.bones[2].transform.position.y == 8.0f);
+
+    const auto w = archimedes::compile_path<Skeleton>("weights[1][2]");
+    ASSERT(w);
+    ASSERT(w->get<float>(&s) == 0.5f);
+
+    // fields of bases, implicitly or through an explicit hop
+    const auto id = archimedes::compile_path<Skeleton>("id");
+    ASSERT(id);
+    ASSERT(id->get<int>(&s) == 3);
+    ASSERT(archimedes::compile_path<Skeleton>("Node.id")->offset == id->offset);
+
+    // bit fields
+    const auto parent = archimedes::compile_path<Skeleton>("bones[1].parent");
+    ASSERT(parent);
+    ASSERT(parent->is_bit_field());
+    ASSERT(static_cast<int64_t>(parent->get_bits(&s)) == -5);
+    parent->set_bits(&s, 17);
+    ASSERT(s.bones[1].parent == 17);
+    ASSERT(s.bones[1].flags == 0);
+
+    // virtual bases are a dynamic cast
+    VSkeleton v;
+    v.id = 9;
+    const auto vid = archimedes::compile_path<VSkeleton>("id");
+    ASSERT(vid);
+    ASSERT(vid->steps.size() == 1);
+    ASSERT(vid->get<int>(&v) == 9);
+
+    // errors
+    ASSERT(
+        archimedes::compile_path<Skeleton>("bones[4]").unwrap_error()
+            == archimedes::path_error::OUT_OF_RANGE);
+    ASSERT(
+        archimedes::compile_path<Skeleton>("bones[1].nope").unwrap_error()
+            == archimedes::path_error::NO_SUCH_FIELD);
+    ASSERT(
+        archimedes::compile_path<Skeleton>("id[0]").unwrap_error()
+            == archimedes::path_error::NOT_AN_ARRAY);
+    ASSERT(
+        archimedes::compile_path<Skeleton>("id.x").unwrap_error()
+            == archimedes::path_error::NOT_A_RECORD);
+    ASSERT(
+        archimedes::compile_path<Skeleton>("bones[x]").unwrap_error()
+            == archimedes::path_error::SYNTAX);
+    ASSERT(
+        archimedes::compile_path<Skeleton>("bones..x").unwrap_error()
+            == archimedes::path_error::SYNTAX);
+
+    return 0;
+}
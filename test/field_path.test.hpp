@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace field_path_ns {
+struct Vec3 {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+struct Transform {
+    Vec3 position;
+    Vec3 scale = { 1.0f, 1.0f, 1.0f };
+};
+
+struct Bone {
+    Transform transform;
+    int8_t parent : 6 = 0;
+    uint8_t flags : 2 = 0;
+};
+
+struct Node {
+    int id = 0;
+};
+
+struct Skeleton : public Node {
+    Bone bones[4];
+    float weights[2][3] = { { 0.0f } };
+};
+
+struct VNode : virtual public Node {
+    float w = 0.0f;
+};
+
+struct VSkeleton : public VNode {
+    int n = 0;
+};
+} // namespace field_path_ns
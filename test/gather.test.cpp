@@ -0,0 +1,145 @@
+#include "test.hpp"
+#include "gather.test.hpp"
+
+#include <vector>
+
+using namespace gather_ns;
+
+static void test_gather() {
+    // enough objects for full vector batches and a scalar tail
+    std::vector<Particle> ps(37);
+    for (size_t i = 0; i < ps.size(); i++) {
+        ps[i].id = i * 3;
+        ps[i].mass = i * 0.5;
+        ps[i].charge = -static_cast<short>(i);
+        ps[i].spin = static_cast<int>(i % 7) - 3;
+        ps[i].generation = i * 1000;
+        ps[i].flags = i * 7;
+    }
+
+    const auto type = archimedes::reflect<Particle>()->as_record();
+    const auto
+        id = *type.field("id"),
+        mass = *type.field("mass"),
+        charge = *type.field("charge"),
+        spin = *type.field("spin"),
+        generation = *type.field("generation");
+
+    std::vector<int> ids(ps.size());
+    const auto n =
+        archimedes::gather(
+            id, std::span<const Particle>(ps), std::span<int>(ids));
+    ASSERT(n);
+    ASSERT(*n == ps.size());
+
+    std::vector<double> masses(ps.size());
+    std::vector<short> charges(ps.size());
+    ASSERT(
+        archimedes::gather(
+            mass, std::span<const Particle>(ps), std::span<double>(masses)));
+    ASSERT(
+        archimedes::gather(
+            charge, std::span<const Particle>(ps), std::span<short>(charges)));
+
+    for (size_t i = 0; i < ps.size(); i++) {
+        ASSERT(ids[i] == ps[i].id);
+        ASSERT(masses[i] == ps[i].mass);
+        ASSERT(charges[i] == ps[i].charge);
+    }
+
+    // bit fields are widened to their declared type, sign extended if signed
+    std::vector<int8_t> spins(ps.size());
+    std::vector<uint32_t> generations(ps.size());
+    ASSERT(
+        archimedes::gather(
+            spin, std::span<const Particle>(ps), std::span<int8_t>(spins)));
+    ASSERT(
+        archimedes::gather(
+            generation,
+            std::span<const Particle>(ps),
+            std::span<uint32_t>(generations)));
+
+    for (size_t i = 0; i < ps.size(); i++) {
+        ASSERT(spins[i] == ps[i].spin);
+        ASSERT(generations[i] == ps[i].generation);
+    }
+
+    // scatter writes only the field
+    for (auto &x : ids) { x = -x; }
+    for (auto &x : spins) { x = -x; }
+    for (auto &x : generations) { x += 1; }
+
+    ASSERT(
+        archimedes::scatter(
+            id, std::span<Particle>(ps), std::span<const int>(ids)));
+    ASSERT(
+        archimedes::scatter(
+            spin, std::span<Particle>(ps), std::span<const int8_t>(spins)));
+    ASSERT(
+        archimedes::scatter(
+            generation,
+            std::span<Particle>(ps),
+            std::span<const uint32_t>(generations)));
+
+    for (size_t i = 0; i < ps.size(); i++) {
+        const auto k = static_cast<int>(i);
+        ASSERT(ps[i].id == -(k * 3));
+        ASSERT(ps[i].spin == -((k % 7) - 3));
+        ASSERT(ps[i].generation == (i * 1000) + 1);
+        ASSERT(ps[i].flags == i * 7);
+        ASSERT(ps[i].charge == -static_cast<short>(i));
+    }
+
+    // errors
+    std::vector<long long> wide(ps.size());
+    ASSERT(
+        archimedes::gather(
+            id, ps.data(), sizeof(Particle), std::span<long long>(wide))
+                .unwrap_error()
+            == archimedes::gather_error::SIZE_MISMATCH);
+
+    std::vector<int> small(3);
+    ASSERT(
+        archimedes::gather(
+            id, std::span<const Particle>(ps), std::span<int>(small))
+                .unwrap_error()
+            == archimedes::gather_error::BUFFER_TOO_SMALL);
+}
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    // with each kernel this machine supports
+    for (const auto level : {
+            archimedes::simd_level::SCALAR,
+            archimedes::simd_level::SSE2,
+            archimedes::simd_level::AVX2 }) {
+        if (archimedes::detail::set_gather_simd_level(level) == level) {
+            ASSERT(archimedes::gather_simd_level() == level);
+            test_gather();
+        }
+    }
+
+    // fields of bases only at offset 0
+    std::vector<Body> bodies(4);
+    std::vector<float> xs(bodies.size());
+    ASSERT(
+        archimedes::gather(
+            *archimedes::reflect<Position>()->as_record().field("x"),
+            std::span<const Body>(bodies),
+            std::span<float>(xs)));
+    ASSERT(
+        archimedes::gather(
+            *archimedes::reflect<Velocity>()->as_record().field("dx"),
+            std::span<const Body>(bodies),
+            std::span<float>(xs)).unwrap_error()
+            == archimedes::gather_error::WRONG_TYPE);
+    ASSERT(
+        archimedes::scatter(
+            *archimedes::reflect<Velocity>()->as_record().field("dx"),
+            std::span<Body>(bodies),
+            std::span<const float>(xs)).unwrap_error()
+            == archimedes::gather_error::WRONG_TYPE);
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace gather_ns {
+struct Particle {
+    char tag = 0;
+    int id = 0;
+    double mass = 0.0;
+    short charge = 0;
+    int8_t spin : 3 = 0;
+    uint32_t generation : 20 = 0;
+    uint32_t flags : 12 = 0;
+};
+
+struct Position {
+    float x = 0.0f;
+};
+
+struct Velocity {
+    float dx = 0.0f;
+};
+
+// Velocity is at a nonzero offset
+struct Body : public Position, public Velocity {
+    int id = 0;
+};
+} // namespace gather_ns
@@ -0,0 +1,58 @@
+#include "test.hpp"
+#include "gc_sections.test.hpp"
+
+#include <fstream>
+#include <iterator>
+
+ARCHIMEDES_ARG("gc-sections")
+
+ARCHIMEDES_REFLECT_TYPE(KeptByName)
+
+// true if the module_type_entry of T made it into the linked executable at
+// path. entries are named after their type_id and, on ELF, each gets a section
+// named after the entry, so the name only survives in the section and symbol
+// tables if the linker kept it.
+template <typename T>
+static bool has_entry(const char *path) {
+    std::ifstream f(path, std::ios::binary);
+    const std::string bytes(
+        (std::istreambuf_iterator<char>(f)),
+        std::istreambuf_iterator<char>());
+    ASSERT(!bytes.empty());
+
+#if defined(__ELF__)
+    // debug info may still name discarded symbols, section names are not
+    constexpr auto FMT = ".archimedes.type_{:016x}";
+#else
+    constexpr auto FMT = "type_{:016x}";
+#endif
+    return bytes.find(
+        fmt::format(FMT, archimedes::type_id::from<T>().value()))
+            != std::string::npos;
+}
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    ASSERT(archimedes::reflect<Kept>());
+    ASSERT(archimedes::reflect<KeptByName>());
+
+    // transitively referenced through Kept::d
+    ASSERT(archimedes::reflect<Dependency>());
+
+    // not reachable from any root
+    ASSERT(!archimedes::reflect<NotKept>());
+
+    // linked with --gc-sections/-dead_strip (see Makefile), so the data of
+    // unreferenced types is gone from the binary itself
+    ASSERT(has_entry<Kept>(argv[0]));
+    ASSERT(has_entry<Dependency>(argv[0]));
+    ASSERT(!has_entry<NotKept>(argv[0]));
+
+    Kept k;
+    k.d.x = 12;
+    const auto get = archimedes::reflect<Kept>()->function("get");
+    ASSERT(get);
+    ASSERT(get->invoke(&k)->as<int>() == 12);
+    return 0;
+}
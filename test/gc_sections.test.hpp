@@ -0,0 +1,21 @@
+#pragma once
+
+#include <archimedes.hpp>
+
+struct Dependency {
+    int x;
+};
+
+struct [[ARCHIMEDES_REFLECT]] Kept {
+    Dependency d;
+
+    int get() const { return d.x; }
+};
+
+struct KeptByName {
+    int y;
+};
+
+struct NotKept {
+    float f;
+};
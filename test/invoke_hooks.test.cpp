@@ -0,0 +1,63 @@
+#include "test.hpp"
+#include "invoke_hooks.test.hpp"
+
+// only built with "make test INVOKE_HOOKS=1", see Makefile
+#ifndef ARCHIMEDES_INVOKE_HOOKS
+#error "invoke_hooks test requires ARCHIMEDES_INVOKE_HOOKS"
+#endif
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    const auto square = archimedes::reflect_function("hook_square");
+    ASSERT(square);
+    ASSERT(square->invoke(3)->as<int>() == 9);
+
+    // sample every other call
+    size_t sampled = 0;
+    archimedes::set_invoke_hook(
+        [&](const auto &f, const auto &result, auto time) {
+            ASSERT(f.name() == "hook_square");
+            ASSERT(result);
+            ASSERT(time.count() >= 0);
+            sampled++;
+        },
+        2);
+
+    archimedes::reset_invoke_stats();
+    for (int i = 0; i < 10; i++) {
+        ASSERT(square->invoke(i)->as<int>() == i * i);
+    }
+
+    const auto *stats = square->stats();
+    ASSERT(stats);
+    ASSERT(stats->calls == 10);
+    ASSERT(sampled == 5);
+
+    uint64_t total = 0;
+    for (const auto &b : stats->histogram) {
+        total += b;
+    }
+    ASSERT(total == 10);
+    ASSERT(stats->percentile(0.5) <= stats->percentile(1.0));
+
+    archimedes::set_invoke_hook(nullptr);
+
+    // member functions, copies of function info share stats
+    const auto foo = archimedes::reflect<HookFoo>();
+    ASSERT(foo);
+    const auto add = foo->as_record().function("add");
+    ASSERT(add);
+    HookFoo h;
+    ASSERT(add->invoke(&h, 4)->as<int>() == 4);
+    ASSERT(foo->as_record().function("add")->stats()->calls == 1);
+
+    const auto never = archimedes::reflect_function("hook_never_called");
+    ASSERT(never);
+    ASSERT(never->stats());
+    ASSERT(never->stats()->calls == 0);
+
+    archimedes::reset_invoke_stats();
+    ASSERT(square->stats()->calls == 0);
+    return 0;
+}
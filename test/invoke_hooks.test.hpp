@@ -0,0 +1,15 @@
+#pragma once
+
+struct HookFoo {
+    int x = 0;
+
+    int add(int y) { this->x += y; return this->x; }
+};
+
+inline int hook_square(int x) {
+    return x * x;
+}
+
+inline int hook_never_called(int x) {
+    return x;
+}
@@ -0,0 +1,101 @@
+#include "test.hpp"
+#include "json.test.hpp"
+
+#include <cstring>
+
+using namespace json_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    archimedes::json_serializer js;
+
+    Document e;
+    std::strcpy(e.tag, "t\"g\\");
+    std::memcpy(e.code, "ABCD", 4);
+    e.selection = { 1.5f, -2.25f };
+    e.scores[1] = -7;
+    e.text = "tab\there\nback\\slash \x01\x1f";
+    e.color = Color::BLUE;
+    e.flags = Flags(uint8_t(Flags::READ) | uint8_t(Flags::EXEC));
+    e.level = -3;
+
+    // fields in order of offset, full char arrays are written up to their
+    // size. control characters without a short escape are written as unicode
+    // escapes
+    std::string s;
+    ASSERT(!js.write(e, s));
+    ASSERT(
+        s == "{\"tag\":\"t\\\"g\\\\\",\"code\":\"ABCD\","
+            "\"selection\":{\"start\":1.5,\"length\":-2.25},"
+            "\"scores\":[0,-7,0],"
+            "\"text\":\"tab\\there\\nback\\\\slash \\u0001\\u001f\","
+            "\"color\":\"BLUE\",\"flags\":\"READ|EXEC\",\"level\":-3}");
+
+    // round trip
+    Document f;
+    const auto n = js.read(f, s);
+    ASSERT(n);
+    ASSERT(*n == s.size());
+    ASSERT(std::string(f.tag) == "t\"g\\");
+    ASSERT(std::memcmp(f.code, "ABCD", 4) == 0);
+    ASSERT(f.selection.length == -2.25f);
+    ASSERT(f.scores[1] == -7);
+    ASSERT(f.text == e.text);
+    ASSERT(f.color == Color::BLUE);
+    ASSERT(f.flags == e.flags);
+    ASSERT(f.level == -3);
+
+    // keys in any order, unknown keys skipped, missing fields and nulls kept.
+    // unicode escapes (and surrogate pairs) are decoded to utf-8, also into
+    // char arrays, which are zero filled after the string
+    Document g;
+    std::memcpy(g.code, "WXYZ", 4);
+    g.scores[0] = 5;
+    std::memset(g.tag, 'x', sizeof(g.tag));
+    ASSERT(
+        js.read(
+            g,
+            R"( { "extra": { "a": [1, 2, { "b": null }] },
+                  "flags": "WRITE", "color": 1, "code": null,
+                  "tag": "a\"\u00e9",
+                  "text": "é😀\u00e9\ud83d\ude00",
+                  "selection": { "length": 3 } } )"));
+    ASSERT(std::memcmp(g.code, "WXYZ", 4) == 0);
+    ASSERT(g.scores[0] == 5);
+    ASSERT(std::memcmp(g.tag, "a\"\xc3\xa9\0\0\0\0", sizeof(g.tag)) == 0);
+    ASSERT(g.flags == Flags::WRITE);
+    ASSERT(g.color == Color::GREEN);
+    ASSERT(g.text == "\xc3\xa9\xf0\x9f\x98\x80\xc3\xa9\xf0\x9f\x98\x80");
+    ASSERT(g.selection.start == 0.0f && g.selection.length == 3.0f);
+
+    // strings which exactly fill a char array are not terminated
+    ASSERT(js.read(g, R"({"tag": "12345678"})"));
+    ASSERT(std::memcmp(g.tag, "12345678", sizeof(g.tag)) == 0);
+
+    // errors
+    ASSERT(
+        js.read(g, R"({"tag": "123456789"})").unwrap_error()
+            == archimedes::json_error::OUT_OF_RANGE);
+    ASSERT(
+        js.read(g, R"({"level": 8})").unwrap_error()
+            == archimedes::json_error::OUT_OF_RANGE);
+    ASSERT(
+        js.read(g, R"({"scores": [1, 2, 3, 4]})").unwrap_error()
+            == archimedes::json_error::OUT_OF_RANGE);
+    ASSERT(
+        js.read(g, R"({"color": "PURPLE"})").unwrap_error()
+            == archimedes::json_error::UNKNOWN_ENUM_VALUE);
+    ASSERT(
+        js.read(g, R"({"code": 1})").unwrap_error()
+            == archimedes::json_error::TYPE_MISMATCH);
+    ASSERT(
+        js.read(g, R"({"level": 1)").unwrap_error()
+            == archimedes::json_error::SYNTAX);
+
+    Pointer p;
+    ASSERT(!js.plan(archimedes::type_id::from<Pointer>()));
+    ASSERT(js.write(p, s));
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace json_ns {
+enum class Color {
+    RED,
+    GREEN,
+    BLUE
+};
+
+enum class Flags : uint8_t {
+    NONE = 0,
+    READ = 1 << 0,
+    WRITE = 1 << 1,
+    EXEC = 1 << 2
+};
+
+struct Span {
+    float start = 0.0f, length = 0.0f;
+};
+
+// char arrays are strings which need not be terminated when full, other
+// arrays are json arrays
+struct Document {
+    char tag[8] = "";
+    char code[4] = "";
+    Span selection;
+    int scores[3] = { 0, 0, 0 };
+    std::string text;
+    Color color = Color::RED;
+    Flags flags = Flags::NONE;
+    int8_t level : 4 = 0;
+};
+
+struct Pointer {
+    int *p = nullptr;
+};
+} // namespace json_ns
@@ -0,0 +1,30 @@
+#include "test.hpp"
+#include "load_stats.test.hpp"
+
+int main(int argc, char *argv[]) {
+    archimedes::enable_load_stats();
+    archimedes::load();
+
+    const auto stats = archimedes::load_stats();
+    ASSERT(!stats.modules.empty());
+    ASSERT(stats.total_time.count() > 0);
+
+    // find module for this file
+    const auto it =
+        std::find_if(
+            stats.modules.begin(),
+            stats.modules.end(),
+            [](const auto &m) {
+                return m.name.ends_with("load_stats.test.cpp");
+            });
+    ASSERT(it != stats.modules.end());
+    ASSERT(it->types > 0);
+    ASSERT(it->functions > 0);
+    ASSERT(it->bytes_read > 0);
+
+    ASSERT(stats.memory.strings > 0);
+    ASSERT(stats.memory.maps > 0);
+    ASSERT(stats.memory.vectors > 0);
+    ASSERT(stats.memory.total() >= stats.memory.strings + stats.memory.maps);
+    return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+struct StatsFoo {
+    int x;
+    std::string name;
+
+    int get_x() const { return this->x; }
+};
+
+enum class StatsEnum { A, B, C };
+
+inline int stats_free_function(int x) {
+    return x;
+}
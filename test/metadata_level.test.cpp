@@ -0,0 +1,43 @@
+#include "test.hpp"
+#include "metadata_level.test.hpp"
+
+ARCHIMEDES_ARG("level-minimal")
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    const auto foo = archimedes::reflect<Foo>();
+    ASSERT(foo);
+
+    // optional metadata was not emitted
+    ASSERT(!foo->has_metadata(archimedes::METADATA_ANNOTATIONS));
+    ASSERT(!foo->has_metadata(archimedes::METADATA_DEFINITION_PATHS));
+    ASSERT(foo->annotations().empty());
+    ASSERT(foo->definition_path().empty());
+    ASSERT(foo->mangled_name().empty());
+    ASSERT(foo->as_record().field("x")->annotations().empty());
+
+    // but everything required at runtime was
+    ASSERT(foo->as_record().field("x"));
+
+    // typedefs are required for lookup by name
+    ASSERT(foo->has_metadata(archimedes::METADATA_TYPEDEFS));
+    ASSERT(!foo->as_record().type_aliases().empty());
+    ASSERT(archimedes::reflect("FooAlias"));
+    ASSERT(archimedes::reflect("FooAlias")->id() == foo->id());
+    const auto add = foo->as_record().function("add");
+    ASSERT(add);
+    ASSERT(!add->has_metadata(archimedes::METADATA_PARAMETER_NAMES));
+    ASSERT(add->parameters().size() == 2);
+    ASSERT(add->parameters()[0].name().empty());
+
+    Foo f;
+    f.x = 1;
+    ASSERT(add->invoke(&f, 2, 3)->as<int>() == 6);
+
+    // implicit functions required by the runtime are kept
+    ASSERT(foo->as_record().default_constructor());
+    ASSERT(foo->as_record().copy_constructor());
+    ASSERT(foo->as_record().destructor());
+    return 0;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+struct __attribute__((annotate("abc"))) Foo {
+    using Int = int;
+
+    int __attribute__((annotate("xyz"))) x;
+
+    int add(int a, int b) const { return x + a + b; }
+};
+
+using FooAlias = Foo;
@@ -0,0 +1,133 @@
+#include "test.hpp"
+#include "replicate.test.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace replicate_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    archimedes::replicator rep;
+
+    // fields in order of offset
+    const auto plan = rep.plan(archimedes::type_id::from<Unit>());
+    ASSERT(plan);
+    ASSERT((*plan)->fields.size() == 9);
+    ASSERT((*plan)->fields[0].name == "x");
+    ASSERT((*plan)->fields[7].name == "lives");
+
+    ASSERT(!rep.set_quantization<Unit>("x", 1.0 / 64));
+    ASSERT(!rep.set_quantization<Unit>("y", 1.0 / 64));
+    ASSERT(!rep.set_quantization<Unit>("heading", 0.5));
+    ASSERT(
+        *rep.set_quantization<Unit>("nope", 0.5)
+            == archimedes::replication_error::UNKNOWN_FIELD);
+    ASSERT(
+        *rep.set_quantization<Unit>("frame", 0.5)
+            == archimedes::replication_error::UNSUPPORTED_TYPE);
+    ASSERT(
+        *rep.set_quantization<Unit>("speed", -1.0)
+            == archimedes::replication_error::UNSUPPORTED_TYPE);
+
+    uint8_t buf[4096];
+
+    // counters which wrap around are sent as small deltas: count, change
+    // mask, number of changed fields, then an index and a varint per field
+    {
+        std::vector<Unit> server(1), client(1);
+        server[0].frame = client[0].frame = 250;
+        server[0].ammo = client[0].ammo = 32000;
+        server[0].tick = client[0].tick = 0xFFFFFFF0;
+        server[0].lives = client[0].lives = 3;
+
+        auto baseline = rep.snapshot(std::span<const Unit>(server));
+        ASSERT(baseline);
+
+        server[0].frame = 4;
+        server[0].ammo = -32000;
+        server[0].tick = 0x10;
+        server[0].lives = 0;
+
+        const auto n =
+            rep.encode(std::span<const Unit>(server), *baseline, buf);
+        ASSERT(n);
+        ASSERT(*n == 3 + (4 * 1) + 1 + 2 + 1 + 1);
+        ASSERT(*rep.apply(std::span<Unit>(client), std::span(buf, *n)) == *n);
+        ASSERT(client[0].frame == 4);
+        ASSERT(client[0].ammo == -32000);
+        ASSERT(client[0].tick == 0x10);
+        ASSERT(client[0].lives == 0);
+    }
+
+    std::vector<Unit> server(100), client(100);
+    auto baseline = rep.snapshot(std::span<const Unit>(server));
+    ASSERT(baseline);
+
+    // nothing changed: count and empty change mask
+    auto n = rep.encode(std::span<const Unit>(server), *baseline, buf);
+    ASSERT(n);
+    ASSERT(*n == 1 + ((server.size() + 7) / 8));
+    ASSERT(*rep.apply(std::span<Unit>(client), std::span(buf, *n)) == *n);
+
+    for (size_t i = 0; i < server.size(); i += 10) {
+        auto &u = server[i];
+        u.x = 0.3f * float(i);
+        u.y = -0.7f;
+        u.heading += 12.3;
+        u.speed = 1.1f;
+        u.state = State::MOVING;
+    }
+
+    const auto size =
+        rep.encode(
+            std::span<const Unit>(server), *baseline, std::span<uint8_t>());
+    n = rep.encode(std::span<const Unit>(server), *baseline, buf);
+    ASSERT(n);
+    ASSERT(*n == *size);
+    ASSERT(*rep.apply(std::span<Unit>(client), std::span(buf, *n)) == *n);
+
+    for (size_t i = 0; i < server.size(); i++) {
+        const auto &s = server[i], &c = client[i];
+        ASSERT(std::abs(c.x - s.x) <= 1.0f / 128);
+        ASSERT(std::abs(c.y - s.y) <= 1.0f / 128);
+        ASSERT(std::abs(c.heading - s.heading) <= 0.25);
+        ASSERT(c.speed == s.speed);
+        ASSERT(c.state == s.state);
+
+        // baseline is what the client has
+        ASSERT(baseline->as<Unit>()[i].x == c.x);
+        ASSERT(baseline->as<Unit>()[i].heading == c.heading);
+    }
+
+    // changes smaller than half a step are not sent
+    server[10].x += 1.0f / 512;
+    n = rep.encode(std::span<const Unit>(server), *baseline, buf);
+    ASSERT(n);
+    ASSERT(*n == 1 + ((server.size() + 7) / 8));
+
+    // patches are for a fixed number of objects
+    server[0].speed = 2.0f;
+    n = rep.encode(std::span<const Unit>(server), *baseline, buf);
+    ASSERT(n);
+
+    std::vector<Unit> other(3);
+    ASSERT(
+        rep.apply(std::span<Unit>(other), std::span(buf, *n)).unwrap_error()
+            == archimedes::replication_error::COUNT_MISMATCH);
+    ASSERT(
+        rep.apply(std::span<Unit>(client), std::span(buf, *n - 1))
+            .unwrap_error()
+            == archimedes::replication_error::TRUNCATED);
+
+    server[0].tick++;
+    ASSERT(
+        rep.encode(
+            std::span<const Unit>(server),
+            *baseline,
+            std::span(buf, 4)).unwrap_error()
+            == archimedes::replication_error::BUFFER_TOO_SMALL);
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace replicate_ns {
+enum class State : uint8_t {
+    IDLE,
+    MOVING,
+    DEAD
+};
+
+// position and heading are quantized, speed is sent exactly and the counters
+// (lives is a bit field) wrap around
+struct Unit {
+    float x = 0.0f, y = 0.0f;
+    double heading = 0.0;
+    float speed = 0.0f;
+    uint8_t frame = 0;
+    int16_t ammo = 0;
+    uint32_t tick = 0;
+    uint8_t lives : 2 = 0;
+    State state = State::IDLE;
+};
+} // namespace replicate_ns
@@ -0,0 +1,149 @@
+#include "test.hpp"
+#include "soa.test.hpp"
+#include "soa.test.static.hpp"
+
+using namespace soa_ns;
+
+using bodies = archimedes::soa_vector<Body>;
+static_assert(bodies::NUM_COLUMNS == 4);
+static_assert(bodies::column_index<&Body::mass>() == 2);
+static_assert(std::is_same_v<bodies::column_type<3>, bool>);
+static_assert(archimedes::detail::is_soa_record<Body>());
+static_assert(!archimedes::detail::is_soa_record<Flagged>());
+static_assert(!archimedes::detail::is_soa_record<Packed>());
+static_assert(!archimedes::detail::is_soa_record<Hidden>());
+static_assert(!archimedes::detail::is_soa_record<Sampled>());
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    bodies bs;
+    ASSERT(bs.empty());
+
+    for (int i = 0; i < 10; i++) {
+        bs.push_back(
+            Body {
+                .pos = { float(i), float(-i) },
+                .mass = i * 2.0,
+                .active = i % 2 == 0
+            });
+    }
+    ASSERT(bs.size() == 10);
+
+    // columns are contiguous
+    const auto masses = bs.column<&Body::mass>();
+    ASSERT(masses.size() == 10);
+    for (size_t i = 0; i < masses.size(); i++) {
+        ASSERT(masses[i] == i * 2.0);
+    }
+
+    const auto active = bs.column<&Body::active>();
+    ASSERT(active[0] && !active[1]);
+
+    // rows are proxies
+    auto r = bs[3];
+    ASSERT(r.get<&Body::pos>().x == 3.0f);
+    ASSERT(r.get<&Body::vel>().y == 2.0f);
+    r.get<&Body::mass>() = 100.0;
+    ASSERT(masses[3] == 100.0);
+
+    const Body b = bs[3];
+    ASSERT(b.pos.y == -3.0f);
+    ASSERT(b.mass == 100.0);
+    ASSERT(!b.active);
+
+    bs[0] = bs[3];
+    ASSERT(bs.column<&Body::mass>()[0] == 100.0);
+    ASSERT(!bs.column<&Body::active>()[0]);
+
+    bs.swap_erase(0);
+    ASSERT(bs.size() == 9);
+    ASSERT(bs[0].get<&Body::mass>() == 18.0);
+
+    bs.erase(0);
+    ASSERT(bs.size() == 8);
+    ASSERT(bs[0].get<&Body::mass>() == 2.0);
+
+    bs.resize(12);
+    ASSERT(bs.back().load().mass == 1.0);
+    ASSERT(bs.back().get<&Body::active>());
+
+    auto e = bs.emplace_back();
+    e.get<&Body::vel>() = Vec2 { 5.0f, 6.0f };
+    ASSERT(bs.size() == 13);
+    ASSERT(bs.column<1>()[12].x == 5.0f);
+
+    // copies own their columns, bool columns included
+    auto copy = bs;
+    copy[12].get<&Body::active>() = false;
+    ASSERT(bs.column<&Body::active>()[12]);
+    ASSERT(copy.column<&Body::active>().size() == 13);
+
+    bs.clear();
+    ASSERT(bs.empty());
+
+    // runtime columns include fields of bases and bit fields
+    auto res = archimedes::any_soa_vector::make<Flagged>();
+    ASSERT(res);
+    auto fs = std::move(*res);
+    ASSERT(fs.columns().size() == 4);
+    ASSERT(fs.columns()[0].field.name() == "tag");
+
+    const auto
+        tag = *fs.column_index("tag"),
+        id = *fs.column_index("id"),
+        kind = *fs.column_index("kind"),
+        level = *fs.column_index("level");
+    ASSERT(!fs.column_index("nope"));
+
+    for (int i = 0; i < 20; i++) {
+        Flagged f;
+        f.tag = i;
+        f.id = i * 10;
+        f.kind = i % 8;
+        f.level = -i;
+        fs.push_back(f);
+    }
+    ASSERT(fs.size() == 20);
+
+    const auto ids = fs.column<int>(id);
+    const auto levels = fs.column<int16_t>(level);
+    for (int i = 0; i < 20; i++) {
+        ASSERT(fs.column<uint32_t>(tag)[i] == uint32_t(i));
+        ASSERT(ids[i] == i * 10);
+        ASSERT(fs.column<uint8_t>(kind)[i] == i % 8);
+        ASSERT(levels[i] == -i);
+    }
+
+    fs[5].get<int16_t>(level) = 200;
+    fs[5].get<uint8_t>(kind) = 9;
+
+    Flagged f;
+    fs[5].load(&f);
+    ASSERT(f.tag == 5);
+    ASSERT(f.id == 50);
+    ASSERT(f.level == 200);
+    ASSERT(f.kind == 1);
+
+    f.id = -1;
+    fs.store(6, &f);
+    ASSERT(ids[6] == -1);
+
+    fs.resize(25);
+    ASSERT(fs.column<uint32_t>(tag)[24] == 7);
+    fs.swap_erase(0);
+    ASSERT(fs.column<int>(id)[0] == 0);
+    ASSERT(fs.size() == 24);
+
+    fs.erase(0);
+    ASSERT(fs.size() == 23);
+    ASSERT(fs.column<uint32_t>(tag)[0] == 1);
+    ASSERT(fs.column<int>(id)[4] == 50);
+    ASSERT(fs.column<int16_t>(level)[0] == -1);
+
+    ASSERT(
+        archimedes::any_soa_vector::make<Virtual>().unwrap_error()
+            == archimedes::soa_error::UNSUPPORTED_TYPE);
+
+    return 0;
+}
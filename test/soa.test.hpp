@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace soa_ns {
+struct Vec2 {
+    float x = 0.0f, y = 0.0f;
+};
+
+struct Body {
+    Vec2 pos;
+    Vec2 vel = { 1.0f, 2.0f };
+    double mass = 1.0;
+    bool active = true;
+};
+
+struct Tagged {
+    uint32_t tag = 7;
+};
+
+struct Flagged : Tagged {
+    int id = 0;
+    uint8_t kind : 3 = 0;
+    int16_t level : 9 = 0;
+};
+
+// cannot be soa_vector<T>, members would not be columns
+struct Packed {
+    int a = 0;
+    uint8_t b : 4 = 0;
+};
+
+struct Hidden {
+    int b = 0;
+private:
+    int a = 0;
+};
+
+struct Sampled {
+    int n = 0;
+    float samples[4] = {};
+};
+
+struct VBase { int a = 0; };
+struct Virtual : virtual VBase { int b = 0; };
+} // namespace soa_ns
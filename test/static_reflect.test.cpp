@@ -0,0 +1,70 @@
+#include "test.hpp"
+#include "static_reflect.test.hpp"
+#include "static_reflect.test.static.hpp"
+
+using namespace static_ns;
+
+static_assert(archimedes::static_reflected<Point>);
+static_assert(archimedes::static_reflected_record<Point>);
+static_assert(archimedes::static_reflected_enum<Color>);
+static_assert(!archimedes::static_reflected<int>);
+
+// public fields only, in declaration order
+static_assert(archimedes::static_field_count<Point> == 3);
+static_assert(std::get<0>(archimedes::static_reflect<Point>::fields).name == "x");
+static_assert(std::get<2>(archimedes::static_reflect<Point>::fields).name == "label");
+
+static_assert(archimedes::static_enum_name(Color::GREEN) == "GREEN");
+static_assert(archimedes::static_enum_value<Color>("BLUE") == Color::BLUE);
+static_assert(!archimedes::static_enum_value<Color>("PURPLE"));
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    Point p;
+    p.x = 3;
+    p.y = 4.0f;
+    p.label = "p";
+
+    // static and runtime data agree
+    const auto rt = archimedes::reflect<Point>();
+    ASSERT(rt);
+    ASSERT(archimedes::static_reflect<Point>::id == rt->id());
+
+    size_t n = 0;
+    archimedes::for_each_field<Point>(
+        [&](const auto &f) {
+            const auto field = rt->as_record().field(f.name);
+            ASSERT(field);
+            ASSERT(field->offset() == f.offset);
+            n++;
+        });
+    ASSERT(n == 3);
+
+    std::get<0>(archimedes::static_reflect<Point>::fields).get(p) = 10;
+    ASSERT(p.x == 10);
+
+    size_t bases = 0;
+    archimedes::for_each_base<Point>(
+        [&](const auto &b) {
+            using B = typename std::decay_t<decltype(b)>::type;
+            ASSERT((std::is_same_v<B, Base>));
+            ASSERT(!b.is_virtual);
+            bases++;
+        });
+    ASSERT(bases == 1);
+
+    std::vector<std::string_view> functions;
+    archimedes::for_each_function<Point>(
+        [&](const auto &f) {
+            functions.push_back(f.name);
+        });
+    ASSERT(functions.size() == 2);
+    ASSERT(functions[0] == "sum" && functions[1] == "twice");
+    ASSERT((p.*std::get<0>(archimedes::static_reflect<Point>::functions).ptr)() == 14);
+    ASSERT(std::get<1>(archimedes::static_reflect<Point>::functions).ptr(3) == 6);
+
+    ASSERT(archimedes::static_reflect<Color>::enumerators.size() == 3);
+    ASSERT(archimedes::static_reflect<Color>::enumerators[2].value == Color::BLUE);
+    return 0;
+}
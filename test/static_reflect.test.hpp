@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+namespace static_ns {
+struct Base {
+    int base_value = 1;
+};
+
+struct Point : Base {
+    int x = 0;
+    float y = 0.0f;
+    std::string label;
+
+    int sum() const { return this->x + static_cast<int>(this->y); }
+    static int twice(int v) { return v * 2; }
+
+    // overloaded, not available statically
+    void set(int v) { this->x = v; }
+    void set(float v) { this->y = v; }
+
+private:
+    int hidden = 0;
+};
+
+enum class Color { RED, GREEN = 4, BLUE };
+}
@@ -0,0 +1,95 @@
+#include "test.hpp"
+#include "value_ops.test.hpp"
+
+using namespace value_ops_ns;
+
+int main(int argc, char *argv[]) {
+    archimedes::load();
+
+    const auto counted = *archimedes::reflect<Counted>();
+    const auto *ops = counted.ops();
+    ASSERT(ops);
+    ASSERT(ops->construct);
+    ASSERT(ops->copy);
+    ASSERT(ops->move);
+    ASSERT(ops->destroy);
+    ASSERT(ops->swap);
+    ASSERT(!ops->is_trivial);
+
+    // construct/copy/destroy through raw ops
+    {
+        alignas(Counted) unsigned char a[sizeof(Counted)], b[sizeof(Counted)];
+        ops->construct(a);
+        ASSERT(num_alive == 1);
+        reinterpret_cast<Counted*>(a)->name = "a";
+        ops->copy(b, a);
+        ASSERT(num_alive == 2);
+        ASSERT(reinterpret_cast<Counted*>(b)->name == "a");
+
+        Counted c;
+        c.name = "c";
+        ops->swap(b, &c);
+        ASSERT(c.name == "a");
+        ASSERT(reinterpret_cast<Counted*>(b)->name == "c");
+
+        ops->destroy(a);
+        ops->destroy(b);
+        ASSERT(num_alive == 1);
+    }
+    ASSERT(num_alive == 0);
+
+    // any::make_for_id goes through ops
+    {
+        auto r = archimedes::any::make_for_id(counted.id());
+        ASSERT(r);
+        ASSERT(num_alive == 1);
+        ASSERT(r->as<Counted&>().name == "default");
+
+        auto copy = *r;
+        ASSERT(num_alive == 2);
+    }
+    ASSERT(num_alive == 0);
+
+    const auto pod = *archimedes::reflect<Pod>();
+    ASSERT(pod.ops());
+    ASSERT(pod.ops()->is_trivial);
+    ASSERT(!pod.ops()->destroy);
+    ASSERT(archimedes::any::make_for_type(pod)->as<Pod&>().x == 4);
+
+    const auto no_default = *archimedes::reflect<NoDefault>();
+    ASSERT(!no_default.ops() || !no_default.ops()->construct);
+    ASSERT(
+        archimedes::any::make_for_type(no_default).unwrap_error()
+            == archimedes::any_error::NO_DEFAULT_CTOR);
+
+    // any::make uses generated ops
+    {
+        auto a = archimedes::any::make(Counted {});
+        auto b = a;
+        ASSERT(num_alive == 2);
+        ASSERT(b.as<Counted&>().name == "default");
+    }
+    ASSERT(num_alive == 0);
+
+    // records without ops (fx. those the plugin cannot emit them for) are
+    // still constructed, copied and destroyed through their reflected
+    // functions. simulated by clearing the ops of a reflected type.
+    const_cast<archimedes::detail::type_info&>(
+        *archimedes::type_id::from<Unopped>()).ops = nullptr;
+    const auto unopped = *archimedes::reflect<Unopped>();
+    ASSERT(!unopped.ops());
+    {
+        auto r = archimedes::any::make_for_type(unopped);
+        ASSERT(r);
+        ASSERT(num_unopped_alive == 1);
+        ASSERT(r->as<Unopped&>().x == 5);
+
+        r->as<Unopped&>().x = 6;
+        auto copy = *r;
+        ASSERT(num_unopped_alive == 2);
+        ASSERT(copy.as<Unopped&>().x == 6);
+    }
+    ASSERT(num_unopped_alive == 0);
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+namespace value_ops_ns {
+inline int num_alive = 0;
+
+struct Counted {
+    Counted() { num_alive++; }
+    Counted(const Counted &other) : name(other.name) { num_alive++; }
+    Counted(Counted &&other) : name(std::move(other.name)) { num_alive++; }
+    Counted &operator=(const Counted&) = default;
+    Counted &operator=(Counted&&) = default;
+    ~Counted() { num_alive--; }
+
+    std::string name = "default";
+};
+
+inline int num_unopped_alive = 0;
+
+struct Unopped {
+    Unopped() { num_unopped_alive++; }
+    Unopped(const Unopped &other) : x(other.x) { num_unopped_alive++; }
+    ~Unopped() { num_unopped_alive--; }
+
+    int x = 5;
+};
+
+struct Pod {
+    int x = 4;
+    float y = 2.0f;
+};
+
+struct NoDefault {
+    explicit NoDefault(int x) : x(x) {}
+    int x;
+};
+} // namespace value_ops_ns